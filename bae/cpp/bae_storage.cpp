@@ -4,6 +4,11 @@
 #include <libtorrent/disk_buffer_holder.hpp>
 #include <libtorrent/io_context.hpp>
 #include <libtorrent/settings_pack.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <boost/asio/post.hpp>
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 #include <memory>
 #include <string>
@@ -14,26 +19,126 @@ void BaeBufferAllocator::free_disk_buffer(char* b) {
     delete[] b;
 }
 
+int TorrentState::piece_size(piece_index_t piece) const {
+    if (static_cast<int>(piece) < num_pieces - 1) {
+        return piece_length;
+    }
+    return static_cast<int>(total_size - static_cast<std::int64_t>(piece_length) * (num_pieces - 1));
+}
+
+bool TorrentState::piece_wanted(piece_index_t piece) const {
+    for (file_slice const& slice : files->map_block(piece, 0, piece_size(piece))) {
+        if (files->pad_file_at(slice.file_index)) {
+            continue;
+        }
+        if (slice.file_index >= priorities.end_index() || priorities[slice.file_index] != dont_download) {
+            return true;
+        }
+    }
+    return false;
+}
+
 BaeDiskInterface::BaeDiskInterface(
+    io_context& ioc,
+    int num_job_threads,
     ReadPieceCallback read_cb,
     WritePieceCallback write_cb,
-    HashPieceCallback hash_cb
-) : read_callback_(std::move(read_cb)),
+    ReleaseStorageCallback release_cb
+) : ioc_(ioc),
+    read_callback_(std::move(read_cb)),
     write_callback_(std::move(write_cb)),
-    hash_callback_(std::move(hash_cb)),
+    release_callback_(std::move(release_cb)),
     buffer_allocator_()
 {
+    for (int i = 0; i < std::max(1, num_job_threads); ++i) {
+        job_threads_.emplace_back([this] { run_jobs(); });
+    }
 }
 
-BaeDiskInterface::~BaeDiskInterface() = default;
+BaeDiskInterface::~BaeDiskInterface() {
+    abort(true);
+}
+
+void BaeDiskInterface::post_job(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+}
+
+void BaeDiskInterface::run_jobs() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_cv_.wait(lock, [this] { return aborting_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
 
 storage_holder BaeDiskInterface::new_torrent(storage_params const& params, std::shared_ptr<void> const&) {
-    // Create a storage holder - we don't need actual storage since we handle it in Rust
-    return storage_holder();
+    // Piece data lives in Rust; here we only keep what's needed to filter and hash writes
+    std::lock_guard<std::mutex> lock(state_mutex_);
+
+    // Reuse the lowest free index
+    storage_index_t idx{0};
+    while (torrents_.count(idx) > 0) {
+        ++idx;
+    }
+
+    TorrentState& state = torrents_[idx];
+    state.files = &params.files;
+    state.priorities = params.priorities;
+    state.piece_length = params.files.piece_length();
+    state.num_pieces = params.files.num_pieces();
+    state.total_size = params.files.total_size();
+    state.v1 = params.v1;
+    state.v2 = params.v2;
+
+    return storage_holder(idx, *this);
 }
 
-void BaeDiskInterface::remove_torrent(storage_index_t) {
-    // No-op: cleanup handled in Rust
+void BaeDiskInterface::remove_torrent(storage_index_t storage_idx) {
+    release_storage(storage_idx, true);
+}
+
+void BaeDiskInterface::release_storage(storage_index_t storage_idx, bool removed) {
+    std::vector<std::function<void()>> orphaned;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (removed) {
+            auto torrent = torrents_.find(storage_idx);
+            if (torrent != torrents_.end()) {
+                // Jobs still waiting on writes run now and fail against the released storage
+                for (auto& waiting : torrent->second.after_piece_writes) {
+                    orphaned.insert(orphaned.end(), waiting.second.begin(), waiting.second.end());
+                }
+                orphaned.insert(orphaned.end(), torrent->second.after_all_writes.begin(), torrent->second.after_all_writes.end());
+                torrents_.erase(torrent);
+            }
+        } else {
+            // Keep geometry and priorities for a resume; partial piece hashes are
+            // rebuilt by reading the piece back if it's completed later
+            auto torrent = torrents_.find(storage_idx);
+            if (torrent != torrents_.end()) {
+                torrent->second.pieces.clear();
+            }
+        }
+    }
+
+    // Stops wait for queued writes, so there is nothing buffered to flush first
+    release_callback_(static_cast<int32_t>(storage_idx), removed);
+
+    for (auto& job : orphaned) {
+        post_job(std::move(job));
+    }
 }
 
 void BaeDiskInterface::async_read(
@@ -42,55 +147,182 @@ void BaeDiskInterface::async_read(
     std::function<void(disk_buffer_holder, storage_error const&)> handler,
     disk_job_flags_t
 ) {
-    // Read piece data via Rust callback
-    try {
-        std::vector<uint8_t> data = read_callback_(static_cast<int32_t>(storage_idx), r.piece, r.start, r.length);
-        
-        // Allocate buffer and copy data
-        auto* buf = new char[data.size()];
-        std::copy(data.begin(), data.end(), buf);
-        
-        // Create buffer holder with our allocator (allocator first, then buffer, then size)
-        disk_buffer_holder holder(buffer_allocator_, buf, static_cast<int>(data.size()));
-        
-        handler(std::move(holder), storage_error());
-    } catch (...) {
+    // A read may have to fetch its chunk from the cloud, so it runs as a disk job and
+    // completes on the network thread once the data is there
+    post_job([this, storage_idx, r, handler]() {
+        auto data = std::make_shared<std::vector<uint8_t>>();
         storage_error err;
-        err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
-        // Create empty buffer holder for error case
-        char* empty_buf = new char[0];
-        disk_buffer_holder holder(buffer_allocator_, empty_buf, 0);
-        handler(std::move(holder), err);
-    }
+        try {
+            *data = read_callback_(static_cast<int32_t>(storage_idx), r.piece, r.start, r.length);
+        } catch (...) {
+            data->clear();
+        }
+        if (data->empty()) {
+            err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
+        }
+
+        post(ioc_, [this, data, err, handler]() {
+            // Allocate buffer and copy data; the holder frees it through our allocator
+            auto* buf = new char[data->size()];
+            std::copy(data->begin(), data->end(), buf);
+            handler(disk_buffer_holder(buffer_allocator_, buf, static_cast<int>(data->size())), err);
+        });
+    });
 }
 
 bool BaeDiskInterface::async_write(
     storage_index_t storage_idx,
     peer_request const& r,
     char const* buf,
-    std::shared_ptr<disk_observer> o,
+    std::shared_ptr<disk_observer>,
     std::function<void(storage_error const&)> handler,
-    disk_job_flags_t flags
+    disk_job_flags_t
 ) {
-    // Write piece data via Rust callback
-    try {
-        std::vector<uint8_t> data(buf, buf + r.length);
-        bool success = write_callback_(static_cast<int32_t>(storage_idx), r.piece, r.start, data);
-        
-        if (success) {
-            handler(storage_error());
-        } else {
-            storage_error err;
-            err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
-            handler(err);
+    // Writing calls into Rust, which blocks on the runtime, so it runs as a disk job.
+    // libtorrent reuses buf once we return, so the block is copied first.
+    std::vector<uint8_t> data(buf, buf + r.length);
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end()) {
+            ++torrent->second.pending_writes[r.piece];
         }
-    } catch (...) {
+    }
+
+    post_job([this, storage_idx, r, data = std::move(data), handler]() {
         storage_error err;
-        err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
-        handler(err);
+        try {
+            if (write_block(storage_idx, r, data)) {
+                hash_written_block(storage_idx, r, reinterpret_cast<char const*>(data.data()));
+            } else {
+                err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
+            }
+        } catch (...) {
+            err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
+        }
+        finish_write(storage_idx, r.piece);
+        post(ioc_, [handler, err]() { handler(err); });
+    });
+
+    // Nothing is buffered against a limit, so peers never have to wait for a disk_observer
+    return false;
+}
+
+bool BaeDiskInterface::write_block(storage_index_t storage_idx, peer_request const& r, std::vector<uint8_t> const& data) {
+    // Skip pieces that lie entirely in priority-0 files. Boundary pieces are kept whole so
+    // they still verify when read back for rechecks or seeding.
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end() && !torrent->second.piece_wanted(r.piece)) {
+            return true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return write_callback_(static_cast<int32_t>(storage_idx), r.piece, r.start, data);
+}
+
+void BaeDiskInterface::finish_write(storage_index_t storage_idx, piece_index_t piece) {
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent == torrents_.end()) {
+            return;
+        }
+        TorrentState& state = torrent->second;
+        auto pending = state.pending_writes.find(piece);
+        if (pending == state.pending_writes.end() || --pending->second > 0) {
+            return;
+        }
+        state.pending_writes.erase(pending);
+
+        auto waiting = state.after_piece_writes.find(piece);
+        if (waiting != state.after_piece_writes.end()) {
+            ready = std::move(waiting->second);
+            state.after_piece_writes.erase(waiting);
+        }
+        if (state.pending_writes.empty()) {
+            ready.insert(ready.end(), state.after_all_writes.begin(), state.after_all_writes.end());
+            state.after_all_writes.clear();
+        }
+    }
+
+    for (auto& job : ready) {
+        post_job(std::move(job));
     }
-    
-    return true; // Indicates async operation started
+}
+
+void BaeDiskInterface::post_after_piece_writes(storage_index_t storage_idx, piece_index_t piece, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end() && torrent->second.pending_writes.count(piece) > 0) {
+            torrent->second.after_piece_writes[piece].push_back(std::move(job));
+            return;
+        }
+    }
+    post_job(std::move(job));
+}
+
+void BaeDiskInterface::post_after_all_writes(storage_index_t storage_idx, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end() && !torrent->second.pending_writes.empty()) {
+            torrent->second.after_all_writes.push_back(std::move(job));
+            return;
+        }
+    }
+    post_job(std::move(job));
+}
+
+void BaeDiskInterface::hash_written_block(storage_index_t storage_idx, peer_request const& r, char const* buf) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto torrent = torrents_.find(storage_idx);
+    if (torrent == torrents_.end()) {
+        return;
+    }
+    PieceHashState& piece = torrent->second.pieces[r.piece];
+
+    if (torrent->second.v2) {
+        piece.block_hashes[r.start] = hasher256(buf, r.length).final();
+    }
+    if (!torrent->second.v1 || piece.broken) {
+        return;
+    }
+
+    if (r.start < piece.v1_bytes || piece.pending.count(r.start) > 0) {
+        // A block was written twice, so the running hash may not match what's stored
+        piece.broken = true;
+        piece.pending.clear();
+        return;
+    }
+    if (r.start > piece.v1_bytes) {
+        // Out of order: hold the block until the gap before it is filled
+        piece.pending.emplace(r.start, std::vector<char>(buf, buf + r.length));
+        return;
+    }
+
+    piece.v1.update(buf, r.length);
+    piece.v1_bytes += r.length;
+
+    // Drain held blocks that are now contiguous with the hashed prefix
+    auto next = piece.pending.begin();
+    while (next != piece.pending.end() && next->first == piece.v1_bytes) {
+        piece.v1.update(next->second.data(), static_cast<int>(next->second.size()));
+        piece.v1_bytes += static_cast<int>(next->second.size());
+        next = piece.pending.erase(next);
+    }
+}
+
+std::vector<char> BaeDiskInterface::read_back(storage_index_t storage_idx, piece_index_t piece, int offset, int size) {
+    std::vector<uint8_t> data = read_callback_(static_cast<int32_t>(storage_idx), static_cast<int32_t>(piece), offset, size);
+    if (data.empty()) {
+        throw std::runtime_error("read callback returned no data");
+    }
+    return std::vector<char>(data.begin(), data.end());
 }
 
 void BaeDiskInterface::async_hash(
@@ -100,31 +332,71 @@ void BaeDiskInterface::async_hash(
     disk_job_flags_t flags,
     std::function<void(piece_index_t, sha1_hash const&, storage_error const&)> handler
 ) {
-    // Hash verification via Rust callback
+    // Hashing may have to read the piece back, so it runs as a disk job once the
+    // piece's queued writes have landed
+    post_after_piece_writes(storage_idx, piece, [this, storage_idx, piece, v2, flags, handler]() {
+        sha1_hash hash;
+        storage_error err;
+        hash_piece(storage_idx, piece, v2, flags, hash, err);
+        post(ioc_, [handler, piece, hash, err]() { handler(piece, hash, err); });
+    });
+}
+
+void BaeDiskInterface::hash_piece(
+    storage_index_t storage_idx,
+    piece_index_t piece,
+    span<sha256_hash> v2,
+    disk_job_flags_t flags,
+    sha1_hash& hash,
+    storage_error& err
+) {
+    // Take the piece's running hashes. Whatever the verdict, libtorrent either keeps the
+    // piece or clears it and downloads it again, so the state isn't needed afterwards.
+    PieceHashState state;
+    int piece_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end()) {
+            piece_size = torrent->second.piece_size(piece);
+            auto it = torrent->second.pieces.find(piece);
+            if (it != torrent->second.pieces.end()) {
+                state = std::move(it->second);
+                torrent->second.pieces.erase(it);
+            }
+        }
+    }
+
+    bool const want_v1 = bool(flags & disk_interface::v1_hash);
+    bool const v1_ready = !state.broken && piece_size > 0 && state.v1_bytes == piece_size;
+    bool v2_ready = true;
+    for (int i = 0; i < static_cast<int>(v2.size()); ++i) {
+        v2_ready = v2_ready && state.block_hashes.count(i * default_block_size) > 0;
+    }
+
     try {
-        // Read piece data
-        std::vector<uint8_t> data = read_callback_(static_cast<int32_t>(storage_idx), piece, 0, 0); // 0 size means read entire piece
+        // Only read the piece back if it wasn't fully hashed on the way in (e.g. a recheck)
+        std::vector<char> data;
+        if ((want_v1 && !v1_ready) || !v2_ready) {
+            data = read_back(storage_idx, piece, 0, 0); // 0 size means read entire piece
+        }
 
-        // Calculate SHA-1 hash (libtorrent uses SHA-1 for piece verification)
-        sha1_hash hash;
-        // TODO: Calculate actual SHA-1 hash using libtorrent's hasher
-
-        // For now, create empty hash and call callback
-        // The Rust callback will verify the hash
-        bool valid = hash_callback_(static_cast<int32_t>(storage_idx), piece, std::vector<uint8_t>(hash.begin(), hash.end()));
-        
-        if (valid) {
-            handler(piece, hash, storage_error());
-        } else {
-            storage_error err;
-            err.ec = boost::system::error_code(boost::system::errc::invalid_argument, boost::system::generic_category());
-            handler(piece, hash, err);
+        if (want_v1) {
+            hash = v1_ready ? state.v1.final() : hasher(data.data(), static_cast<int>(data.size())).final();
+        }
+
+        for (int i = 0; i < static_cast<int>(v2.size()); ++i) {
+            int const offset = i * default_block_size;
+            auto block = state.block_hashes.find(offset);
+            if (block != state.block_hashes.end()) {
+                v2[i] = block->second;
+            } else {
+                int const len = std::min(default_block_size, static_cast<int>(data.size()) - offset);
+                v2[i] = len > 0 ? hasher256(data.data() + offset, len).final() : sha256_hash();
+            }
         }
     } catch (...) {
-        storage_error err;
         err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
-        sha1_hash hash;
-        handler(piece, hash, err);
     }
 }
 
@@ -135,30 +407,45 @@ void BaeDiskInterface::async_hash2(
     disk_job_flags_t flags,
     std::function<void(piece_index_t, sha256_hash const&, storage_error const&)> handler
 ) {
-    // Hash v2 block (SHA-256) via Rust callback
-    try {
-        // Read block data
-        std::vector<uint8_t> data = read_callback_(static_cast<int32_t>(storage_idx), piece, offset, 0); // 0 size means read block
-
-        // Calculate SHA-256 hash
+    post_after_piece_writes(storage_idx, piece, [this, storage_idx, piece, offset, handler]() {
         sha256_hash hash;
-        // TODO: Calculate actual SHA-256 hash using libtorrent's hasher
+        storage_error err;
+        hash_block(storage_idx, piece, offset, hash, err);
+        post(ioc_, [handler, piece, hash, err]() { handler(piece, hash, err); });
+    });
+}
 
-        // For now, create empty hash and call callback
-        bool valid = hash_callback_(static_cast<int32_t>(storage_idx), piece, std::vector<uint8_t>(hash.begin(), hash.end()));
-        
-        if (valid) {
-            handler(piece, hash, storage_error());
-        } else {
-            storage_error err;
-            err.ec = boost::system::error_code(boost::system::errc::invalid_argument, boost::system::generic_category());
-            handler(piece, hash, err);
+void BaeDiskInterface::hash_block(
+    storage_index_t storage_idx,
+    piece_index_t piece,
+    int offset,
+    sha256_hash& hash,
+    storage_error& err
+) {
+    // Hash a single v2 block (SHA-256), from the write path if it was seen there
+    int piece_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end()) {
+            piece_size = torrent->second.piece_size(piece);
+            auto it = torrent->second.pieces.find(piece);
+            if (it != torrent->second.pieces.end()) {
+                auto block = it->second.block_hashes.find(offset);
+                if (block != it->second.block_hashes.end()) {
+                    hash = block->second;
+                    return;
+                }
+            }
         }
+    }
+
+    try {
+        int const len = piece_size > 0 ? std::min(default_block_size, piece_size - offset) : 0; // 0 size means read block
+        std::vector<char> data = read_back(storage_idx, piece, offset, len);
+        hash = hasher256(data.data(), static_cast<int>(data.size())).final();
     } catch (...) {
-        storage_error err;
         err.ec = boost::system::error_code(boost::system::errc::io_error, boost::system::generic_category());
-        sha256_hash hash;
-        handler(piece, hash, err);
     }
 }
 
@@ -176,10 +463,26 @@ void BaeDiskInterface::async_delete_files(storage_index_t, remove_flags_t, std::
 }
 
 void BaeDiskInterface::async_set_file_priority(storage_index_t storage, aux::vector<download_priority_t, file_index_t> prio, std::function<void(storage_error const&, aux::vector<download_priority_t, file_index_t>)> handler) {
+    // Remembered so async_write can drop data for files that weren't selected
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage);
+        if (torrent != torrents_.end()) {
+            torrent->second.priorities = prio;
+        }
+    }
     handler(storage_error(), std::move(prio));
 }
 
-void BaeDiskInterface::async_clear_piece(storage_index_t, piece_index_t index, std::function<void(piece_index_t)> handler) {
+void BaeDiskInterface::async_clear_piece(storage_index_t storage_idx, piece_index_t index, std::function<void(piece_index_t)> handler) {
+    // The piece will be downloaded again, so start its hashes over
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto torrent = torrents_.find(storage_idx);
+        if (torrent != torrents_.end()) {
+            torrent->second.pieces.erase(index);
+        }
+    }
     handler(index);
 }
 
@@ -188,19 +491,42 @@ void BaeDiskInterface::async_check_files(storage_index_t storage, add_torrent_pa
 }
 
 void BaeDiskInterface::async_stop_torrent(storage_index_t storage, std::function<void()> handler) {
-    handler();
+    // Let queued writes land before Rust releases the storage
+    post_after_all_writes(storage, [this, storage, handler]() {
+        release_storage(storage, false);
+        post(ioc_, handler);
+    });
 }
 
 void BaeDiskInterface::async_release_files(storage_index_t storage, std::function<void()> handler) {
-    handler();
+    post_after_all_writes(storage, [this, storage, handler]() {
+        release_storage(storage, false);
+        post(ioc_, handler);
+    });
 }
 
 void BaeDiskInterface::abort(bool wait) {
-    // No-op - we don't have threads to abort
+    // Queued jobs still run, so every handler gets called before the threads exit
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        aborting_ = true;
+    }
+    jobs_cv_.notify_all();
+
+    // Without wait the threads are only signalled; they touch our members until they
+    // exit, so they are never detached and the destructor joins them instead
+    if (!wait) {
+        return;
+    }
+    for (auto& thread : job_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
 }
 
 void BaeDiskInterface::submit_jobs() {
-    // No-op - we handle jobs synchronously
+    // No-op - jobs start as soon as they're posted
 }
 
 void BaeDiskInterface::update_stats_counters(counters& c) const {
@@ -219,11 +545,12 @@ void BaeDiskInterface::settings_updated() {
 std::function<std::unique_ptr<disk_interface>(io_context&, settings_interface const&, counters&)> create_bae_disk_io_constructor(
     ReadPieceCallback read_cb,
     WritePieceCallback write_cb,
-    HashPieceCallback hash_cb
+    ReleaseStorageCallback release_cb
 ) {
     // Create a disk_io_constructor (std::function) that returns our custom disk interface
-    return [read_cb, write_cb, hash_cb](io_context&, settings_interface const&, counters&) -> std::unique_ptr<disk_interface> {
-        return std::make_unique<BaeDiskInterface>(read_cb, write_cb, hash_cb);
+    return [read_cb, write_cb, release_cb](io_context& ioc, settings_interface const& sett, counters&) -> std::unique_ptr<disk_interface> {
+        int const num_job_threads = sett.get_int(settings_pack::aio_threads);
+        return std::make_unique<BaeDiskInterface>(ioc, num_job_threads, read_cb, write_cb, release_cb);
     };
 }
 
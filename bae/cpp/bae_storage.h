@@ -7,8 +7,16 @@
 #include <libtorrent/io_context.hpp>
 #include <libtorrent/settings_pack.hpp>
 #include <libtorrent/aux_/session_settings.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/download_priority.hpp>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace libtorrent {
 
@@ -20,7 +28,8 @@ struct disk_io_constructor;
 // storage_index identifies which torrent's storage to use
 using ReadPieceCallback = std::function<std::vector<uint8_t>(int32_t storage_index, int32_t piece_index, int32_t offset, int32_t size)>;
 using WritePieceCallback = std::function<bool(int32_t storage_index, int32_t piece_index, int32_t offset, const std::vector<uint8_t>& data)>;
-using HashPieceCallback = std::function<bool(int32_t storage_index, int32_t piece_index, const std::vector<uint8_t>& hash)>;
+// Called once the torrent is stopped (removed == false) or removed from the session (removed == true)
+using ReleaseStorageCallback = std::function<void(int32_t storage_index, bool removed)>;
 
 // Simple buffer allocator for disk_buffer_holder
 class BaeBufferAllocator : public buffer_allocator_interface {
@@ -28,13 +37,53 @@ public:
     void free_disk_buffer(char* b) override;
 };
 
+// Running hashes for one piece, fed by async_write as its blocks arrive.
+// Only torrents that download through this interface produce writes; the
+// seeding session adds torrents in seed mode, so its hash checks read back.
+struct PieceHashState {
+    hasher v1;
+    // Length of the contiguous prefix already fed into v1
+    int v1_bytes = 0;
+    // Blocks that arrived ahead of the prefix, keyed by offset within the piece
+    std::map<int, std::vector<char>> pending;
+    // SHA-256 of each v2 block, keyed by offset within the piece
+    std::map<int, sha256_hash> block_hashes;
+    // Set when a block is written twice; hashing then falls back to reading the piece
+    bool broken = false;
+};
+
+// Piece geometry, file priorities and in-progress piece hashes for one torrent
+struct TorrentState {
+    // Owned by the torrent, which outlives its storage
+    file_storage const* files = nullptr;
+    int piece_length = 0;
+    int num_pieces = 0;
+    std::int64_t total_size = 0;
+    bool v1 = false;
+    bool v2 = false;
+    // Files missing from this vector have default priority
+    aux::vector<download_priority_t, file_index_t> priorities;
+    std::map<piece_index_t, PieceHashState> pieces;
+    // Writes queued or running, per piece; pieces with none are absent
+    std::map<piece_index_t, int> pending_writes;
+    // Jobs held until a piece's writes, or all of them, have landed
+    std::map<piece_index_t, std::vector<std::function<void()>>> after_piece_writes;
+    std::vector<std::function<void()>> after_all_writes;
+
+    int piece_size(piece_index_t piece) const;
+    // Whether any byte of the piece belongs to a wanted file
+    bool piece_wanted(piece_index_t piece) const;
+};
+
 // Custom disk interface implementation for BAE storage
 class BaeDiskInterface : public disk_interface {
 public:
     BaeDiskInterface(
+        io_context& ioc,
+        int num_job_threads,
         ReadPieceCallback read_cb,
         WritePieceCallback write_cb,
-        HashPieceCallback hash_cb
+        ReleaseStorageCallback release_cb
     );
     
     ~BaeDiskInterface() override;
@@ -71,10 +120,49 @@ public:
     void settings_updated() override;
 
 private:
+    // Hand a block to Rust, skipping pieces that hold nothing but unselected files
+    bool write_block(storage_index_t storage, peer_request const& r, std::vector<uint8_t> const& data);
+    // Count a queued write down and release any jobs that were waiting on it
+    void finish_write(storage_index_t storage, piece_index_t piece);
+    // Queue a job once the queued writes to a piece (or to the whole torrent) have landed
+    void post_after_piece_writes(storage_index_t storage, piece_index_t piece, std::function<void()> job);
+    void post_after_all_writes(storage_index_t storage, std::function<void()> job);
+    // Feed a freshly written block into its piece's running hashes
+    void hash_written_block(storage_index_t storage, peer_request const& r, char const* buf);
+    // Read piece data back through read_callback_ (only when no running hash is available)
+    std::vector<char> read_back(storage_index_t storage, piece_index_t piece, int offset, int size);
+    // Drop a torrent's in-memory state and let Rust release its side
+    void release_storage(storage_index_t storage, bool removed);
+    // Bodies of async_hash/async_hash2, run on a job thread
+    void hash_piece(storage_index_t storage, piece_index_t piece, span<sha256_hash> v2, disk_job_flags_t flags, sha1_hash& hash, storage_error& err);
+    void hash_block(storage_index_t storage, piece_index_t piece, int offset, sha256_hash& hash, storage_error& err);
+    // Queue a job for the job threads
+    void post_job(std::function<void()> job);
+    // Job thread loop; returns once aborted and the queue is drained
+    void run_jobs();
+
+    io_context& ioc_;
+
     ReadPieceCallback read_callback_;
     WritePieceCallback write_callback_;
-    HashPieceCallback hash_callback_;
+    ReleaseStorageCallback release_callback_;
     BaeBufferAllocator buffer_allocator_;
+
+    // Guards torrents_
+    mutable std::mutex state_mutex_;
+    std::map<storage_index_t, TorrentState> torrents_;
+
+    // Held around write_callback_: writes patch chunks read-modify-write, so two blocks
+    // landing in the same chunk from different job threads would overwrite each other
+    std::mutex write_mutex_;
+
+    // Reads, writes and hashes call into Rust, which may fetch chunks from the cloud, so
+    // they run on these threads and post their handlers back to ioc_
+    std::vector<std::thread> job_threads_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    bool aborting_ = false;
 };
 
 // Factory function to create disk_io_constructor (std::function)
@@ -83,7 +171,7 @@ private:
 std::function<std::unique_ptr<disk_interface>(io_context&, settings_interface const&, counters&)> create_bae_disk_io_constructor(
     ReadPieceCallback read_cb,
     WritePieceCallback write_cb,
-    HashPieceCallback hash_cb
+    ReleaseStorageCallback release_cb
 );
 
 } // namespace libtorrent
@@ -19,7 +19,7 @@
 std::unique_ptr<BaeStorageConstructor> create_bae_storage_constructor(
     rust::Fn<rust::Vec<uint8_t>(int32_t, int32_t, int32_t, int32_t)> read_cb,
     rust::Fn<bool(int32_t, int32_t, int32_t, rust::Slice<const uint8_t>)> write_cb,
-    rust::Fn<bool(int32_t, int32_t, rust::Slice<const uint8_t>)> hash_cb
+    rust::Fn<void(int32_t, bool)> release_cb
 ) {
     // Convert rust::Fn to std::function
     auto read_fn = [read_cb](int32_t storage_index, int32_t piece_index, int32_t offset, int32_t size) -> std::vector<uint8_t> {
@@ -32,12 +32,11 @@ std::unique_ptr<BaeStorageConstructor> create_bae_storage_constructor(
         return write_cb(storage_index, piece_index, offset, slice);
     };
     
-    auto hash_fn = [hash_cb](int32_t storage_index, int32_t piece_index, const std::vector<uint8_t>& hash) -> bool {
-        rust::Slice<const uint8_t> slice(hash.data(), hash.size());
-        return hash_cb(storage_index, piece_index, slice);
+    auto release_fn = [release_cb](int32_t storage_index, bool removed) {
+        release_cb(storage_index, removed);
     };
     
-    auto ctor = libtorrent::create_bae_disk_io_constructor(std::move(read_fn), std::move(write_fn), std::move(hash_fn));
+    auto ctor = libtorrent::create_bae_disk_io_constructor(std::move(read_fn), std::move(write_fn), std::move(release_fn));
     return std::make_unique<BaeStorageConstructor>(std::move(ctor));
 }
 
@@ -72,11 +71,21 @@ void set_paused(AddTorrentParams* params, bool paused) {
     libtorrent::set_paused(params, paused);
 }
 
+// Wrapper for set_auto_managed
+void set_auto_managed(AddTorrentParams* params, bool auto_managed) {
+    libtorrent::set_auto_managed(params, auto_managed);
+}
+
 // Wrapper for set_listen_interfaces - converts rust::Str to std::string
 void set_listen_interfaces(SessionParams* params, rust::Str interfaces) {
     libtorrent::set_listen_interfaces(params, std::string(interfaces));
 }
 
+// Wrapper for set_active_limits
+void set_active_limits(SessionParams* params, int32_t active_seeds, int32_t active_limit) {
+    libtorrent::set_active_limits(params, active_seeds, active_limit);
+}
+
 // Wrapper for torrent_get_name - converts std::string to rust::String
 rust::String torrent_get_name(TorrentHandle* handle) {
     std::string name = libtorrent::torrent_get_name_internal(handle);
@@ -145,17 +154,9 @@ float torrent_get_progress(TorrentHandle* handle) {
     return libtorrent::torrent_get_progress_internal(handle);
 }
 
-int32_t torrent_get_num_peers(TorrentHandle* handle) {
-    return libtorrent::torrent_get_num_peers(handle);
-}
-
-int32_t torrent_get_num_seeds(TorrentHandle* handle) {
-    return libtorrent::torrent_get_num_seeds(handle);
-}
-
-rust::String torrent_get_tracker_status(TorrentHandle* handle) {
-    std::string status = libtorrent::torrent_get_tracker_status(handle);
-    return rust::String(status.data(), status.size());
+rust::String torrent_get_info_hash(TorrentHandle* handle) {
+    std::string info_hash = libtorrent::torrent_get_info_hash_internal(handle);
+    return rust::String(info_hash.data(), info_hash.size());
 }
 
 rust::String session_get_listen_interfaces(Session* sess) {
@@ -239,8 +240,6 @@ rust::Vec<AlertData> session_pop_alerts(Session* sess) {
         rust_alert.info_hash = rust::String(cpp_alert.info_hash.data(), cpp_alert.info_hash.size());
         rust_alert.tracker_url = rust::String(cpp_alert.tracker_url.data(), cpp_alert.tracker_url.size());
         rust_alert.tracker_message = rust::String(cpp_alert.tracker_message.data(), cpp_alert.tracker_message.size());
-        rust_alert.num_peers = cpp_alert.num_peers;
-        rust_alert.num_seeds = cpp_alert.num_seeds;
         rust_alert.file_path = rust::String(cpp_alert.file_path.data(), cpp_alert.file_path.size());
         rust_alert.progress = cpp_alert.progress;
         rust_alert.error_message = rust::String(cpp_alert.error_message.data(), cpp_alert.error_message.size());
@@ -249,3 +248,21 @@ rust::Vec<AlertData> session_pop_alerts(Session* sess) {
     return rust_alerts;
 }
 
+// Wrapper for session_get_torrent_statuses - converts C++ LibTorrentStatus to Rust TorrentStatusData
+rust::Vec<TorrentStatusData> session_get_torrent_statuses(Session* sess) {
+    auto cpp_statuses = libtorrent::session_get_torrent_statuses_internal(sess);
+    rust::Vec<TorrentStatusData> rust_statuses;
+    for (const auto& cpp_status : cpp_statuses) {
+        TorrentStatusData rust_status;
+        rust_status.info_hash = rust::String(cpp_status.info_hash.data(), cpp_status.info_hash.size());
+        rust_status.progress = cpp_status.progress;
+        rust_status.num_peers = cpp_status.num_peers;
+        rust_status.num_seeds = cpp_status.num_seeds;
+        rust_status.download_rate = cpp_status.download_rate;
+        rust_status.upload_rate = cpp_status.upload_rate;
+        rust_status.seed_rank = cpp_status.seed_rank;
+        rust_status.is_queued = cpp_status.is_queued;
+        rust_statuses.push_back(rust_status);
+    }
+    return rust_statuses;
+}
@@ -206,54 +206,6 @@ float torrent_get_progress_internal(torrent_handle* handle) {
     return static_cast<float>(status.progress_ppm) / 1000000.0f;
 }
 
-int32_t torrent_get_num_peers(torrent_handle* handle) {
-    if (!handle) {
-        return 0;
-    }
-    torrent_status status = handle->status();
-    return static_cast<int32_t>(status.num_peers);
-}
-
-int32_t torrent_get_num_seeds(torrent_handle* handle) {
-    if (!handle) {
-        return 0;
-    }
-    torrent_status status = handle->status();
-    return static_cast<int32_t>(status.num_seeds);
-}
-
-std::string torrent_get_tracker_status(torrent_handle* handle) {
-    if (!handle) {
-        return "No handle";
-    }
-    
-    torrent_status status = handle->status();
-    
-    // Get tracker count from torrent_info if available
-    auto torrent_file = status.torrent_file.lock();
-    if (!torrent_file) {
-        return "No metadata (trackers unknown)";
-    }
-    
-    // Get tracker URLs from torrent_info
-    auto trackers = torrent_file->trackers();
-    if (trackers.empty()) {
-        return "No trackers in torrent";
-    }
-    
-    std::string result = std::to_string(trackers.size()) + " tracker(s): ";
-    bool first = true;
-    for (const auto& tracker : trackers) {
-        if (!first) {
-            result += ", ";
-        }
-        result += tracker.url;
-        first = false;
-    }
-    
-    return result;
-}
-
 std::unique_ptr<LibTorrentInfo> get_torrent_info_internal(const std::string& file_path) {
     error_code ec;
     torrent_info ti(file_path, ec);
@@ -304,8 +256,24 @@ void set_seed_mode(add_torrent_params* params, bool seed_mode) {
 }
 
 void set_paused(add_torrent_params* params, bool paused) {
-    if (params && paused) {
+    if (!params) {
+        return;
+    }
+    if (paused) {
         params->flags |= torrent_flags::paused;
+    } else {
+        params->flags &= ~torrent_flags::paused;
+    }
+}
+
+void set_auto_managed(add_torrent_params* params, bool auto_managed) {
+    if (!params) {
+        return;
+    }
+    if (auto_managed) {
+        params->flags |= torrent_flags::auto_managed;
+    } else {
+        params->flags &= ~torrent_flags::auto_managed;
     }
 }
 
@@ -315,6 +283,17 @@ void set_listen_interfaces(session_params* params, const std::string& interfaces
     }
 }
 
+void set_active_limits(session_params* params, int32_t active_seeds, int32_t active_limit) {
+    if (!params) {
+        return;
+    }
+    params->settings.set_int(settings_pack::active_seeds, active_seeds);
+    params->settings.set_int(settings_pack::active_limit, active_limit);
+    // Idle seeds count against the limits too. Otherwise every seed without payload
+    // traffic would stay active, and thousands of them would each keep peers and announce.
+    params->settings.set_bool(settings_pack::dont_count_slow_torrents, false);
+}
+
 std::string session_get_listen_interfaces(session* sess) {
     if (!sess) {
         return "No session";
@@ -380,8 +359,6 @@ std::vector<libtorrent::AlertData> session_pop_alerts(session* sess) {
         
         libtorrent::AlertData alert_data;
         alert_data.type = libtorrent::ALERT_UNKNOWN;
-        alert_data.num_peers = 0;
-        alert_data.num_seeds = 0;
         alert_data.progress = 0.0f;
         
         // Get info_hash from alert if available
@@ -400,16 +377,12 @@ std::vector<libtorrent::AlertData> session_pop_alerts(session* sess) {
             alert_data.tracker_url = tracker_error->tracker_url();
             alert_data.tracker_message = tracker_error->message();
             alert_data.error_message = tracker_error->message();
-        } else if (auto* peer_alert = dynamic_cast<libtorrent::peer_alert*>(alert_ptr)) {
+        } else if (dynamic_cast<libtorrent::peer_alert*>(alert_ptr)) {
             if (dynamic_cast<libtorrent::peer_connect_alert*>(alert_ptr)) {
                 alert_data.type = libtorrent::ALERT_PEER_CONNECT;
             } else if (dynamic_cast<libtorrent::peer_disconnected_alert*>(alert_ptr)) {
                 alert_data.type = libtorrent::ALERT_PEER_DISCONNECT;
             }
-            // Get peer counts from torrent status
-            auto status = peer_alert->handle.status();
-            alert_data.num_peers = static_cast<int32_t>(status.num_peers);
-            alert_data.num_seeds = static_cast<int32_t>(status.num_seeds);
         } else if (auto* file_alert = dynamic_cast<libtorrent::file_completed_alert*>(alert_ptr)) {
             alert_data.type = libtorrent::ALERT_FILE_COMPLETED;
             // file_completed_alert has index property (file_index_t)
@@ -429,12 +402,8 @@ std::vector<libtorrent::AlertData> session_pop_alerts(session* sess) {
             alert_data.progress = static_cast<float>(status.progress_ppm) / 1000000.0f;
         } else if (auto* metadata_alert = dynamic_cast<libtorrent::metadata_received_alert*>(alert_ptr)) {
             alert_data.type = libtorrent::ALERT_METADATA_RECEIVED;
-        } else if (auto* state_alert = dynamic_cast<libtorrent::state_changed_alert*>(alert_ptr)) {
+        } else if (dynamic_cast<libtorrent::state_changed_alert*>(alert_ptr)) {
             alert_data.type = libtorrent::ALERT_STATE_CHANGED;
-            auto status = state_alert->handle.status();
-            alert_data.num_peers = static_cast<int32_t>(status.num_peers);
-            alert_data.num_seeds = static_cast<int32_t>(status.num_seeds);
-            alert_data.progress = static_cast<float>(status.progress_ppm) / 1000000.0f;
         }
         
         alerts.push_back(alert_data);
@@ -443,5 +412,40 @@ std::vector<libtorrent::AlertData> session_pop_alerts(session* sess) {
     return alerts;
 }
 
+std::string torrent_get_info_hash_internal(torrent_handle* handle) {
+    if (!handle) {
+        return std::string();
+    }
+    return hash_to_string(handle->info_hash());
+}
+
+std::vector<LibTorrentStatus> session_get_torrent_statuses_internal(session* sess) {
+    std::vector<LibTorrentStatus> result;
+    if (!sess) {
+        return result;
+    }
+    
+    // One request to the session thread for all torrents, rather than a
+    // handle->status() round trip per torrent and per field
+    auto statuses = sess->get_torrent_status([](torrent_status const&) { return true; });
+    result.reserve(statuses.size());
+    for (const auto& status : statuses) {
+        LibTorrentStatus snapshot;
+        snapshot.info_hash = hash_to_string(status.handle.info_hash());
+        // progress_ppm is parts per million (0 to 1000000)
+        snapshot.progress = static_cast<float>(status.progress_ppm) / 1000000.0f;
+        snapshot.num_peers = static_cast<int32_t>(status.num_peers);
+        snapshot.num_seeds = static_cast<int32_t>(status.num_seeds);
+        snapshot.download_rate = static_cast<int32_t>(status.download_payload_rate);
+        snapshot.upload_rate = static_cast<int32_t>(status.upload_payload_rate);
+        // Rank the session queue uses to pick which seeds run, from scraped swarm demand
+        snapshot.seed_rank = static_cast<int32_t>(status.seed_rank);
+        snapshot.is_queued = (status.flags & torrent_flags::auto_managed)
+            && (status.flags & torrent_flags::paused);
+        result.push_back(snapshot);
+    }
+    return result;
+}
+
 } // namespace libtorrent
 
@@ -100,14 +100,24 @@ bool torrent_set_file_priorities_internal(torrent_handle* handle, const std::vec
 /// Get download progress (0.0 to 1.0) for a torrent (internal C++ function)
 float torrent_get_progress_internal(torrent_handle* handle);
 
-/// Get number of connected peers
-int32_t torrent_get_num_peers(torrent_handle* handle);
+/// Get the info hash of a torrent as an uppercase hex string (internal C++ function)
+std::string torrent_get_info_hash_internal(torrent_handle* handle);
 
-/// Get number of seeders
-int32_t torrent_get_num_seeds(torrent_handle* handle);
+/// Internal C++ struct for a torrent status snapshot (not exposed to Rust)
+struct LibTorrentStatus {
+    std::string info_hash;
+    float progress;
+    int32_t num_peers;
+    int32_t num_seeds;
+    int32_t download_rate;
+    int32_t upload_rate;
+    int32_t seed_rank;
+    bool is_queued;
+};
 
-/// Get tracker status as a formatted string
-std::string torrent_get_tracker_status(torrent_handle* handle);
+/// Get the status of every torrent in the session (internal C++ function)
+/// Uses a single session-wide status query instead of one round trip per torrent
+std::vector<LibTorrentStatus> session_get_torrent_statuses_internal(session* sess);
 
 /// Internal C++ struct for torrent info (not exposed to Rust)
 struct LibTorrentInfo {
@@ -129,13 +139,22 @@ std::unique_ptr<LibTorrentInfo> get_torrent_info_internal(const std::string& fil
 /// Set seed_mode flag on add_torrent_params to skip hash verification
 void set_seed_mode(add_torrent_params* params, bool seed_mode);
 
-/// Set paused flag on add_torrent_params to add torrent in paused state
+/// Set or clear the paused flag on add_torrent_params
 void set_paused(add_torrent_params* params, bool paused);
 
+/// Set or clear the auto_managed flag on add_torrent_params
+/// Torrents added auto-managed wait for a slot in the session queue before starting
+void set_auto_managed(add_torrent_params* params, bool auto_managed);
+
 /// Set listen_interfaces on session_params
 /// interfaces can be an interface name (e.g. "eth0", "tun0") or IP:port (e.g. "0.0.0.0:6881")
 void set_listen_interfaces(session_params* params, const std::string& interfaces);
 
+/// Set the queueing limits for auto-managed torrents on session_params
+/// At most active_limit auto-managed torrents run at once, of which at most active_seeds seed.
+/// The rest stay paused, without peer connections or announces, until the queue rotates them in.
+void set_active_limits(session_params* params, int32_t active_seeds, int32_t active_limit);
+
 /// Get the actual listen_interfaces setting from a session
 std::string session_get_listen_interfaces(session* sess);
 
@@ -172,8 +191,6 @@ struct AlertData {
     std::string info_hash;
     std::string tracker_url;
     std::string tracker_message;
-    int32_t num_peers;
-    int32_t num_seeds;
     std::string file_path;
     float progress;
     std::string error_message;
@@ -215,12 +232,11 @@ rust::Vec<TorrentFileInfo> torrent_get_file_list(TorrentHandle* handle);
 TorrentInfo get_torrent_info(rust::Str file_path);
 bool torrent_set_file_priorities(TorrentHandle* handle, rust::Vec<uint8_t> priorities);
 float torrent_get_progress(TorrentHandle* handle);
-int32_t torrent_get_num_peers(TorrentHandle* handle);
-int32_t torrent_get_num_seeds(TorrentHandle* handle);
-rust::String torrent_get_tracker_status(TorrentHandle* handle);
+rust::String torrent_get_info_hash(TorrentHandle* handle);
 rust::String session_get_listen_interfaces(Session* sess);
 rust::String session_get_listening_port(Session* sess);
 void set_paused(AddTorrentParams* params, bool paused);
+void set_auto_managed(AddTorrentParams* params, bool auto_managed);
 void torrent_pause(TorrentHandle* handle);
 void torrent_resume(TorrentHandle* handle);
 
@@ -228,10 +244,14 @@ void torrent_resume(TorrentHandle* handle);
 struct AlertData;
 rust::Vec<AlertData> session_pop_alerts(Session* sess);
 
+// Status snapshots (implemented in bae_storage_helpers.cpp)
+struct TorrentStatusData;
+rust::Vec<TorrentStatusData> session_get_torrent_statuses(Session* sess);
+
 std::unique_ptr<BaeStorageConstructor> create_bae_storage_constructor(
     rust::Fn<rust::Vec<uint8_t>(int32_t, int32_t, int32_t, int32_t)> read_cb,
     rust::Fn<bool(int32_t, int32_t, int32_t, rust::Slice<const uint8_t>)> write_cb,
-    rust::Fn<bool(int32_t, int32_t, rust::Slice<const uint8_t>)> hash_cb
+    rust::Fn<void(int32_t, bool)> release_cb
 );
 std::unique_ptr<SessionParams> create_session_params_with_storage(std::unique_ptr<BaeStorageConstructor> disk_io);
 std::unique_ptr<SessionParams> create_session_params_default();
@@ -239,6 +259,7 @@ std::unique_ptr<AddTorrentParams> parse_magnet_uri(rust::Str magnet, rust::Str s
 std::unique_ptr<AddTorrentParams> load_torrent_file(rust::Str file_path, rust::Str save_path);
 void set_seed_mode(AddTorrentParams* params, bool seed_mode);
 void set_listen_interfaces(SessionParams* params, rust::Str interfaces);
+void set_active_limits(SessionParams* params, int32_t active_seeds, int32_t active_limit);
 rust::String torrent_get_name(TorrentHandle* handle);
 
 #endif // BAE_STORAGE_HELPERS_H
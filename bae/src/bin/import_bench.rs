@@ -0,0 +1,639 @@
+// Import throughput benchmark
+//
+// Generates synthetic releases and runs them through the real ImportService
+// pipeline against local chunk storage behind a simulated network link, with a
+// temporary database. Reports MB/s, how busy each pipeline stage was, how many
+// chunks were in flight, and peak RSS, so worker counts and chunk sizes can be
+// tuned with numbers.
+//
+//   cargo run --release --features test-utils --bin import_bench -- \
+//       --scenario small-tracks --latency-ms 40 --bandwidth-mbps 200
+
+// Link native libraries for the torrent manager the import service needs (see
+// the note in main.rs).
+#[link(name = "bae_storage", kind = "static")]
+#[link(name = "torrent-rasterbar")]
+extern "C" {}
+
+use std::env;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::path::Path;
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+
+use bae::cache::{CacheConfig, CacheManager};
+use bae::cloud_storage::{CloudStorage, CloudStorageError, CloudStorageManager, LocalCloudStorage};
+use bae::db::Database;
+use bae::discogs::models::{DiscogsRelease, DiscogsTrack};
+use bae::encryption::EncryptionService;
+use bae::import::{
+    ChunkLayoutMode, ImportConfig, ImportProgress, ImportRequest, ImportService,
+    ImportServiceHandle, PipelineSnapshot, PipelineStage,
+};
+use bae::library::{LibraryManager, SharedLibraryManager};
+use bae::memory::MemoryGovernor;
+use rand::{Rng, RngCore};
+use tracing::{error, info};
+
+const MB: u64 = 1024 * 1024;
+
+/// CD audio, so generated CUE/FLAC images look like real rips
+const SAMPLE_RATE: u32 = 44_100;
+const CHANNELS: u32 = 2;
+const BITS_PER_SAMPLE: u32 = 16;
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Scenario {
+    /// Many small track files
+    SmallTracks,
+    /// A few very large track files
+    LargeTracks,
+    /// One FLAC image split into tracks by a CUE sheet
+    CueFlac,
+}
+
+impl Scenario {
+    const ALL: [Scenario; 3] = [
+        Scenario::SmallTracks,
+        Scenario::LargeTracks,
+        Scenario::CueFlac,
+    ];
+
+    fn name(&self) -> &'static str {
+        match self {
+            Scenario::SmallTracks => "small-tracks",
+            Scenario::LargeTracks => "large-tracks",
+            Scenario::CueFlac => "cue-flac",
+        }
+    }
+}
+
+struct Options {
+    scenarios: Vec<Scenario>,
+    /// Multiplies the size of every generated release
+    scale: f64,
+    chunk_size_bytes: usize,
+    encrypt_workers: usize,
+    upload_workers: usize,
+    db_write_workers: usize,
+    /// Added to every transfer, like a request round trip
+    latency: Duration,
+    /// Bandwidth of the link all transfers share, unlimited if None
+    bandwidth_bytes_per_sec: Option<f64>,
+    memory_budget_bytes: u64,
+}
+
+impl Default for Options {
+    fn default() -> Self {
+        Options {
+            scenarios: Scenario::ALL.to_vec(),
+            scale: 1.0,
+            chunk_size_bytes: MB as usize,
+            encrypt_workers: std::thread::available_parallelism()
+                .map(|n| n.get() * 2)
+                .unwrap_or(4),
+            upload_workers: 20,
+            db_write_workers: 10,
+            latency: Duration::from_millis(30),
+            bandwidth_bytes_per_sec: Some(500_000_000.0 / 8.0),
+            memory_budget_bytes: 1024 * MB,
+        }
+    }
+}
+
+const USAGE: &str = "Usage: import_bench [options]
+  --scenario <small-tracks|large-tracks|cue-flac|all>  (repeatable, default all)
+  --scale <factor>              size of generated releases (default 1.0)
+  --chunk-size-mb <mb>          chunk size (default 1)
+  --encrypt-workers <n>         (default 2x CPU cores)
+  --upload-workers <n>          (default 20)
+  --db-workers <n>              (default 10)
+  --latency-ms <ms>             per transfer (default 30)
+  --bandwidth-mbps <mbit/s>     shared link, 0 for unlimited (default 500)
+  --memory-mb <mb>              memory budget (default 1024)";
+
+fn parse_options(args: &[String]) -> Result<Options, String> {
+    let mut options = Options::default();
+    let mut scenarios = Vec::new();
+
+    let mut args = args.iter();
+    while let Some(flag) = args.next() {
+        let value = args
+            .next()
+            .ok_or_else(|| format!("Missing value for {}", flag))?;
+        let number = || {
+            value
+                .parse::<f64>()
+                .ok()
+                .filter(|n| *n >= 0.0)
+                .ok_or_else(|| format!("Invalid value for {}: {}", flag, value))
+        };
+
+        match flag.as_str() {
+            "--scenario" => match value.as_str() {
+                "all" => scenarios.extend(Scenario::ALL),
+                name => scenarios.push(
+                    *Scenario::ALL
+                        .iter()
+                        .find(|scenario| scenario.name() == name)
+                        .ok_or_else(|| format!("Unknown scenario: {}", name))?,
+                ),
+            },
+            "--scale" => options.scale = number()?,
+            "--chunk-size-mb" => options.chunk_size_bytes = (number()? * MB as f64) as usize,
+            "--encrypt-workers" => options.encrypt_workers = number()? as usize,
+            "--upload-workers" => options.upload_workers = number()? as usize,
+            "--db-workers" => options.db_write_workers = number()? as usize,
+            "--latency-ms" => options.latency = Duration::from_secs_f64(number()? / 1000.0),
+            "--bandwidth-mbps" => {
+                let mbps = number()?;
+                options.bandwidth_bytes_per_sec = (mbps > 0.0).then_some(mbps * 1_000_000.0 / 8.0);
+            }
+            "--memory-mb" => options.memory_budget_bytes = (number()? * MB as f64) as u64,
+            _ => return Err(format!("Unknown option: {}", flag)),
+        }
+    }
+
+    if !scenarios.is_empty() {
+        options.scenarios = scenarios;
+    }
+    if options.chunk_size_bytes == 0
+        || options.encrypt_workers == 0
+        || options.upload_workers == 0
+        || options.db_write_workers == 0
+    {
+        return Err("Chunk size and worker counts must be positive".to_string());
+    }
+    Ok(options)
+}
+
+fn main() {
+    tracing_subscriber::fmt()
+        .with_env_filter(tracing_subscriber::EnvFilter::from_default_env())
+        .with_line_number(true)
+        .with_target(false)
+        .init();
+
+    let args: Vec<String> = env::args().skip(1).collect();
+    let options = match parse_options(&args) {
+        Ok(options) => options,
+        Err(e) => {
+            error!("{}", e);
+            eprintln!("{}", USAGE);
+            std::process::exit(1);
+        }
+    };
+
+    let runtime = tokio::runtime::Runtime::new().expect("Failed to create tokio runtime");
+    if let Err(e) = runtime.block_on(run(options)) {
+        error!("{}", e);
+        std::process::exit(1);
+    }
+}
+
+async fn run(options: Options) -> Result<(), String> {
+    let work_dir = env::temp_dir().join(format!("bae-import-bench-{}", uuid::Uuid::new_v4()));
+    std::fs::create_dir_all(&work_dir)
+        .map_err(|e| format!("Failed to create {}: {}", work_dir.display(), e))?;
+
+    info!("Working in {}", work_dir.display());
+
+    let result = run_scenarios(&options, &work_dir).await;
+
+    if let Err(e) = std::fs::remove_dir_all(&work_dir) {
+        error!("Failed to remove {}: {}", work_dir.display(), e);
+    }
+    result
+}
+
+async fn run_scenarios(options: &Options, work_dir: &Path) -> Result<(), String> {
+    let import_handle = start_import_service(options, work_dir).await?;
+
+    print_settings(options);
+
+    for (run, &scenario) in options.scenarios.iter().enumerate() {
+        let album_dir = work_dir.join(format!("album-{}", run));
+        std::fs::create_dir_all(&album_dir)
+            .map_err(|e| format!("Failed to create {}: {}", album_dir.display(), e))?;
+
+        info!("Generating {} release...", scenario.name());
+
+        let release = generate_release(scenario, options.scale, &album_dir, run)?;
+
+        // Counters and the RSS peak only cover this run from here on
+        import_handle.pipeline_stats.take();
+        reset_peak_rss();
+
+        let request = ImportRequest::Folder {
+            discogs_release: Some(release),
+            mb_release: None,
+            folder: album_dir.clone(),
+            master_year: 2024,
+            cover_art_url: None,
+        };
+        let (_album_id, release_id) = import_handle.send_request(request).await?;
+
+        let started = Instant::now();
+        wait_for_import(&import_handle, release_id).await?;
+        let elapsed = started.elapsed();
+
+        print_report(
+            scenario,
+            options,
+            elapsed,
+            &import_handle.pipeline_stats.take(),
+            peak_rss_bytes(),
+        );
+
+        // Generated files are only needed for one run
+        let _ = std::fs::remove_dir_all(&album_dir);
+    }
+
+    Ok(())
+}
+
+async fn start_import_service(
+    options: &Options,
+    work_dir: &Path,
+) -> Result<ImportServiceHandle, String> {
+    let storage = LocalCloudStorage::new(work_dir.join("storage"))
+        .await
+        .map_err(|e| format!("Failed to create chunk storage: {}", e))?;
+    let cloud_storage = CloudStorageManager::from_storage(Arc::new(SimulatedCloud::new(
+        storage,
+        options.latency,
+        options.bandwidth_bytes_per_sec,
+    )));
+
+    let database = Database::new(work_dir.join("library.db").to_str().unwrap())
+        .await
+        .map_err(|e| format!("Failed to create database: {}", e))?;
+
+    let encryption_service = EncryptionService::new_with_key(vec![0u8; 32]);
+
+    let cache_config = |dir: &str| CacheConfig {
+        cache_dir: work_dir.join(dir),
+        max_size_bytes: 1024 * MB,
+        max_chunks: 10_000,
+    };
+    let cache_manager = CacheManager::with_config(cache_config("cache"))
+        .await
+        .map_err(|e| format!("Failed to create cache: {}", e))?;
+    let seed_cache = CacheManager::with_config(cache_config("seed-cache"))
+        .await
+        .map_err(|e| format!("Failed to create seed cache: {}", e))?;
+
+    let library_manager = LibraryManager::new(database.clone(), cloud_storage.clone());
+
+    // Folder imports don't use it, but the import service needs one
+    let torrent_manager = bae::torrent::start_torrent_manager(
+        seed_cache,
+        bae::torrent::PinManager::new(0),
+        cloud_storage.clone(),
+        encryption_service.clone(),
+        database,
+        bae::torrent::client::TorrentClientOptions::default(),
+    );
+
+    let import_config = ImportConfig {
+        min_chunk_size_bytes: options.chunk_size_bytes,
+        max_chunk_size_bytes: options.chunk_size_bytes,
+        max_encrypt_workers: options.encrypt_workers,
+        max_upload_workers: options.upload_workers,
+        max_db_write_workers: options.db_write_workers,
+        chunk_layout: ChunkLayoutMode::Contiguous,
+    };
+
+    Ok(ImportService::start(
+        import_config,
+        tokio::runtime::Handle::current(),
+        SharedLibraryManager::new(library_manager),
+        encryption_service,
+        cloud_storage,
+        cache_manager,
+        torrent_manager,
+        MemoryGovernor::new(options.memory_budget_bytes),
+    ))
+}
+
+async fn wait_for_import(
+    import_handle: &ImportServiceHandle,
+    release_id: String,
+) -> Result<(), String> {
+    let mut progress_rx = import_handle.subscribe_release(release_id);
+    while let Some(progress) = progress_rx.recv().await {
+        match progress {
+            ImportProgress::Complete { .. } => return Ok(()),
+            ImportProgress::Failed { error, .. } => {
+                return Err(format!("Import failed: {}", error));
+            }
+            _ => {}
+        }
+    }
+    Err("Import service stopped before the import finished".to_string())
+}
+
+// ============================================================================
+// Simulated cloud
+// ============================================================================
+
+/// Local chunk storage behind a simulated network link
+///
+/// Every transfer waits for the link to carry its bytes after the transfers
+/// queued before it, then for the latency, so concurrent uploads share the
+/// bandwidth the way they would share an uplink.
+struct SimulatedCloud {
+    storage: LocalCloudStorage,
+    latency: Duration,
+    bandwidth_bytes_per_sec: Option<f64>,
+    /// When the link is done with the transfers already on it
+    link_free_at: Mutex<Instant>,
+}
+
+impl SimulatedCloud {
+    fn new(
+        storage: LocalCloudStorage,
+        latency: Duration,
+        bandwidth_bytes_per_sec: Option<f64>,
+    ) -> Self {
+        SimulatedCloud {
+            storage,
+            latency,
+            bandwidth_bytes_per_sec,
+            link_free_at: Mutex::new(Instant::now()),
+        }
+    }
+
+    async fn transfer(&self, bytes: usize) {
+        let sent_at = match self.bandwidth_bytes_per_sec {
+            Some(bandwidth) => {
+                let mut link_free_at = self.link_free_at.lock().unwrap();
+                let start = (*link_free_at).max(Instant::now());
+                *link_free_at = start + Duration::from_secs_f64(bytes as f64 / bandwidth);
+                *link_free_at
+            }
+            None => Instant::now(),
+        };
+        tokio::time::sleep_until((sent_at + self.latency).into()).await;
+    }
+}
+
+#[async_trait::async_trait]
+impl CloudStorage for SimulatedCloud {
+    async fn upload_chunk(&self, chunk_id: &str, data: &[u8]) -> Result<String, CloudStorageError> {
+        self.transfer(data.len()).await;
+        self.storage.upload_chunk(chunk_id, data).await
+    }
+
+    async fn download_chunk(&self, storage_location: &str) -> Result<Vec<u8>, CloudStorageError> {
+        let data = self.storage.download_chunk(storage_location).await?;
+        self.transfer(data.len()).await;
+        Ok(data)
+    }
+
+    async fn delete_chunk(&self, storage_location: &str) -> Result<(), CloudStorageError> {
+        self.transfer(0).await;
+        self.storage.delete_chunk(storage_location).await
+    }
+}
+
+// ============================================================================
+// Synthetic releases
+// ============================================================================
+
+/// Write a scenario's files to `dir` and return matching release metadata
+///
+/// Audio is random bytes (or white noise for CUE/FLAC), so it neither
+/// compresses nor dedupes, like real audio.
+fn generate_release(
+    scenario: Scenario,
+    scale: f64,
+    dir: &Path,
+    run: usize,
+) -> Result<DiscogsRelease, String> {
+    let scaled = |bytes: u64| ((bytes as f64 * scale) as u64).max(1);
+
+    let track_count = match scenario {
+        Scenario::SmallTracks => {
+            let track_count = 100;
+            for track in 1..=track_count {
+                let path = dir.join(format!("{:03} Track {}.flac", track, track));
+                write_random_file(&path, scaled(2 * MB))?;
+            }
+            track_count
+        }
+        Scenario::LargeTracks => {
+            let track_count = 3;
+            for track in 1..=track_count {
+                let path = dir.join(format!("{:02} Track {}.flac", track, track));
+                write_random_file(&path, scaled(128 * MB))?;
+            }
+            track_count
+        }
+        Scenario::CueFlac => {
+            let track_count = 12;
+            write_cue_flac(dir, track_count, scaled(64 * MB))?;
+            track_count
+        }
+    };
+
+    Ok(DiscogsRelease {
+        id: format!("bench-release-{}", run),
+        title: format!("Benchmark {} {}", scenario.name(), run),
+        year: Some(2024),
+        genre: vec![],
+        style: vec![],
+        format: vec![],
+        country: None,
+        label: vec![],
+        cover_image: None,
+        thumb: None,
+        artists: vec![],
+        tracklist: (1..=track_count)
+            .map(|track| DiscogsTrack {
+                position: track.to_string(),
+                title: format!("Track {}", track),
+                duration: None,
+            })
+            .collect(),
+        master_id: format!("bench-master-{}", run),
+    })
+}
+
+fn write_random_file(path: &Path, size: u64) -> Result<(), String> {
+    let file = File::create(path).map_err(|e| format!("Failed to create {:?}: {}", path, e))?;
+    let mut writer = BufWriter::new(file);
+    let mut rng = rand::thread_rng();
+    let mut block = vec![0u8; MB as usize];
+
+    let mut remaining = size;
+    while remaining > 0 {
+        let len = remaining.min(block.len() as u64) as usize;
+        rng.fill_bytes(&mut block[..len]);
+        writer
+            .write_all(&block[..len])
+            .map_err(|e| format!("Failed to write {:?}: {}", path, e))?;
+        remaining -= len as u64;
+    }
+    writer
+        .flush()
+        .map_err(|e| format!("Failed to write {:?}: {}", path, e))
+}
+
+/// Write `album.flac` of about `size` bytes and `album.cue` splitting it evenly
+fn write_cue_flac(dir: &Path, track_count: usize, size: u64) -> Result<(), String> {
+    use flacenc::bitsink::ByteSink;
+    use flacenc::component::BitRepr;
+    use flacenc::error::Verify;
+    use flacenc::source::MemSource;
+
+    // White noise barely compresses, so the FLAC is about as large as the PCM
+    let bytes_per_frame = (CHANNELS * BITS_PER_SAMPLE / 8) as u64;
+    let frames = (size / bytes_per_frame).max(SAMPLE_RATE as u64 * track_count as u64);
+    let mut rng = rand::thread_rng();
+    let samples: Vec<i32> = (0..frames * CHANNELS as u64)
+        .map(|_| rng.gen_range(-16_384..16_384))
+        .collect();
+
+    let source = MemSource::from_samples(
+        &samples,
+        CHANNELS as usize,
+        BITS_PER_SAMPLE as usize,
+        SAMPLE_RATE as usize,
+    );
+    let config = flacenc::config::Encoder::default()
+        .into_verified()
+        .map_err(|(_, e)| format!("Failed to verify encoder config: {:?}", e))?;
+    let stream = flacenc::encode_with_fixed_block_size(&config, source, 4096)
+        .map_err(|e| format!("Failed to encode FLAC: {:?}", e))?;
+    let mut sink = ByteSink::new();
+    stream
+        .write(&mut sink)
+        .map_err(|e| format!("Failed to write FLAC: {:?}", e))?;
+    std::fs::write(dir.join("album.flac"), sink.as_slice())
+        .map_err(|e| format!("Failed to write album.flac: {}", e))?;
+
+    // CUE times are minutes:seconds:frames, at 75 frames per second
+    let track_frames = frames / track_count as u64;
+    let mut cue =
+        String::from("PERFORMER \"Benchmark\"\nTITLE \"Benchmark\"\nFILE \"album.flac\" WAVE\n");
+    for track in 0..track_count {
+        let start = track as u64 * track_frames * 75 / SAMPLE_RATE as u64;
+        cue.push_str(&format!(
+            "  TRACK {:02} AUDIO\n    TITLE \"Track {}\"\n    INDEX 01 {:02}:{:02}:{:02}\n",
+            track + 1,
+            track + 1,
+            start / 75 / 60,
+            start / 75 % 60,
+            start % 75
+        ));
+    }
+    std::fs::write(dir.join("album.cue"), cue)
+        .map_err(|e| format!("Failed to write album.cue: {}", e))
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+fn print_settings(options: &Options) {
+    let bandwidth = match options.bandwidth_bytes_per_sec {
+        Some(bandwidth) => format!("{:.0} Mbit/s", bandwidth * 8.0 / 1_000_000.0),
+        None => "unlimited".to_string(),
+    };
+    println!(
+        "chunk size {} KB, workers encrypt {} / upload {} / db {}, latency {} ms, bandwidth {}, memory budget {} MB",
+        options.chunk_size_bytes / 1024,
+        options.encrypt_workers,
+        options.upload_workers,
+        options.db_write_workers,
+        options.latency.as_millis(),
+        bandwidth,
+        options.memory_budget_bytes / MB
+    );
+}
+
+/// Print throughput and per-stage counters of one run
+///
+/// Utilization is busy time over the time the stage's workers had, and mean
+/// in flight is busy time over wall time.
+fn print_report(
+    scenario: Scenario,
+    options: &Options,
+    elapsed: Duration,
+    snapshot: &PipelineSnapshot,
+    peak_rss: Option<u64>,
+) {
+    let megabytes = snapshot.bytes_read as f64 / MB as f64;
+    let seconds = elapsed.as_secs_f64();
+    let peak_rss = match peak_rss {
+        Some(bytes) => format!("{} MB", bytes / MB),
+        None => "unknown".to_string(),
+    };
+
+    println!();
+    println!(
+        "{}: {:.1} MB in {:.2} s = {:.1} MB/s, peak RSS {}",
+        scenario.name(),
+        megabytes,
+        seconds,
+        megabytes / seconds,
+        peak_rss
+    );
+    println!(
+        "  {:<8} {:>7} {:>7} {:>10} {:>10} {:>10}",
+        "stage", "workers", "util", "mean busy", "peak busy", "completed"
+    );
+    for stage in &snapshot.stages {
+        let workers = match stage.stage {
+            PipelineStage::Read => 1,
+            PipelineStage::Encrypt => options.encrypt_workers,
+            PipelineStage::Upload => options.upload_workers,
+            PipelineStage::Persist | PipelineStage::Track => options.db_write_workers,
+        };
+        let mean_in_flight = stage.busy.as_secs_f64() / seconds;
+        println!(
+            "  {:<8} {:>7} {:>6.1}% {:>10.2} {:>10} {:>10}",
+            stage.stage.name(),
+            workers,
+            100.0 * mean_in_flight / workers as f64,
+            mean_in_flight,
+            stage.peak_in_flight,
+            stage.completed
+        );
+    }
+    println!(
+        "  chunks waiting for encryption: peak {}",
+        snapshot.peak_queued_chunks
+    );
+}
+
+/// Peak resident set size since the last [`reset_peak_rss`]
+///
+/// Outside Linux the peak can't be reset and covers the whole process.
+fn peak_rss_bytes() -> Option<u64> {
+    #[cfg(target_os = "linux")]
+    {
+        let status = std::fs::read_to_string("/proc/self/status").ok()?;
+        let line = status.lines().find(|line| line.starts_with("VmHWM:"))?;
+        let kilobytes: u64 = line.split_whitespace().nth(1)?.parse().ok()?;
+        Some(kilobytes * 1024)
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    {
+        let mut usage: libc::rusage = unsafe { std::mem::zeroed() };
+        if unsafe { libc::getrusage(libc::RUSAGE_SELF, &mut usage) } != 0 {
+            return None;
+        }
+        // ru_maxrss is in bytes on macOS
+        Some(usage.ru_maxrss as u64)
+    }
+}
+
+fn reset_peak_rss() {
+    // Writing 5 to clear_refs resets VmHWM to the current RSS
+    #[cfg(target_os = "linux")]
+    let _ = std::fs::write("/proc/self/clear_refs", "5");
+}
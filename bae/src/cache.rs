@@ -1,9 +1,9 @@
-use std::collections::{HashMap, HashSet};
+use std::collections::{hash_map::Entry, HashMap, HashSet};
 use std::path::PathBuf;
 use std::sync::Arc;
 use thiserror::Error;
 use tokio::fs;
-use tokio::sync::RwLock;
+use tokio::sync::{watch, RwLock};
 use tracing::{debug, error, info, warn};
 
 /// Errors that can occur during cache operations
@@ -56,6 +56,8 @@ pub struct CacheManager {
     current_size: Arc<RwLock<u64>>,
     /// Set of pinned chunk IDs that should not be evicted
     pinned_chunks: Arc<RwLock<HashSet<String>>>,
+    /// Becomes true once chunks already on disk have been indexed
+    index_loaded: watch::Receiver<bool>,
 }
 
 impl CacheManager {
@@ -69,19 +71,34 @@ impl CacheManager {
         // Ensure cache directory exists
         fs::create_dir_all(&config.cache_dir).await?;
 
+        let (index_loaded_tx, index_loaded) = watch::channel(false);
         let cache_manager = CacheManager {
             config,
             entries: Arc::new(RwLock::new(HashMap::new())),
             current_size: Arc::new(RwLock::new(0)),
             pinned_chunks: Arc::new(RwLock::new(HashSet::new())),
+            index_loaded,
         };
 
-        // Load existing cache entries from disk
-        cache_manager.load_existing_cache().await?;
+        // Index existing cache files in the background so startup doesn't wait on a
+        // large cache. Until then lookups miss and fall back to cloud storage.
+        let loader = cache_manager.clone();
+        tokio::spawn(async move {
+            if let Err(e) = loader.load_existing_cache().await {
+                error!("Failed to load existing cache entries: {}", e);
+            }
+            let _ = index_loaded_tx.send(true);
+        });
 
         Ok(cache_manager)
     }
 
+    /// Wait until chunks already on disk have been indexed
+    pub async fn wait_until_loaded(&self) {
+        let mut index_loaded = self.index_loaded.clone();
+        let _ = index_loaded.wait_for(|loaded| *loaded).await;
+    }
+
     /// Get a chunk from cache if it exists
     pub async fn get_chunk(&self, chunk_id: &str) -> Result<Option<Vec<u8>>, CacheError> {
         let mut entries = self.entries.write().await;
@@ -118,6 +135,9 @@ impl CacheManager {
     pub async fn put_chunk(&self, chunk_id: &str, data: &[u8]) -> Result<(), CacheError> {
         let chunk_size = data.len() as u64;
 
+        // Eviction can only keep the cache within budget once every chunk is indexed
+        self.wait_until_loaded().await;
+
         // Check if we need to evict chunks to make space
         self.ensure_space_available(chunk_size).await?;
 
@@ -151,10 +171,48 @@ impl CacheManager {
         Ok(())
     }
 
+    /// Remove many chunks from the cache at once, e.g. after their release is deleted
+    ///
+    /// Index updates happen under a single lock acquisition; files are removed afterwards.
+    pub async fn remove_chunks(&self, chunk_ids: &[String]) {
+        // A chunk the startup scan hasn't indexed yet would be indexed again afterwards
+        self.wait_until_loaded().await;
+
+        let removed: Vec<CacheEntry> = {
+            let mut entries = self.entries.write().await;
+            let mut current_size = self.current_size.write().await;
+            let mut pinned = self.pinned_chunks.write().await;
+
+            chunk_ids
+                .iter()
+                .filter_map(|chunk_id| {
+                    pinned.remove(chunk_id);
+                    let entry = entries.remove(chunk_id)?;
+                    *current_size = current_size.saturating_sub(entry.size_bytes);
+                    Some(entry)
+                })
+                .collect()
+        };
+
+        for entry in &removed {
+            if let Err(e) = fs::remove_file(&entry.file_path).await {
+                warn!(
+                    "Failed to remove cache file {}: {}",
+                    entry.file_path.display(),
+                    e
+                );
+            }
+        }
+
+        debug!("Removed {} chunks from cache", removed.len());
+    }
+
     /// Load existing cache entries from disk on startup
+    ///
+    /// The directory is scanned without holding the index locks, so lookups aren't
+    /// blocked while a large cache is read.
     async fn load_existing_cache(&self) -> Result<(), CacheError> {
-        let mut entries = self.entries.write().await;
-        let mut current_size = self.current_size.write().await;
+        let mut loaded = Vec::new();
 
         let mut dir_entries = fs::read_dir(&self.config.cache_dir).await?;
         while let Some(entry) = dir_entries.next_entry().await? {
@@ -175,8 +233,7 @@ impl CacheManager {
                                     .unwrap_or(std::time::SystemTime::now()),
                             };
 
-                            *current_size += cache_entry.size_bytes;
-                            entries.insert(chunk_id, cache_entry);
+                            loaded.push((chunk_id, cache_entry));
                         }
                         Err(e) => {
                             warn!(
@@ -190,6 +247,15 @@ impl CacheManager {
             }
         }
 
+        let mut entries = self.entries.write().await;
+        let mut current_size = self.current_size.write().await;
+        for (chunk_id, cache_entry) in loaded {
+            if let Entry::Vacant(slot) = entries.entry(chunk_id) {
+                *current_size += cache_entry.size_bytes;
+                slot.insert(cache_entry);
+            }
+        }
+
         info!(
             "Loaded {} existing cache entries ({} bytes)",
             entries.len(),
@@ -203,27 +269,37 @@ impl CacheManager {
         let mut entries = self.entries.write().await;
         let mut current_size = self.current_size.write().await;
 
-        // Check if we need to evict by size
+        // Check if we need to evict by size. Stop if everything left is pinned.
         while *current_size + needed_bytes > self.config.max_size_bytes && !entries.is_empty() {
-            self.evict_lru_chunk(&mut entries, &mut current_size)
-                .await?;
+            if !self
+                .evict_lru_chunk(&mut entries, &mut current_size)
+                .await?
+            {
+                break;
+            }
         }
 
         // Check if we need to evict by count
         while entries.len() >= self.config.max_chunks && !entries.is_empty() {
-            self.evict_lru_chunk(&mut entries, &mut current_size)
-                .await?;
+            if !self
+                .evict_lru_chunk(&mut entries, &mut current_size)
+                .await?
+            {
+                break;
+            }
         }
 
         Ok(())
     }
 
-    /// Evict the least recently used chunk
+    /// Evict the least recently used chunk that isn't pinned
+    ///
+    /// Returns false if every cached chunk is pinned.
     async fn evict_lru_chunk(
         &self,
         entries: &mut HashMap<String, CacheEntry>,
         current_size: &mut u64,
-    ) -> Result<(), CacheError> {
+    ) -> Result<bool, CacheError> {
         // Get pinned chunks to exclude from eviction
         let pinned = self.pinned_chunks.read().await;
 
@@ -248,9 +324,10 @@ impl CacheManager {
                 *current_size = current_size.saturating_sub(entry.size_bytes);
                 debug!("Evicted chunk {} ({} bytes)", chunk_id, entry.size_bytes);
             }
+            return Ok(true);
         }
 
-        Ok(())
+        Ok(false)
     }
 
     /// Pin a chunk to prevent it from being evicted
@@ -281,3 +358,37 @@ impl CacheManager {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[tokio::test]
+    async fn test_remove_chunks_drops_entries_pins_and_files() {
+        let temp_dir = tempfile::tempdir().unwrap();
+        let cache = CacheManager::with_config(CacheConfig {
+            cache_dir: temp_dir.path().to_path_buf(),
+            max_size_bytes: 1024 * 1024,
+            max_chunks: 100,
+        })
+        .await
+        .unwrap();
+        cache.wait_until_loaded().await;
+
+        for chunk_id in ["a", "b", "c"] {
+            cache.put_chunk(chunk_id, &[0u8; 100]).await.unwrap();
+        }
+        cache.pin_chunk("b").await;
+
+        cache
+            .remove_chunks(&["a".to_string(), "b".to_string(), "missing".to_string()])
+            .await;
+
+        assert!(cache.get_chunk("a").await.unwrap().is_none());
+        assert!(cache.get_chunk("b").await.unwrap().is_none());
+        assert!(cache.get_chunk("c").await.unwrap().is_some());
+        assert!(!cache.pinned_chunks.read().await.contains("b"));
+        assert_eq!(*cache.current_size.read().await, 100);
+        assert_eq!(std::fs::read_dir(temp_dir.path()).unwrap().count(), 1);
+    }
+}
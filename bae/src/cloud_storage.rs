@@ -1,10 +1,27 @@
+use crate::lan_peers::LanPeers;
 use aws_config::{BehaviorVersion, Region};
 use aws_credential_types::Credentials;
+use aws_sdk_s3::types::{Delete, ObjectIdentifier};
 use aws_sdk_s3::{primitives::ByteStreamError, Client, Error as S3Error};
+use futures::stream::{self, StreamExt};
 use serde::{Deserialize, Serialize};
+use std::collections::HashSet;
+use std::future::Future;
+use std::io::Write;
+use std::path::{Path, PathBuf};
 use thiserror::Error;
+use tokio::sync::{mpsc, oneshot, watch};
 use tracing::{debug, error, info, warn};
 
+/// Maximum keys per S3 DeleteObjects request
+const DELETE_BATCH_SIZE: usize = 1000;
+
+/// Delete batches in flight at once for a background deletion job
+const MAX_CONCURRENT_DELETE_BATCHES: usize = 4;
+
+/// Most local chunk writes whose directories one flusher pass syncs together
+const MAX_SYNC_BATCH: usize = 256;
+
 #[derive(Error, Debug)]
 pub enum CloudStorageError {
     #[error("S3 error: {0}")]
@@ -63,6 +80,25 @@ pub trait CloudStorage: Send + Sync {
     async fn upload_chunk(&self, chunk_id: &str, data: &[u8]) -> Result<String, CloudStorageError>;
     async fn download_chunk(&self, storage_location: &str) -> Result<Vec<u8>, CloudStorageError>;
     async fn delete_chunk(&self, storage_location: &str) -> Result<(), CloudStorageError>;
+
+    /// Delete many chunks, returning the locations that could not be deleted
+    ///
+    /// Backends with a bulk delete API should override this; the default
+    /// deletes chunks one at a time.
+    async fn delete_chunks(
+        &self,
+        storage_locations: &[String],
+    ) -> Result<Vec<String>, CloudStorageError> {
+        let mut failed = Vec::new();
+        for storage_location in storage_locations {
+            if let Err(e) = self.delete_chunk(storage_location).await {
+                warn!("Failed to delete chunk {}: {}", storage_location, e);
+
+                failed.push(storage_location.clone());
+            }
+        }
+        Ok(failed)
+    }
 }
 
 /// Format AWS SDK error for better debugging
@@ -147,92 +183,90 @@ impl S3CloudStorage {
 
         // Create bucket if it doesn't exist (useful for dev/testing)
         if create_bucket {
-            info!("Checking if bucket '{}' exists...", bucket_name);
-            match client.head_bucket().bucket(&bucket_name).send().await {
+            ensure_bucket(&client, &bucket_name, config.endpoint_url.as_deref()).await?;
+        }
+
+        Ok(S3CloudStorage {
+            client,
+            bucket_name,
+        })
+    }
+}
+
+/// Make sure the bucket exists, creating it if needed (useful for dev/testing)
+async fn ensure_bucket(
+    client: &Client,
+    bucket_name: &str,
+    endpoint_url: Option<&str>,
+) -> Result<(), CloudStorageError> {
+    info!("Checking if bucket '{}' exists...", bucket_name);
+    match client.head_bucket().bucket(bucket_name).send().await {
+        Ok(_) => {
+            info!("Bucket '{}' already exists", bucket_name);
+        }
+        Err(e) => {
+            let err_details = format_error_details(&e);
+            debug!("Bucket check failed: {} ({:?})", err_details, e);
+            info!("Creating bucket '{}'", bucket_name);
+
+            match client.create_bucket().bucket(bucket_name).send().await {
                 Ok(_) => {
-                    info!("Bucket '{}' already exists", bucket_name);
+                    info!("Bucket '{}' created successfully", bucket_name);
                 }
-                Err(e) => {
-                    let err_details = format_error_details(&e);
-                    debug!("Bucket check failed: {} ({:?})", err_details, e);
-                    info!("Creating bucket '{}'", bucket_name);
-
-                    match client.create_bucket().bucket(&bucket_name).send().await {
-                        Ok(_) => {
-                            info!("Bucket '{}' created successfully", bucket_name);
-                        }
-                        Err(create_err) => {
-                            let create_err_details = format_error_details(&create_err);
-                            // Check if the error is because bucket already exists
-                            let err_str = format!("{:?}", create_err);
-                            if err_str.contains("BucketAlreadyOwnedByYou")
-                                || err_str.contains("BucketAlreadyExists")
-                            {
+                Err(create_err) => {
+                    let create_err_details = format_error_details(&create_err);
+                    // Check if the error is because bucket already exists
+                    let err_str = format!("{:?}", create_err);
+                    if err_str.contains("BucketAlreadyOwnedByYou")
+                        || err_str.contains("BucketAlreadyExists")
+                    {
+                        info!(
+                            "Bucket '{}' already exists (create returned: {})",
+                            bucket_name, create_err_details
+                        );
+                    } else {
+                        // Try to use the bucket anyway - maybe we have access
+                        warn!(
+                            "Failed to create bucket '{}': {}. Attempting to use it anyway...",
+                            bucket_name, create_err_details
+                        );
+
+                        // Test if we can actually use the bucket by listing objects
+                        match client
+                            .list_objects_v2()
+                            .bucket(bucket_name)
+                            .max_keys(1)
+                            .send()
+                            .await
+                        {
+                            Ok(_) => {
                                 info!(
-                                    "Bucket '{}' already exists (create returned: {})",
-                                    bucket_name, create_err_details
+                                    "Bucket '{}' is accessible despite creation error",
+                                    bucket_name
                                 );
-                            } else {
-                                // Try to use the bucket anyway - maybe we have access
-                                warn!(
-                                    "Failed to create bucket '{}': {}. Attempting to use it anyway...",
-                                    bucket_name, create_err_details
+                            }
+                            Err(list_err) => {
+                                let error_msg = format!(
+                                    "Cannot access bucket '{}'. Create error: {}. List error: {}. Endpoint: {:?}",
+                                    bucket_name, create_err, list_err, endpoint_url
                                 );
-
-                                // Test if we can actually use the bucket by listing objects
-                                match client
-                                    .list_objects_v2()
-                                    .bucket(&bucket_name)
-                                    .max_keys(1)
-                                    .send()
-                                    .await
-                                {
-                                    Ok(_) => {
-                                        info!(
-                                            "Bucket '{}' is accessible despite creation error",
-                                            bucket_name
-                                        );
-                                    }
-                                    Err(list_err) => {
-                                        let error_msg = format!(
-                                            "Cannot access bucket '{}'. Create error: {}. List error: {}. Endpoint: {:?}",
-                                            bucket_name, create_err, list_err, config.endpoint_url
-                                        );
-                                        error!("{}", error_msg);
-                                        return Err(CloudStorageError::SdkError(error_msg));
-                                    }
-                                }
+                                error!("{}", error_msg);
+                                return Err(CloudStorageError::SdkError(error_msg));
                             }
                         }
                     }
                 }
             }
         }
-
-        Ok(S3CloudStorage {
-            client,
-            bucket_name,
-        })
     }
 
-    /// Generate S3 key for a chunk using hash-based partitioning
-    /// Example: chunk_abcd1234-5678-9abc-def0-123456789abc -> chunks/ab/cd/chunk_abcd1234-5678-9abc-def0-123456789abc.enc
-    fn chunk_key(&self, chunk_id: &str) -> String {
-        if chunk_id.len() < 4 {
-            // Fallback for malformed chunk IDs
-            return format!("chunks/misc/{}.enc", chunk_id);
-        }
-
-        let prefix = &chunk_id[..2]; // First 2 chars: "ab"
-        let subprefix = &chunk_id[2..4]; // Next 2 chars: "cd"
-        format!("chunks/{}/{}/{}.enc", prefix, subprefix, chunk_id)
-    }
+    Ok(())
 }
 
 #[async_trait::async_trait]
 impl CloudStorage for S3CloudStorage {
     async fn upload_chunk(&self, chunk_id: &str, data: &[u8]) -> Result<String, CloudStorageError> {
-        let key = self.chunk_key(chunk_id);
+        let key = chunk_key(chunk_id);
 
         debug!("Uploading chunk {} ({} bytes)", chunk_id, data.len());
 
@@ -298,18 +332,387 @@ impl CloudStorage for S3CloudStorage {
         debug!("Successfully deleted chunk from {}", storage_location);
         Ok(())
     }
+
+    async fn delete_chunks(
+        &self,
+        storage_locations: &[String],
+    ) -> Result<Vec<String>, CloudStorageError> {
+        let prefix = format!("s3://{}/", self.bucket_name);
+        let (key_batches, mut failed) = s3_delete_batches(&prefix, storage_locations);
+
+        for keys in key_batches {
+            let objects = keys
+                .into_iter()
+                .map(|key| {
+                    ObjectIdentifier::builder()
+                        .key(key)
+                        .build()
+                        .map_err(|e| CloudStorageError::SdkError(e.to_string()))
+                })
+                .collect::<Result<Vec<_>, _>>()?;
+
+            debug!("Deleting {} chunks", objects.len());
+
+            let delete = Delete::builder()
+                .set_objects(Some(objects))
+                .quiet(true)
+                .build()
+                .map_err(|e| CloudStorageError::SdkError(e.to_string()))?;
+
+            let response = self
+                .client
+                .delete_objects()
+                .bucket(&self.bucket_name)
+                .delete(delete)
+                .send()
+                .await
+                .map_err(|e| {
+                    CloudStorageError::SdkError(format!("Delete objects failed: {}", e))
+                })?;
+
+            // Quiet mode only reports the keys that failed
+            for error in response.errors() {
+                let key = error.key().unwrap_or_default();
+
+                warn!(
+                    "Failed to delete {}: {}",
+                    key,
+                    error.message().unwrap_or_default()
+                );
+
+                failed.push(format!("{}{}", prefix, key));
+            }
+        }
+
+        Ok(failed)
+    }
+}
+
+/// Chunk storage in a local or network-mounted directory
+///
+/// Chunks live at `<root>/chunks/ab/cd/<chunk_id>.enc`, sharded like S3 keys, and
+/// their storage location is `local://<key>`, so a library survives the directory
+/// being mounted somewhere else. Each upload writes and syncs a temp file and renames
+/// it into place; only the directory syncs that make the renames durable are batched
+/// across concurrent uploads (see `run_dir_sync_flusher`).
+pub struct LocalCloudStorage {
+    root: PathBuf,
+    sync_tx: mpsc::UnboundedSender<PendingDirSync>,
+}
+
+/// A chunk renamed into place, waiting for its directory to be synced
+struct PendingDirSync {
+    dir: PathBuf,
+    done_tx: oneshot::Sender<()>,
+}
+
+impl LocalCloudStorage {
+    /// Use `root` for chunk storage, creating it if needed
+    pub async fn new(root: PathBuf) -> Result<Self, CloudStorageError> {
+        tokio::fs::create_dir_all(root.join("chunks")).await?;
+
+        info!("Using local chunk storage at {}", root.display());
+
+        let (sync_tx, sync_rx) = mpsc::unbounded_channel();
+        tokio::spawn(run_dir_sync_flusher(sync_rx));
+
+        Ok(LocalCloudStorage { root, sync_tx })
+    }
+
+    /// Resolve a `local://` location to a path under the storage root
+    fn chunk_path(&self, storage_location: &str) -> Result<PathBuf, CloudStorageError> {
+        let key = storage_location
+            .strip_prefix("local://")
+            .filter(|key| !key.split('/').any(|part| part == ".." || part.is_empty()))
+            .ok_or_else(|| {
+                CloudStorageError::Download(format!("Invalid local location: {}", storage_location))
+            })?;
+        Ok(self.root.join(key))
+    }
+}
+
+#[async_trait::async_trait]
+impl CloudStorage for LocalCloudStorage {
+    async fn upload_chunk(&self, chunk_id: &str, data: &[u8]) -> Result<String, CloudStorageError> {
+        let key = chunk_key(chunk_id);
+        let final_path = self.root.join(&key);
+        let temp_path = final_path.with_extension("enc.tmp");
+
+        let dir = final_path
+            .parent()
+            .map(Path::to_path_buf)
+            .unwrap_or_else(|| self.root.clone());
+        tokio::fs::create_dir_all(&dir).await?;
+
+        // Each upload syncs its own file, so concurrent uploads sync in parallel
+        let data = data.to_vec();
+        tokio::task::spawn_blocking(move || {
+            let mut file = std::fs::File::create(&temp_path)?;
+            file.write_all(&data)?;
+            file.sync_all()?;
+            std::fs::rename(&temp_path, &final_path)
+        })
+        .await
+        .map_err(|e| CloudStorageError::Io(std::io::Error::other(e)))??;
+
+        let (done_tx, done_rx) = oneshot::channel();
+        self.sync_tx
+            .send(PendingDirSync { dir, done_tx })
+            .map_err(|_| CloudStorageError::Config("Chunk sync flusher stopped".to_string()))?;
+        done_rx
+            .await
+            .map_err(|_| CloudStorageError::Config("Chunk sync flusher stopped".to_string()))?;
+
+        Ok(format!("local://{}", key))
+    }
+
+    async fn download_chunk(&self, storage_location: &str) -> Result<Vec<u8>, CloudStorageError> {
+        let path = self.chunk_path(storage_location)?;
+        let data = tokio::task::spawn_blocking(move || {
+            let file = std::fs::File::open(&path)?;
+            let mut data = vec![0u8; file.metadata()?.len() as usize];
+            read_exact_at(&file, &mut data, 0)?;
+            Ok::<_, std::io::Error>(data)
+        })
+        .await
+        .map_err(|e| CloudStorageError::Download(e.to_string()))??;
+        Ok(data)
+    }
+
+    async fn delete_chunk(&self, storage_location: &str) -> Result<(), CloudStorageError> {
+        let path = self.chunk_path(storage_location)?;
+        match tokio::fs::remove_file(&path).await {
+            Ok(()) => Ok(()),
+            // Already gone counts as deleted, as with S3
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(()),
+            Err(e) => Err(e.into()),
+        }
+    }
+
+    async fn delete_chunks(
+        &self,
+        storage_locations: &[String],
+    ) -> Result<Vec<String>, CloudStorageError> {
+        let mut paths = Vec::with_capacity(storage_locations.len());
+        let mut failed = Vec::new();
+        for storage_location in storage_locations {
+            match self.chunk_path(storage_location) {
+                Ok(path) => paths.push((storage_location.clone(), path)),
+                Err(_) => {
+                    warn!("Invalid local location: {}", storage_location);
+
+                    failed.push(storage_location.clone());
+                }
+            }
+        }
+
+        // One blocking task for the whole batch rather than one per file
+        let batch_failed = tokio::task::spawn_blocking(move || {
+            paths
+                .into_iter()
+                .filter_map(
+                    |(storage_location, path)| match std::fs::remove_file(&path) {
+                        Ok(()) => None,
+                        Err(e) if e.kind() == std::io::ErrorKind::NotFound => None,
+                        Err(e) => {
+                            warn!("Failed to delete {}: {}", path.display(), e);
+
+                            Some(storage_location)
+                        }
+                    },
+                )
+                .collect::<Vec<_>>()
+        })
+        .await
+        .map_err(|e| CloudStorageError::Download(e.to_string()))?;
+
+        failed.extend(batch_failed);
+        Ok(failed)
+    }
+}
+
+/// Make renamed chunks durable, sharing directory syncs between uploads that finish together
+///
+/// Uploads queued while a batch is syncing form the next batch, so a burst of
+/// uploads pays for one sync per shard directory rather than one per chunk.
+async fn run_dir_sync_flusher(mut sync_rx: mpsc::UnboundedReceiver<PendingDirSync>) {
+    while let Some(first) = sync_rx.recv().await {
+        let mut batch = vec![first];
+        while batch.len() < MAX_SYNC_BATCH {
+            match sync_rx.try_recv() {
+                Ok(pending) => batch.push(pending),
+                Err(_) => break,
+            }
+        }
+
+        let result = tokio::task::spawn_blocking(move || {
+            let dirs: HashSet<&Path> = batch.iter().map(|pending| pending.dir.as_path()).collect();
+            for dir in dirs {
+                if let Err(e) = sync_dir(dir) {
+                    warn!("Failed to sync directory {}: {}", dir.display(), e);
+                }
+            }
+            batch
+        })
+        .await;
+
+        match result {
+            Ok(batch) => {
+                for pending in batch {
+                    let _ = pending.done_tx.send(());
+                }
+            }
+            Err(e) => error!("Chunk directory sync batch failed: {}", e),
+        }
+    }
+}
+
+/// Sync a directory so the renames into it are durable
+#[cfg(unix)]
+fn sync_dir(dir: &Path) -> std::io::Result<()> {
+    std::fs::File::open(dir)?.sync_all()
+}
+
+/// Directories can't be synced on Windows; a rename is durable once the file is
+#[cfg(not(unix))]
+fn sync_dir(_dir: &Path) -> std::io::Result<()> {
+    Ok(())
+}
+
+/// Read at an offset with a positional read rather than seek + read
+#[cfg(unix)]
+fn read_exact_at(file: &std::fs::File, buf: &mut [u8], offset: u64) -> std::io::Result<()> {
+    use std::os::unix::fs::FileExt;
+    file.read_exact_at(buf, offset)
+}
+
+#[cfg(windows)]
+fn read_exact_at(file: &std::fs::File, mut buf: &mut [u8], mut offset: u64) -> std::io::Result<()> {
+    use std::os::windows::fs::FileExt;
+    while !buf.is_empty() {
+        match file.seek_read(buf, offset)? {
+            0 => return Err(std::io::ErrorKind::UnexpectedEof.into()),
+            n => {
+                buf = &mut buf[n..];
+                offset += n as u64;
+            }
+        }
+    }
+    Ok(())
+}
+
+/// Object key for a chunk using hash-based partitioning, shared by all backends
+/// Example: chunk_abcd1234-5678-9abc-def0-123456789abc -> chunks/ab/cd/chunk_abcd1234-5678-9abc-def0-123456789abc.enc
+fn chunk_key(chunk_id: &str) -> String {
+    if chunk_id.len() < 4 {
+        // Fallback for malformed chunk IDs
+        return format!("chunks/misc/{}.enc", chunk_id);
+    }
+
+    let prefix = &chunk_id[..2]; // First 2 chars: "ab"
+    let subprefix = &chunk_id[2..4]; // Next 2 chars: "cd"
+    format!("chunks/{}/{}/{}.enc", prefix, subprefix, chunk_id)
+}
+
+/// Split S3 locations into object keys for DeleteObjects requests of at most
+/// `DELETE_BATCH_SIZE` keys, plus the locations outside the bucket
+fn s3_delete_batches<'a>(
+    prefix: &str,
+    storage_locations: &'a [String],
+) -> (Vec<Vec<&'a str>>, Vec<String>) {
+    let mut keys = Vec::with_capacity(storage_locations.len());
+    let mut invalid = Vec::new();
+    for storage_location in storage_locations {
+        match storage_location.strip_prefix(prefix) {
+            Some(key) => keys.push(key),
+            None => {
+                warn!("Invalid S3 location: {}", storage_location);
+
+                invalid.push(storage_location.clone());
+            }
+        }
+    }
+
+    let batches = keys
+        .chunks(DELETE_BATCH_SIZE)
+        .map(<[&str]>::to_vec)
+        .collect();
+    (batches, invalid)
+}
+
+/// Chunk ID of a storage location. Chunk objects are named `<chunk_id>.enc`,
+/// the same as cache files, which is what LAN peers look chunks up by.
+fn chunk_id_from_location(storage_location: &str) -> Option<&str> {
+    storage_location.rsplit('/').next()?.strip_suffix(".enc")
+}
+
+/// Progress of a background chunk deletion job
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct DeleteProgress {
+    pub total: usize,
+    pub deleted: usize,
+    pub failed: usize,
+}
+
+impl DeleteProgress {
+    pub fn is_finished(&self) -> bool {
+        self.deleted + self.failed >= self.total
+    }
+}
+
+/// Handle to a background chunk deletion started by `CloudStorageManager::spawn_delete_chunks`
+///
+/// Dropping the handle does not cancel the job.
+#[derive(Debug, Clone)]
+pub struct DeleteJob {
+    progress_rx: watch::Receiver<DeleteProgress>,
+}
+
+impl DeleteJob {
+    /// Current progress snapshot
+    pub fn progress(&self) -> DeleteProgress {
+        *self.progress_rx.borrow()
+    }
+
+    /// Subscribe to progress updates
+    pub fn subscribe(&self) -> watch::Receiver<DeleteProgress> {
+        self.progress_rx.clone()
+    }
+
+    /// Wait for the job to finish and return its final progress
+    pub async fn wait(mut self) -> DeleteProgress {
+        // Err means the job task is gone; report whatever it got through
+        let _ = self.progress_rx.wait_for(DeleteProgress::is_finished).await;
+        self.progress()
+    }
+
+    /// Call `on_progress` with each progress update until the job finishes, then
+    /// return its final progress
+    pub async fn follow(mut self, mut on_progress: impl FnMut(DeleteProgress)) -> DeleteProgress {
+        loop {
+            let progress = *self.progress_rx.borrow_and_update();
+            on_progress(progress);
+            // Err means the job task is gone; report whatever it got through
+            if progress.is_finished() || self.progress_rx.changed().await.is_err() {
+                return progress;
+            }
+        }
+    }
 }
 
 /// Cloud storage manager that handles chunk lifecycle
 #[derive(Clone)]
 pub struct CloudStorageManager {
     storage: std::sync::Arc<dyn CloudStorage>,
+    /// Nodes on the local network asked for chunks before the bucket
+    lan_peers: Option<LanPeers>,
 }
 
 impl std::fmt::Debug for CloudStorageManager {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.debug_struct("CloudStorageManager")
             .field("storage", &"<dyn CloudStorage>")
+            .field("lan_peers", &self.lan_peers.is_some())
             .finish()
     }
 }
@@ -320,6 +723,46 @@ impl CloudStorageManager {
         let storage = S3CloudStorage::new(config).await?;
         Ok(CloudStorageManager {
             storage: std::sync::Arc::new(storage),
+            lan_peers: None,
+        })
+    }
+
+    /// Create an S3 cloud storage manager without waiting for the bucket check
+    ///
+    /// The check runs in the background so startup doesn't wait on the network.
+    /// Transfers fail until the bucket is reachable, and a failed check is logged.
+    pub async fn new_with_background_bucket_check(
+        config: S3Config,
+    ) -> Result<Self, CloudStorageError> {
+        let endpoint_url = config.endpoint_url.clone();
+        let storage = S3CloudStorage::new_with_bucket_creation(config, false).await?;
+
+        let client = storage.client.clone();
+        let bucket_name = storage.bucket_name.clone();
+        tokio::spawn(async move {
+            if let Err(e) = ensure_bucket(&client, &bucket_name, endpoint_url.as_deref()).await {
+                error!("Bucket check failed: {}", e);
+            }
+        });
+
+        Ok(CloudStorageManager {
+            storage: std::sync::Arc::new(storage),
+            lan_peers: None,
+        })
+    }
+
+    /// Try these LAN peers for a chunk before downloading it from the bucket
+    pub fn with_lan_peers(mut self, lan_peers: LanPeers) -> Self {
+        self.lan_peers = Some(lan_peers);
+        self
+    }
+
+    /// Create a cloud storage manager that keeps chunks in a local or mounted directory
+    pub async fn new_local(root: PathBuf) -> Result<Self, CloudStorageError> {
+        let storage = LocalCloudStorage::new(root).await?;
+        Ok(CloudStorageManager {
+            storage: std::sync::Arc::new(storage),
+            lan_peers: None,
         })
     }
 
@@ -327,7 +770,10 @@ impl CloudStorageManager {
     #[cfg(feature = "test-utils")]
     #[allow(unused)] // Used in tests
     pub fn from_storage(storage: std::sync::Arc<dyn CloudStorage>) -> Self {
-        CloudStorageManager { storage }
+        CloudStorageManager {
+            storage,
+            lan_peers: None,
+        }
     }
 
     /// Upload chunk data directly from memory
@@ -339,11 +785,21 @@ impl CloudStorageManager {
         self.storage.upload_chunk(chunk_id, data).await
     }
 
-    /// Download chunk data from cloud storage
+    /// Download chunk data, from a LAN peer's cache if one has it, else from cloud storage
+    ///
+    /// LAN peers only return chunks that pass authenticated decryption, so a peer
+    /// serving bad bytes falls through to the bucket like a miss.
     pub async fn download_chunk(
         &self,
         storage_location: &str,
     ) -> Result<Vec<u8>, CloudStorageError> {
+        if let (Some(lan_peers), Some(chunk_id)) =
+            (&self.lan_peers, chunk_id_from_location(storage_location))
+        {
+            if let Some(data) = lan_peers.fetch_chunk(chunk_id).await {
+                return Ok(data);
+            }
+        }
         self.storage.download_chunk(storage_location).await
     }
 
@@ -351,4 +807,214 @@ impl CloudStorageManager {
     pub async fn delete_chunk(&self, storage_location: &str) -> Result<(), CloudStorageError> {
         self.storage.delete_chunk(storage_location).await
     }
+
+    /// Delete many chunks in the background
+    ///
+    /// Locations are split into bulk-delete batches that run with bounded
+    /// concurrency. After each batch, `on_deleted` gets the locations that are
+    /// gone before the job's progress counts them. Failures are logged and
+    /// counted in the job's progress.
+    pub fn spawn_delete_chunks<F, Fut>(
+        &self,
+        storage_locations: Vec<String>,
+        on_deleted: F,
+    ) -> DeleteJob
+    where
+        F: Fn(Vec<String>) -> Fut + Send + 'static,
+        Fut: Future<Output = ()> + Send + 'static,
+    {
+        let (progress_tx, progress_rx) = watch::channel(DeleteProgress {
+            total: storage_locations.len(),
+            ..Default::default()
+        });
+        let storage = self.storage.clone();
+
+        tokio::spawn(async move {
+            let batches: Vec<Vec<String>> = storage_locations
+                .chunks(DELETE_BATCH_SIZE)
+                .map(<[String]>::to_vec)
+                .collect();
+
+            let mut results = stream::iter(batches)
+                .map(|batch| {
+                    let storage = storage.clone();
+                    async move {
+                        let result = storage.delete_chunks(&batch).await;
+                        (batch, result)
+                    }
+                })
+                .buffer_unordered(MAX_CONCURRENT_DELETE_BATCHES);
+
+            while let Some((batch, result)) = results.next().await {
+                let batch_len = batch.len();
+                let deleted: Vec<String> = match result {
+                    Ok(failed) => {
+                        let failed: HashSet<String> = failed.into_iter().collect();
+                        batch
+                            .into_iter()
+                            .filter(|location| !failed.contains(location))
+                            .collect()
+                    }
+                    Err(e) => {
+                        warn!("Failed to delete batch of {} chunks: {}", batch_len, e);
+
+                        Vec::new()
+                    }
+                };
+                let deleted_len = deleted.len();
+                if deleted_len > 0 {
+                    on_deleted(deleted).await;
+                }
+                progress_tx.send_modify(|progress| {
+                    progress.deleted += deleted_len;
+                    progress.failed += batch_len - deleted_len;
+                });
+            }
+
+            let progress = *progress_tx.borrow();
+            info!(
+                "Chunk deletion finished: {} deleted, {} failed",
+                progress.deleted, progress.failed
+            );
+        });
+
+        DeleteJob { progress_rx }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[tokio::test]
+    async fn test_local_storage_roundtrip() {
+        let temp_dir = tempfile::tempdir().unwrap();
+        let storage = LocalCloudStorage::new(temp_dir.path().to_path_buf())
+            .await
+            .unwrap();
+
+        // Concurrent uploads share sync batches
+        let uploads = (0..8).map(|i| {
+            let storage = &storage;
+            async move {
+                let chunk_id = format!("abcd{}", i);
+                storage.upload_chunk(&chunk_id, &[i as u8; 64]).await
+            }
+        });
+        let locations: Vec<String> = futures::future::try_join_all(uploads).await.unwrap();
+        assert_eq!(locations[3], "local://chunks/ab/cd/abcd3.enc");
+        assert_eq!(chunk_id_from_location(&locations[3]), Some("abcd3"));
+
+        assert_eq!(
+            storage.download_chunk(&locations[3]).await.unwrap(),
+            vec![3u8; 64]
+        );
+        assert!(storage
+            .download_chunk("local://chunks/../../etc/passwd")
+            .await
+            .is_err());
+
+        let mut to_delete = locations[..4].to_vec();
+        to_delete.push("local://chunks/ab/cd/missing.enc".to_string());
+        assert!(storage.delete_chunks(&to_delete).await.unwrap().is_empty());
+        assert!(storage.download_chunk(&locations[0]).await.is_err());
+        assert!(storage.download_chunk(&locations[4]).await.is_ok());
+    }
+
+    /// Records the size of every delete batch and fails locations ending in "fail"
+    #[derive(Default)]
+    struct BatchRecordingStorage {
+        batch_sizes: std::sync::Mutex<Vec<usize>>,
+    }
+
+    #[async_trait::async_trait]
+    impl CloudStorage for BatchRecordingStorage {
+        async fn upload_chunk(
+            &self,
+            chunk_id: &str,
+            _: &[u8],
+        ) -> Result<String, CloudStorageError> {
+            Ok(chunk_id.to_string())
+        }
+
+        async fn download_chunk(&self, _: &str) -> Result<Vec<u8>, CloudStorageError> {
+            Ok(Vec::new())
+        }
+
+        async fn delete_chunk(&self, _: &str) -> Result<(), CloudStorageError> {
+            Ok(())
+        }
+
+        async fn delete_chunks(
+            &self,
+            storage_locations: &[String],
+        ) -> Result<Vec<String>, CloudStorageError> {
+            self.batch_sizes
+                .lock()
+                .unwrap()
+                .push(storage_locations.len());
+            Ok(storage_locations
+                .iter()
+                .filter(|location| location.ends_with("fail"))
+                .cloned()
+                .collect())
+        }
+    }
+
+    #[test]
+    fn test_s3_delete_batches_split_at_batch_size() {
+        let prefix = "s3://bucket/";
+        let mut locations: Vec<String> = (0..DELETE_BATCH_SIZE * 2 + 1)
+            .map(|i| format!("{}chunks/{}.enc", prefix, i))
+            .collect();
+        locations.push("s3://other-bucket/chunks/x.enc".to_string());
+
+        let (batches, invalid) = s3_delete_batches(prefix, &locations);
+
+        let batch_sizes: Vec<usize> = batches.iter().map(Vec::len).collect();
+        assert_eq!(batch_sizes, vec![DELETE_BATCH_SIZE, DELETE_BATCH_SIZE, 1]);
+        assert_eq!(batches[1][0], format!("chunks/{}.enc", DELETE_BATCH_SIZE));
+        assert_eq!(invalid, vec!["s3://other-bucket/chunks/x.enc".to_string()]);
+    }
+
+    #[tokio::test]
+    async fn test_delete_job_counts_deleted_and_failed_chunks() {
+        let storage = std::sync::Arc::new(BatchRecordingStorage::default());
+        let manager = CloudStorageManager {
+            storage: storage.clone(),
+            lan_peers: None,
+        };
+        let locations: Vec<String> = (0..DELETE_BATCH_SIZE * 2 + 500)
+            .map(|i| {
+                if i % 1000 == 7 {
+                    format!("{}-fail", i)
+                } else {
+                    i.to_string()
+                }
+            })
+            .collect();
+
+        let reported = std::sync::Arc::new(std::sync::Mutex::new(Vec::new()));
+        let reported_by_job = reported.clone();
+        let job = manager.spawn_delete_chunks(locations, move |deleted| {
+            reported_by_job.lock().unwrap().extend(deleted);
+            async {}
+        });
+        let progress = job.wait().await;
+
+        assert_eq!(
+            progress,
+            DeleteProgress {
+                total: DELETE_BATCH_SIZE * 2 + 500,
+                deleted: DELETE_BATCH_SIZE * 2 + 497,
+                failed: 3,
+            }
+        );
+        let mut batch_sizes = storage.batch_sizes.lock().unwrap().clone();
+        batch_sizes.sort();
+        assert_eq!(batch_sizes, vec![500, DELETE_BATCH_SIZE, DELETE_BATCH_SIZE]);
+        let reported = reported.lock().unwrap();
+        assert_eq!(reported.len(), progress.deleted);
+        assert!(!reported.iter().any(|location| location.ends_with("fail")));
+    }
 }
@@ -1,4 +1,5 @@
-use std::path::PathBuf;
+use serde::Deserialize;
+use std::path::{Path, PathBuf};
 use tracing::{info, warn};
 
 use thiserror::Error;
@@ -25,18 +26,71 @@ pub struct Config {
     pub discogs_api_key: String,
     /// S3 configuration
     pub s3_config: crate::cloud_storage::S3Config,
+    /// Local or mounted directory to keep chunks in instead of S3 (optional)
+    pub storage_path: Option<PathBuf>,
     /// Encryption key (hex-encoded 256-bit key)
     pub encryption_key: String,
+    /// Cipher new chunks are encrypted with (default: AES-256-GCM if the CPU accelerates it)
+    pub chunk_cipher: crate::encryption::ChunkCipher,
     /// Number of parallel encryption workers for import (CPU-bound)
     pub max_import_encrypt_workers: usize,
     /// Number of parallel upload workers for import (I/O-bound)
     pub max_import_upload_workers: usize,
     /// Number of parallel DB write workers for import (I/O-bound)
     pub max_import_db_write_workers: usize,
-    /// Size of each chunk in bytes (default: 1MB)
-    pub chunk_size_bytes: usize,
+    /// Smallest chunk size chosen for a release, in bytes (default: 256KB)
+    pub min_chunk_size_bytes: usize,
+    /// Largest chunk size chosen for a release, in bytes (default: 16MB)
+    pub max_chunk_size_bytes: usize,
+    /// How imported files are laid out in chunks (default: contiguous)
+    pub chunk_layout: crate::import::ChunkLayoutMode,
     /// Network interface to bind torrent clients to (optional, e.g. "eth0", "tun0", "0.0.0.0:6881")
     pub torrent_bind_interface: Option<String>,
+    /// Local disk budget for chunks fetched from the cloud while seeding (default: 1GB)
+    pub seed_cache_max_bytes: u64,
+    /// Part of the seed cache kept pinned for the most requested chunks, at most half of it
+    /// (default: 512MB)
+    pub seed_pin_max_bytes: u64,
+    /// Max seeding releases the torrent session keeps running at once (default: 100)
+    pub torrent_active_seeds: i32,
+    /// Max torrents the torrent session keeps running at once (default: 120)
+    pub torrent_active_limit: i32,
+    /// Chunk sharing with other nodes on the local network (off unless a token is set)
+    pub lan_peers: Option<crate::lan_peers::LanPeerConfig>,
+    /// Memory shared by import, playback and export buffers (default: 1GB)
+    pub memory_budget_bytes: u64,
+}
+
+/// Settings read from ~/.bae/config.yaml (production mode only)
+///
+/// Every key is optional; a missing file or key leaves the default.
+#[derive(Debug, Default, Deserialize)]
+#[serde(default)]
+struct ConfigFile {
+    /// Chunk sharing with other nodes on the local network (off unless a token is set)
+    lan_peers: Option<crate::lan_peers::LanPeerConfig>,
+    /// Local or mounted directory to keep chunks in instead of S3
+    storage_path: Option<PathBuf>,
+    /// Cipher new chunks are encrypted with (`aes-256-gcm` or `chacha20-poly1305`)
+    chunk_cipher: Option<crate::encryption::ChunkCipher>,
+}
+
+impl ConfigFile {
+    fn load(path: &Path) -> Result<Self, ConfigError> {
+        match std::fs::read_to_string(path) {
+            Ok(yaml) => serde_yaml::from_str(&yaml)
+                .map_err(|e| ConfigError::Serialization(format!("{}: {}", path.display(), e))),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => {
+                info!("No {} found, using defaults", path.display());
+                Ok(Self::default())
+            }
+            Err(e) => Err(ConfigError::Config(format!(
+                "Failed to read {}: {}",
+                path.display(),
+                e
+            ))),
+        }
+    }
 }
 
 /// Credential data loaded from keyring (production mode only)
@@ -85,15 +139,22 @@ impl Config {
         let discogs_api_key = std::env::var("BAE_DISCOGS_API_KEY")
             .expect("BAE_DISCOGS_API_KEY must be set in .env for dev mode");
 
-        // Build S3 config from environment variables
-        let bucket_name =
-            std::env::var("BAE_S3_BUCKET").expect("BAE_S3_BUCKET must be set in .env for dev mode");
-        let region =
-            std::env::var("BAE_S3_REGION").expect("BAE_S3_REGION must be set in .env for dev mode");
-        let access_key_id = std::env::var("BAE_S3_ACCESS_KEY")
-            .expect("BAE_S3_ACCESS_KEY must be set in .env for dev mode");
-        let secret_access_key = std::env::var("BAE_S3_SECRET_KEY")
-            .expect("BAE_S3_SECRET_KEY must be set in .env for dev mode");
+        // Chunks go to a local directory instead of S3 if one is set
+        let storage_path = std::env::var("BAE_STORAGE_PATH")
+            .ok()
+            .filter(|s| !s.is_empty())
+            .map(PathBuf::from);
+
+        // Build S3 config from environment variables (not needed with local storage)
+        let s3_var = |name: &str| match std::env::var(name) {
+            Ok(value) => value,
+            Err(_) if storage_path.is_some() => String::new(),
+            Err(_) => panic!("{} must be set in .env for dev mode", name),
+        };
+        let bucket_name = s3_var("BAE_S3_BUCKET");
+        let region = s3_var("BAE_S3_REGION");
+        let access_key_id = s3_var("BAE_S3_ACCESS_KEY");
+        let secret_access_key = s3_var("BAE_S3_SECRET_KEY");
         let endpoint_url = std::env::var("BAE_S3_ENDPOINT")
             .ok()
             .map(|s| s.trim().to_string())
@@ -135,46 +196,178 @@ impl Config {
             .and_then(|s| s.parse().ok())
             .unwrap_or(10);
 
-        let chunk_size_bytes = std::env::var("BAE_CHUNK_SIZE_BYTES")
+        let min_chunk_size_bytes = std::env::var("BAE_MIN_CHUNK_SIZE_BYTES")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(256 * 1024); // 256KB default
+
+        let max_chunk_size_bytes = std::env::var("BAE_MAX_CHUNK_SIZE_BYTES")
             .ok()
             .and_then(|s| s.parse().ok())
-            .unwrap_or(1024 * 1024); // 1MB default
+            .unwrap_or(16 * 1024 * 1024); // 16MB default
+
+        // Chunk sizes are chosen between these bounds; inverted ones would silently
+        // ignore the maximum
+        if min_chunk_size_bytes > max_chunk_size_bytes {
+            panic!(
+                "BAE_MIN_CHUNK_SIZE_BYTES ({}) must not exceed BAE_MAX_CHUNK_SIZE_BYTES ({})",
+                min_chunk_size_bytes, max_chunk_size_bytes
+            );
+        }
+
+        let chunk_cipher = match std::env::var("BAE_CHUNK_CIPHER").as_deref() {
+            Ok("aes-256-gcm") => crate::encryption::ChunkCipher::Aes256Gcm,
+            Ok("chacha20-poly1305") => crate::encryption::ChunkCipher::ChaCha20Poly1305,
+            _ => crate::encryption::ChunkCipher::detect(),
+        };
+
+        let chunk_layout = match std::env::var("BAE_ALIGN_TRACKS_TO_CHUNKS").as_deref() {
+            Ok("1") | Ok("true") => crate::import::ChunkLayoutMode::TrackAligned,
+            _ => crate::import::ChunkLayoutMode::Contiguous,
+        };
 
         let torrent_bind_interface = std::env::var("BAE_TORRENT_BIND_INTERFACE")
             .ok()
             .filter(|s| !s.is_empty());
 
-        info!("Dev mode with S3 storage");
-        info!("S3 bucket: {}", bucket_name);
-        if let Some(endpoint) = &endpoint_url {
-            info!("S3 endpoint: {}", endpoint);
+        let seed_cache_max_bytes = std::env::var("BAE_SEED_CACHE_MAX_BYTES")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(1024 * 1024 * 1024); // 1GB default
+
+        let seed_pin_max_bytes = std::env::var("BAE_SEED_PIN_MAX_BYTES")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(512 * 1024 * 1024); // 512MB default
+
+        // Pinned chunks are never evicted, so leave at least half the seed cache for
+        // chunks fetched on demand or it could grow past its budget
+        let seed_pin_max_bytes = if seed_pin_max_bytes > seed_cache_max_bytes / 2 {
+            warn!(
+                "BAE_SEED_PIN_MAX_BYTES ({}) exceeds half the seed cache, using {} bytes",
+                seed_pin_max_bytes,
+                seed_cache_max_bytes / 2
+            );
+            seed_cache_max_bytes / 2
+        } else {
+            seed_pin_max_bytes
+        };
+
+        let torrent_active_seeds = std::env::var("BAE_TORRENT_ACTIVE_SEEDS")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(100);
+
+        let torrent_active_limit = std::env::var("BAE_TORRENT_ACTIVE_LIMIT")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(120);
+
+        let lan_peers = std::env::var("BAE_LAN_PEER_TOKEN")
+            .ok()
+            .filter(|s| !s.is_empty())
+            .map(|token| crate::lan_peers::LanPeerConfig {
+                port: std::env::var("BAE_LAN_PEER_PORT")
+                    .ok()
+                    .and_then(|s| s.parse().ok())
+                    .unwrap_or(crate::lan_peers::DEFAULT_PORT),
+                token,
+                static_peers: std::env::var("BAE_LAN_PEERS")
+                    .unwrap_or_default()
+                    .split(',')
+                    .map(str::trim)
+                    .filter(|s| !s.is_empty())
+                    .filter_map(|peer| match peer.parse() {
+                        Ok(addr) => Some(addr),
+                        Err(_) => {
+                            warn!("Ignoring invalid LAN peer address: {}", peer);
+                            None
+                        }
+                    })
+                    .collect(),
+                discovery: !matches!(
+                    std::env::var("BAE_LAN_PEER_DISCOVERY").as_deref(),
+                    Ok("0") | Ok("false")
+                ),
+            });
+
+        let memory_budget_bytes = std::env::var("BAE_MEMORY_BUDGET_BYTES")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(1024 * 1024 * 1024); // 1GB default
+
+        if let Some(path) = &storage_path {
+            info!("Dev mode with local storage at {}", path.display());
+        } else {
+            info!("Dev mode with S3 storage");
+            info!("S3 bucket: {}", bucket_name);
+            if let Some(endpoint) = &endpoint_url {
+                info!("S3 endpoint: {}", endpoint);
+            }
         }
         info!(
             "Import worker pools - encrypt: {}, upload: {}, db_write: {}",
             max_import_encrypt_workers, max_import_upload_workers, max_import_db_write_workers
         );
-        info!("Chunk size: {} bytes", chunk_size_bytes);
+        info!(
+            "Chunk size: {} to {} bytes per release",
+            min_chunk_size_bytes, max_chunk_size_bytes
+        );
+        info!("Chunk cipher: {:?}", chunk_cipher);
+        info!("Chunk layout: {:?}", chunk_layout);
+        info!(
+            "Seed cache budget: {} bytes ({} pinned)",
+            seed_cache_max_bytes, seed_pin_max_bytes
+        );
+        info!("Memory budget: {} bytes", memory_budget_bytes);
+        info!(
+            "Torrent queue: {} active seeds, {} active torrents",
+            torrent_active_seeds, torrent_active_limit
+        );
+        if let Some(lan_peers) = &lan_peers {
+            info!(
+                "LAN chunk sharing on port {} ({} static peers, discovery: {})",
+                lan_peers.port,
+                lan_peers.static_peers.len(),
+                lan_peers.discovery
+            );
+        }
 
         Self {
             library_id,
             discogs_api_key,
             s3_config,
+            storage_path,
             encryption_key,
-            chunk_size_bytes,
+            chunk_cipher,
+            min_chunk_size_bytes,
+            max_chunk_size_bytes,
+            chunk_layout,
             max_import_encrypt_workers,
             max_import_upload_workers,
             max_import_db_write_workers,
             torrent_bind_interface,
+            seed_cache_max_bytes,
+            seed_pin_max_bytes,
+            torrent_active_seeds,
+            torrent_active_limit,
+            lan_peers,
+            memory_budget_bytes,
         }
     }
 
     /// Load configuration from config.yaml + keyring (production mode)
     fn from_config_file() -> Self {
-        // TODO: Implement config.yaml loading
-        info!("Production mode - loading from config.yaml (not implemented yet)");
+        // Settings not in config.yaml yet keep their defaults (see the TODOs below)
+        let config_path = dirs::home_dir()
+            .expect("Failed to get home directory")
+            .join(".bae")
+            .join("config.yaml");
+        let config_file = ConfigFile::load(&config_path).expect("Invalid config.yaml");
+        let storage_path = config_file.storage_path;
 
         // Load from keyring
-        let credentials = Self::load_from_keyring()
+        let credentials = Self::load_from_keyring(storage_path.is_none())
             .expect("Failed to load credentials from keyring - run setup wizard first");
 
         // TODO: Load library_id from config.yaml
@@ -190,19 +383,42 @@ impl Config {
             .unwrap_or(4);
         let max_import_upload_workers = 20;
         let max_import_db_write_workers = 10;
-        let chunk_size_bytes = 1024 * 1024; // 1MB default
+        let min_chunk_size_bytes = 256 * 1024; // 256KB default
+        let max_chunk_size_bytes = 16 * 1024 * 1024; // 16MB default
+        let chunk_cipher = config_file
+            .chunk_cipher
+            .unwrap_or_else(crate::encryption::ChunkCipher::detect);
+        let chunk_layout = crate::import::ChunkLayoutMode::default();
         let torrent_bind_interface = None; // TODO: Load from config.yaml
+        let seed_cache_max_bytes = 1024 * 1024 * 1024; // 1GB default
+        let seed_pin_max_bytes = 512 * 1024 * 1024; // 512MB default
+        let torrent_active_seeds = 100;
+        let torrent_active_limit = 120;
+        let lan_peers = config_file
+            .lan_peers
+            .filter(|lan_peers| !lan_peers.token.is_empty());
+        let memory_budget_bytes = 1024 * 1024 * 1024; // 1GB default
 
         Self {
             library_id,
             discogs_api_key: credentials.discogs_api_key,
             s3_config: credentials.s3_config,
+            storage_path,
             encryption_key: credentials.encryption_key,
+            chunk_cipher,
             max_import_encrypt_workers,
             max_import_upload_workers,
             max_import_db_write_workers,
-            chunk_size_bytes,
+            min_chunk_size_bytes,
+            max_chunk_size_bytes,
+            chunk_layout,
             torrent_bind_interface,
+            seed_cache_max_bytes,
+            seed_pin_max_bytes,
+            torrent_active_seeds,
+            torrent_active_limit,
+            lan_peers,
+            memory_budget_bytes,
         }
     }
 
@@ -215,7 +431,9 @@ impl Config {
     }
 
     /// Load credentials from keyring (production mode only)
-    fn load_from_keyring() -> Result<CredentialData, ConfigError> {
+    ///
+    /// S3 credentials may be missing when chunks are kept in a local directory.
+    fn load_from_keyring(s3_required: bool) -> Result<CredentialData, ConfigError> {
         use keyring::Entry;
 
         info!("Loading credentials from keyring (password may be required)...");
@@ -237,7 +455,7 @@ impl Config {
             Err(e) => return Err(ConfigError::Keyring(e)),
         };
 
-        // Load S3 config (required)
+        // Load S3 config (required unless chunks are stored locally)
         let s3_config = match Entry::new("bae", "s3_config") {
             Ok(entry) => match entry.get_password() {
                 Ok(json) => {
@@ -246,6 +464,13 @@ impl Config {
                     info!("Loaded S3 configuration");
                     config
                 }
+                Err(keyring::Error::NoEntry) if !s3_required => crate::cloud_storage::S3Config {
+                    bucket_name: String::new(),
+                    region: String::new(),
+                    access_key_id: String::new(),
+                    secret_access_key: String::new(),
+                    endpoint_url: None,
+                },
                 Err(keyring::Error::NoEntry) => {
                     return Err(ConfigError::Config(
                         "No S3 configuration found - run setup wizard first".to_string(),
@@ -1,5 +1,8 @@
 use chrono::{DateTime, Utc};
-use sqlx::{Row, SqlitePool};
+use sqlx::sqlite::{SqliteConnectOptions, SqliteJournalMode, SqlitePoolOptions, SqliteSynchronous};
+use sqlx::{QueryBuilder, Row, Sqlite, SqliteConnection, SqlitePool};
+use std::collections::HashMap;
+use std::time::Duration;
 use tracing::info;
 use uuid::Uuid;
 
@@ -8,26 +11,86 @@ use crate::db::models::*;
 // String constants for SQL DEFAULT clauses (keep in sync with as_str())
 const IMPORT_STATUS_QUEUED: &str = "queued";
 
+/// How long a connection waits on a locked database before failing with SQLITE_BUSY
+const BUSY_TIMEOUT: Duration = Duration::from_secs(5);
+
+/// Page cache per connection, in KiB (negative values are KiB in SQLite)
+const CACHE_SIZE_KIB: &str = "-16384";
+
+/// Memory-mapped I/O window for readers (256 MiB)
+const MMAP_SIZE_BYTES: &str = "268435456";
+
+/// Prepared statements kept per connection
+const STATEMENT_CACHE_CAPACITY: usize = 256;
+
+/// Read-only connections available for concurrent queries
+const MAX_READER_CONNECTIONS: u32 = 8;
+
+/// Bound parameters allowed per statement (SQLITE_MAX_VARIABLE_NUMBER of the bundled SQLite)
+const MAX_BIND_PARAMS: usize = 32766;
+
+/// Rows that fit in one multi-row INSERT for a table with `columns` bound columns
+fn rows_per_statement(columns: usize) -> usize {
+    MAX_BIND_PARAMS / columns
+}
+
+/// SQLite handle split into a single writer and a pool of readers.
+///
+/// The database runs in WAL mode so readers never block on the writer. All
+/// writes go through one connection, which turns lock contention between
+/// concurrent writers into a FIFO wait on the pool instead of SQLITE_BUSY
+/// retries. Reads use a separate read-only pool.
 #[derive(Debug, Clone)]
 pub struct Database {
-    pool: SqlitePool,
+    writer: SqlitePool,
+    reader: SqlitePool,
 }
 
 impl Database {
     /// Initialize database connection and create tables
     pub async fn new(database_path: &str) -> Result<Self, sqlx::Error> {
-        // Use sqlite:// with ?mode=rwc to create if it doesn't exist
-        let database_url = format!("sqlite://{}?mode=rwc", database_path);
-        info!("Connecting to {}", database_url);
-        let pool = SqlitePool::connect(&database_url).await?;
+        info!("Connecting to sqlite://{}", database_path);
+
+        let base_options = SqliteConnectOptions::new()
+            .filename(database_path)
+            .journal_mode(SqliteJournalMode::Wal)
+            .synchronous(SqliteSynchronous::Normal)
+            .busy_timeout(BUSY_TIMEOUT)
+            .foreign_keys(true)
+            .pragma("cache_size", CACHE_SIZE_KIB)
+            .pragma("temp_store", "memory")
+            .statement_cache_capacity(STATEMENT_CACHE_CAPACITY);
+
+        // The writer creates the file and switches it to WAL before any reader opens it
+        let writer = SqlitePoolOptions::new()
+            .max_connections(1)
+            .connect_with(base_options.clone().create_if_missing(true))
+            .await?;
 
-        let db = Database { pool };
+        let db = Database {
+            reader: writer.clone(),
+            writer,
+        };
         db.create_tables().await?;
-        Ok(db)
+
+        let reader = SqlitePoolOptions::new()
+            .max_connections(MAX_READER_CONNECTIONS)
+            .connect_with(
+                base_options
+                    .read_only(true)
+                    .pragma("mmap_size", MMAP_SIZE_BYTES),
+            )
+            .await?;
+
+        Ok(Database { reader, ..db })
     }
 
     /// Create all necessary tables
+    ///
+    /// Runs as one transaction so startup pays for a single commit, not one per statement.
     async fn create_tables(&self) -> Result<(), sqlx::Error> {
+        let mut tx = self.writer.begin().await?;
+
         // Artists table
         sqlx::query(
             r#"
@@ -42,7 +105,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Albums table (logical albums)
@@ -60,7 +123,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Album-Discogs join table (one-to-one relationship)
@@ -75,7 +138,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Album-MusicBrainz join table (one-to-one relationship)
@@ -90,7 +153,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Album-Artist junction table
@@ -107,7 +170,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Releases table (specific versions/pressings of albums)
@@ -125,6 +188,7 @@ impl Database {
                 catalog_number TEXT,
                 country TEXT,
                 barcode TEXT,
+                chunk_size_bytes INTEGER,
                 import_status TEXT NOT NULL DEFAULT '{}',
                 created_at TEXT NOT NULL,
                 updated_at TEXT NOT NULL,
@@ -135,7 +199,7 @@ impl Database {
             "#,
             IMPORT_STATUS_QUEUED
         ))
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Tracks table
@@ -156,7 +220,7 @@ impl Database {
             "#,
             IMPORT_STATUS_QUEUED
         ))
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Track-Artist junction table
@@ -173,7 +237,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Files table (metadata for export/torrent features)
@@ -188,12 +252,13 @@ impl Database {
                 original_filename TEXT NOT NULL,
                 file_size INTEGER NOT NULL,
                 format TEXT NOT NULL,
+                stream_offset INTEGER NOT NULL,
                 created_at TEXT NOT NULL,
                 FOREIGN KEY (release_id) REFERENCES releases (id) ON DELETE CASCADE
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Chunks table (encrypted release chunks for cloud storage)
@@ -211,7 +276,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Audio formats table (format metadata per track)
@@ -231,7 +296,7 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Track chunk coordinates table (precise location of track audio in chunked stream)
@@ -254,54 +319,54 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Create indexes for performance
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_artists_discogs_id ON artists (discogs_artist_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_album_artists_album_id ON album_artists (album_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_album_artists_artist_id ON album_artists (artist_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_track_artists_track_id ON track_artists (track_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_track_artists_artist_id ON track_artists (artist_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_releases_album_id ON releases (album_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_tracks_release_id ON tracks (release_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_files_release_id ON files (release_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_chunks_release_id ON chunks (release_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         // Torrents table (torrent import metadata)
@@ -322,45 +387,41 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
-        // Torrent piece mappings table (maps torrent pieces to bae chunks)
+        // Torrent piece maps table (one binary piece-to-chunk map per torrent)
         sqlx::query(
             r#"
-            CREATE TABLE IF NOT EXISTS torrent_piece_mappings (
-                id TEXT PRIMARY KEY,
-                torrent_id TEXT NOT NULL,
-                piece_index INTEGER NOT NULL,
-                chunk_ids TEXT NOT NULL,
-                start_byte_in_first_chunk INTEGER NOT NULL,
-                end_byte_in_last_chunk INTEGER NOT NULL,
-                FOREIGN KEY (torrent_id) REFERENCES torrents (id) ON DELETE CASCADE,
-                UNIQUE(torrent_id, piece_index)
+            CREATE TABLE IF NOT EXISTS torrent_piece_maps (
+                torrent_id TEXT PRIMARY KEY,
+                piece_map BLOB NOT NULL,
+                created_at TEXT NOT NULL,
+                FOREIGN KEY (torrent_id) REFERENCES torrents (id) ON DELETE CASCADE
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
+        // Superseded by torrent_piece_maps. Maps of torrents seeded before the switch
+        // are rebuilt from the release's chunks when seeding starts.
+        sqlx::query("DROP TABLE IF EXISTS torrent_piece_mappings")
+            .execute(&mut *tx)
+            .await?;
+
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_torrents_release_id ON torrents (release_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_torrents_info_hash ON torrents (info_hash)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
-        sqlx::query(
-            "CREATE INDEX IF NOT EXISTS idx_torrent_piece_mappings_torrent_id ON torrent_piece_mappings (torrent_id)",
-        )
-        .execute(&self.pool)
-        .await?;
-
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_audio_formats_track_id ON audio_formats (track_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         // Images table (release artwork and cover art)
@@ -379,28 +440,113 @@ impl Database {
             )
             "#,
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query("CREATE INDEX IF NOT EXISTS idx_images_release_id ON images (release_id)")
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_track_chunk_coords_track_id ON track_chunk_coords (track_id)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
         sqlx::query(
             "CREATE INDEX IF NOT EXISTS idx_chunks_last_accessed ON chunks (last_accessed)",
         )
-        .execute(&self.pool)
+        .execute(&mut *tx)
         .await?;
 
+        // Cloud objects of deleted chunks that are not confirmed deleted yet.
+        // Rows are added in the transaction that deletes the chunks and cleared
+        // per delete batch, so interrupted deletions resume at the next startup.
+        sqlx::query(
+            r#"
+            CREATE TABLE IF NOT EXISTS pending_chunk_deletes (
+                storage_location TEXT PRIMARY KEY,
+                created_at TEXT NOT NULL
+            )
+            "#,
+        )
+        .execute(&mut *tx)
+        .await?;
+
+        // Releases imported before chunk sizes were chosen per release used the then
+        // configurable BAE_CHUNK_SIZE_BYTES. Their chunks were packed back to back, so every
+        // chunk but the last is full and the largest one gives the size. encrypted_size is
+        // the ciphertext, which carries a 16-byte AES-GCM tag. A single-chunk release gets
+        // its stream length, which still maps every byte to chunk 0.
+        if Self::add_column_if_missing(&mut *tx, "releases", "chunk_size_bytes", "INTEGER").await? {
+            sqlx::query(
+                r#"
+                UPDATE releases SET chunk_size_bytes = (
+                    SELECT MAX(encrypted_size) - 16 FROM chunks
+                    WHERE chunks.release_id = releases.id
+                )
+                "#,
+            )
+            .execute(&mut *tx)
+            .await?;
+        }
+
+        // Files recorded no stream offset before chunk layouts could leave gaps;
+        // they were packed back to back in filename order.
+        if Self::add_column_if_missing(
+            &mut *tx,
+            "files",
+            "stream_offset",
+            "INTEGER NOT NULL DEFAULT 0",
+        )
+        .await?
+        {
+            sqlx::query(
+                r#"
+                UPDATE files SET stream_offset = (
+                    SELECT COALESCE(SUM(earlier.file_size), 0) FROM files earlier
+                    WHERE earlier.release_id = files.release_id
+                    AND earlier.original_filename < files.original_filename
+                )
+                "#,
+            )
+            .execute(&mut *tx)
+            .await?;
+        }
+
+        tx.commit().await?;
         Ok(())
     }
 
+    /// Add a column that tables created by older versions lack
+    ///
+    /// `CREATE TABLE IF NOT EXISTS` leaves existing tables alone, so columns added
+    /// since have to be added here. Returns whether the column was missing.
+    async fn add_column_if_missing(
+        conn: &mut SqliteConnection,
+        table: &str,
+        column: &str,
+        definition: &str,
+    ) -> Result<bool, sqlx::Error> {
+        let columns: Vec<String> =
+            sqlx::query_scalar(&format!("SELECT name FROM pragma_table_info('{}')", table))
+                .fetch_all(&mut *conn)
+                .await?;
+        if columns.iter().any(|name| name == column) {
+            return Ok(false);
+        }
+
+        info!("Adding column {}.{}", table, column);
+
+        sqlx::query(&format!(
+            "ALTER TABLE {} ADD COLUMN {} {}",
+            table, column, definition
+        ))
+        .execute(&mut *conn)
+        .await?;
+        Ok(true)
+    }
+
     /// Insert a new artist
     pub async fn insert_artist(&self, artist: &DbArtist) -> Result<(), sqlx::Error> {
         sqlx::query(
@@ -418,7 +564,7 @@ impl Database {
         .bind(&artist.bandcamp_artist_id)
         .bind(artist.created_at.to_rfc3339())
         .bind(artist.updated_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -431,7 +577,7 @@ impl Database {
     ) -> Result<Option<DbArtist>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM artists WHERE discogs_artist_id = ?")
             .bind(discogs_artist_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         if let Some(row) = row {
@@ -468,7 +614,7 @@ impl Database {
         .bind(&album_artist.album_id)
         .bind(&album_artist.artist_id)
         .bind(album_artist.position)
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -490,7 +636,7 @@ impl Database {
         .bind(&track_artist.artist_id)
         .bind(track_artist.position)
         .bind(&track_artist.role)
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -510,7 +656,7 @@ impl Database {
             "#,
         )
         .bind(album_id)
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut artists = Vec::new();
@@ -533,6 +679,55 @@ impl Database {
         Ok(artists)
     }
 
+    /// Get the artists of many albums, keyed by album ID (ordered by position)
+    ///
+    /// List views use this instead of one query per album. Albums without
+    /// artists are absent from the map.
+    pub async fn get_artists_for_albums(
+        &self,
+        album_ids: &[String],
+    ) -> Result<HashMap<String, Vec<DbArtist>>, sqlx::Error> {
+        let mut artists_by_album: HashMap<String, Vec<DbArtist>> = HashMap::new();
+        for batch in album_ids.chunks(MAX_BIND_PARAMS) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                r#"
+                SELECT aa.album_id, a.* FROM artists a
+                JOIN album_artists aa ON a.id = aa.artist_id
+                WHERE aa.album_id IN ("#,
+            );
+            let mut album_id_list = query.separated(", ");
+            for album_id in batch {
+                album_id_list.push_bind(album_id);
+            }
+            query.push(") ORDER BY aa.album_id, aa.position");
+
+            for row in query.build().fetch_all(&self.reader).await? {
+                artists_by_album
+                    .entry(row.get("album_id"))
+                    .or_default()
+                    .push(DbArtist {
+                        id: row.get("id"),
+                        name: row.get("name"),
+                        sort_name: row.get("sort_name"),
+                        discogs_artist_id: row.get("discogs_artist_id"),
+                        bandcamp_artist_id: row.get("bandcamp_artist_id"),
+                        created_at: DateTime::parse_from_rfc3339(
+                            &row.get::<String, _>("created_at"),
+                        )
+                        .unwrap()
+                        .with_timezone(&Utc),
+                        updated_at: DateTime::parse_from_rfc3339(
+                            &row.get::<String, _>("updated_at"),
+                        )
+                        .unwrap()
+                        .with_timezone(&Utc),
+                    });
+            }
+        }
+
+        Ok(artists_by_album)
+    }
+
     /// Get artists for a track (ordered by position)
     pub async fn get_artists_for_track(
         &self,
@@ -547,7 +742,7 @@ impl Database {
             "#,
         )
         .bind(track_id)
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut artists = Vec::new();
@@ -570,9 +765,52 @@ impl Database {
         Ok(artists)
     }
 
+    /// Get the artists of every track of an album, as (track ID, artist) pairs
+    /// ordered by track and position
+    pub async fn get_track_artists_for_album(
+        &self,
+        album_id: &str,
+    ) -> Result<Vec<(String, DbArtist)>, sqlx::Error> {
+        let rows = sqlx::query(
+            r#"
+            SELECT ta.track_id, a.* FROM artists a
+            JOIN track_artists ta ON a.id = ta.artist_id
+            JOIN tracks t ON t.id = ta.track_id
+            JOIN releases r ON r.id = t.release_id
+            WHERE r.album_id = ?
+            ORDER BY ta.track_id, ta.position
+            "#,
+        )
+        .bind(album_id)
+        .fetch_all(&self.reader)
+        .await?;
+
+        let mut track_artists = Vec::new();
+        for row in rows {
+            track_artists.push((
+                row.get("track_id"),
+                DbArtist {
+                    id: row.get("id"),
+                    name: row.get("name"),
+                    sort_name: row.get("sort_name"),
+                    discogs_artist_id: row.get("discogs_artist_id"),
+                    bandcamp_artist_id: row.get("bandcamp_artist_id"),
+                    created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
+                        .unwrap()
+                        .with_timezone(&Utc),
+                    updated_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("updated_at"))
+                        .unwrap()
+                        .with_timezone(&Utc),
+                },
+            ));
+        }
+
+        Ok(track_artists)
+    }
+
     /// Insert a new album
     pub async fn insert_album(&self, album: &DbAlbum) -> Result<(), sqlx::Error> {
-        let mut tx = self.pool.begin().await?;
+        let mut tx = self.writer.begin().await?;
 
         // Insert album
         sqlx::query(
@@ -638,8 +876,8 @@ impl Database {
             INSERT INTO releases (
                 id, album_id, release_name, year, discogs_release_id,
                 bandcamp_release_id, format, label, catalog_number, country, barcode,
-                import_status, created_at, updated_at
-            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+                chunk_size_bytes, import_status, created_at, updated_at
+            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
             "#,
         )
         .bind(&release.id)
@@ -653,10 +891,11 @@ impl Database {
         .bind(&release.catalog_number)
         .bind(&release.country)
         .bind(&release.barcode)
+        .bind(release.chunk_size_bytes)
         .bind(release.import_status)
         .bind(release.created_at.to_rfc3339())
         .bind(release.updated_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -681,7 +920,7 @@ impl Database {
         .bind(&track.discogs_position)
         .bind(track.import_status)
         .bind(track.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -695,7 +934,7 @@ impl Database {
         release: &DbRelease,
         tracks: &[DbTrack],
     ) -> Result<(), sqlx::Error> {
-        let mut tx = self.pool.begin().await?;
+        let mut tx = self.writer.begin().await?;
 
         // Insert album
         sqlx::query(
@@ -756,8 +995,8 @@ impl Database {
             INSERT INTO releases (
                 id, album_id, release_name, year, discogs_release_id,
                 bandcamp_release_id, format, label, catalog_number, country, barcode,
-                import_status, created_at, updated_at
-            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+                chunk_size_bytes, import_status, created_at, updated_at
+            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
             "#,
         )
         .bind(&release.id)
@@ -771,6 +1010,7 @@ impl Database {
         .bind(&release.catalog_number)
         .bind(&release.country)
         .bind(&release.barcode)
+        .bind(release.chunk_size_bytes)
         .bind(release.import_status)
         .bind(release.created_at.to_rfc3339())
         .bind(release.updated_at.to_rfc3339())
@@ -778,32 +1018,38 @@ impl Database {
         .await?;
 
         // Insert all tracks
-        for track in tracks {
-            sqlx::query(
-                r#"
-                INSERT INTO tracks (
-                    id, release_id, title, disc_number, track_number, duration_ms, 
-                    discogs_position, import_status, created_at
-                ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
-                "#,
-            )
-            .bind(&track.id)
-            .bind(&track.release_id)
-            .bind(&track.title)
-            .bind(track.disc_number)
-            .bind(track.track_number)
-            .bind(track.duration_ms)
-            .bind(&track.discogs_position)
-            .bind(track.import_status)
-            .bind(track.created_at.to_rfc3339())
-            .execute(&mut *tx)
-            .await?;
-        }
+        Self::insert_tracks_batch(&mut *tx, tracks).await?;
 
         tx.commit().await?;
         Ok(())
     }
 
+    /// Insert tracks with multi-row INSERTs on an open connection or transaction
+    async fn insert_tracks_batch(
+        conn: &mut SqliteConnection,
+        tracks: &[DbTrack],
+    ) -> Result<(), sqlx::Error> {
+        for batch in tracks.chunks(rows_per_statement(9)) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                "INSERT INTO tracks (id, release_id, title, disc_number, track_number, \
+                 duration_ms, discogs_position, import_status, created_at) ",
+            );
+            query.push_values(batch, |mut row, track| {
+                row.push_bind(&track.id)
+                    .push_bind(&track.release_id)
+                    .push_bind(&track.title)
+                    .push_bind(track.disc_number)
+                    .push_bind(track.track_number)
+                    .push_bind(track.duration_ms)
+                    .push_bind(&track.discogs_position)
+                    .push_bind(track.import_status)
+                    .push_bind(track.created_at.to_rfc3339());
+            });
+            query.build().execute(&mut *conn).await?;
+        }
+        Ok(())
+    }
+
     /// Update track import status
     pub async fn update_track_status(
         &self,
@@ -813,7 +1059,7 @@ impl Database {
         sqlx::query("UPDATE tracks SET import_status = ? WHERE id = ?")
             .bind(status)
             .bind(track_id)
-            .execute(&self.pool)
+            .execute(&self.writer)
             .await?;
         Ok(())
     }
@@ -827,7 +1073,7 @@ impl Database {
         sqlx::query("UPDATE tracks SET duration_ms = ? WHERE id = ?")
             .bind(duration_ms)
             .bind(track_id)
-            .execute(&self.pool)
+            .execute(&self.writer)
             .await?;
         Ok(())
     }
@@ -842,7 +1088,22 @@ impl Database {
             .bind(status)
             .bind(Utc::now().to_rfc3339())
             .bind(release_id)
-            .execute(&self.pool)
+            .execute(&self.writer)
+            .await?;
+        Ok(())
+    }
+
+    /// Record the chunk size chosen for a release
+    pub async fn set_release_chunk_size(
+        &self,
+        release_id: &str,
+        chunk_size_bytes: i64,
+    ) -> Result<(), sqlx::Error> {
+        sqlx::query("UPDATE releases SET chunk_size_bytes = ?, updated_at = ? WHERE id = ?")
+            .bind(chunk_size_bytes)
+            .bind(Utc::now().to_rfc3339())
+            .bind(release_id)
+            .execute(&self.writer)
             .await?;
         Ok(())
     }
@@ -862,7 +1123,7 @@ impl Database {
             ORDER BY a.title
             "#,
         )
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut albums = Vec::new();
@@ -924,7 +1185,7 @@ impl Database {
             "#,
         )
         .bind(album_id)
-        .fetch_optional(&self.pool)
+        .fetch_optional(&self.reader)
         .await?;
 
         Ok(row.map(|row| {
@@ -974,7 +1235,7 @@ impl Database {
     ) -> Result<Vec<DbRelease>, sqlx::Error> {
         let rows = sqlx::query("SELECT * FROM releases WHERE album_id = ? ORDER BY created_at")
             .bind(album_id)
-            .fetch_all(&self.pool)
+            .fetch_all(&self.reader)
             .await?;
 
         let mut releases = Vec::new();
@@ -991,6 +1252,7 @@ impl Database {
                 catalog_number: row.get("catalog_number"),
                 country: row.get("country"),
                 barcode: row.get("barcode"),
+                chunk_size_bytes: row.get("chunk_size_bytes"),
                 import_status: row.get("import_status"),
                 created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
                     .unwrap()
@@ -1008,7 +1270,7 @@ impl Database {
     pub async fn get_track_by_id(&self, track_id: &str) -> Result<Option<DbTrack>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM tracks WHERE id = ?")
             .bind(track_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         if let Some(row) = row {
@@ -1035,12 +1297,25 @@ impl Database {
     ) -> Result<Option<String>, sqlx::Error> {
         let row = sqlx::query("SELECT album_id FROM releases WHERE id = ?")
             .bind(release_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         Ok(row.map(|r| r.get("album_id")))
     }
 
+    /// Get the chunk size of a release, if its data has been chunked
+    pub async fn get_release_chunk_size(
+        &self,
+        release_id: &str,
+    ) -> Result<Option<i64>, sqlx::Error> {
+        let row = sqlx::query("SELECT chunk_size_bytes FROM releases WHERE id = ?")
+            .bind(release_id)
+            .fetch_optional(&self.reader)
+            .await?;
+
+        Ok(row.and_then(|r| r.get("chunk_size_bytes")))
+    }
+
     /// Get tracks for a release
     pub async fn get_tracks_for_release(
         &self,
@@ -1050,7 +1325,7 @@ impl Database {
             "SELECT * FROM tracks WHERE release_id = ? ORDER BY disc_number, track_number",
         )
         .bind(release_id)
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut tracks = Vec::new();
@@ -1073,13 +1348,77 @@ impl Database {
         Ok(tracks)
     }
 
+    /// Get the tracks of every release of an album
+    pub async fn get_tracks_for_album(&self, album_id: &str) -> Result<Vec<DbTrack>, sqlx::Error> {
+        let rows = sqlx::query(
+            r#"
+            SELECT t.* FROM tracks t
+            JOIN releases r ON r.id = t.release_id
+            WHERE r.album_id = ?
+            ORDER BY t.release_id, t.disc_number, t.track_number
+            "#,
+        )
+        .bind(album_id)
+        .fetch_all(&self.reader)
+        .await?;
+
+        let mut tracks = Vec::new();
+        for row in rows {
+            tracks.push(DbTrack {
+                id: row.get("id"),
+                release_id: row.get("release_id"),
+                title: row.get("title"),
+                disc_number: row.get("disc_number"),
+                track_number: row.get("track_number"),
+                duration_ms: row.get("duration_ms"),
+                discogs_position: row.get("discogs_position"),
+                import_status: row.get("import_status"),
+                created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
+                    .unwrap()
+                    .with_timezone(&Utc),
+            });
+        }
+
+        Ok(tracks)
+    }
+
+    /// Count the tracks of the first release of many albums, keyed by album ID
+    pub async fn get_track_counts_for_albums(
+        &self,
+        album_ids: &[String],
+    ) -> Result<HashMap<String, i64>, sqlx::Error> {
+        let mut track_counts = HashMap::new();
+        for batch in album_ids.chunks(MAX_BIND_PARAMS) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                r#"
+                SELECT r.album_id, COUNT(t.id) AS track_count FROM releases r
+                JOIN tracks t ON t.release_id = r.id
+                WHERE r.created_at = (
+                    SELECT MIN(created_at) FROM releases WHERE album_id = r.album_id
+                )
+                AND r.album_id IN ("#,
+            );
+            let mut album_id_list = query.separated(", ");
+            for album_id in batch {
+                album_id_list.push_bind(album_id);
+            }
+            query.push(") GROUP BY r.album_id");
+
+            for row in query.build().fetch_all(&self.reader).await? {
+                track_counts.insert(row.get("album_id"), row.get("track_count"));
+            }
+        }
+
+        Ok(track_counts)
+    }
+
     /// Insert a new file record
     pub async fn insert_file(&self, file: &DbFile) -> Result<(), sqlx::Error> {
         sqlx::query(
             r#"
             INSERT INTO files (
-                id, release_id, original_filename, file_size, format, created_at
-            ) VALUES (?, ?, ?, ?, ?, ?)
+                id, release_id, original_filename, file_size, format, stream_offset, created_at
+            ) VALUES (?, ?, ?, ?, ?, ?, ?)
             "#,
         )
         .bind(&file.id)
@@ -1087,13 +1426,36 @@ impl Database {
         .bind(&file.original_filename)
         .bind(file.file_size)
         .bind(&file.format)
+        .bind(file.stream_offset)
         .bind(file.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
     }
 
+    /// Insert many file records in a single transaction
+    pub async fn insert_files(&self, files: &[DbFile]) -> Result<(), sqlx::Error> {
+        let mut tx = self.writer.begin().await?;
+        for batch in files.chunks(rows_per_statement(7)) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                "INSERT INTO files (id, release_id, original_filename, file_size, format, stream_offset, created_at) ",
+            );
+            query.push_values(batch, |mut row, file| {
+                row.push_bind(&file.id)
+                    .push_bind(&file.release_id)
+                    .push_bind(&file.original_filename)
+                    .push_bind(file.file_size)
+                    .push_bind(&file.format)
+                    .push_bind(file.stream_offset)
+                    .push_bind(file.created_at.to_rfc3339());
+            });
+            query.build().execute(&mut *tx).await?;
+        }
+        tx.commit().await?;
+        Ok(())
+    }
+
     /// Insert a new chunk record
     pub async fn insert_chunk(&self, chunk: &DbChunk) -> Result<(), sqlx::Error> {
         sqlx::query(
@@ -1111,7 +1473,7 @@ impl Database {
         .bind(&chunk.storage_location)
         .bind(chunk.last_accessed.as_ref().map(|dt| dt.to_rfc3339()))
         .bind(chunk.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -1130,7 +1492,7 @@ impl Database {
             "#,
         )
         .bind(release_id)
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut chunks = Vec::new();
@@ -1155,7 +1517,7 @@ impl Database {
     ) -> Result<Vec<DbFile>, sqlx::Error> {
         let rows = sqlx::query("SELECT * FROM files WHERE release_id = ?")
             .bind(release_id)
-            .fetch_all(&self.pool)
+            .fetch_all(&self.reader)
             .await?;
 
         let mut files = Vec::new();
@@ -1166,6 +1528,7 @@ impl Database {
                 original_filename: row.get("original_filename"),
                 file_size: row.get("file_size"),
                 format: row.get("format"),
+                stream_offset: row.get("stream_offset"),
                 created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
                     .unwrap()
                     .with_timezone(&Utc),
@@ -1179,7 +1542,7 @@ impl Database {
     pub async fn get_file_by_id(&self, file_id: &str) -> Result<Option<DbFile>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM files WHERE id = ?")
             .bind(file_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         if let Some(row) = row {
@@ -1189,6 +1552,7 @@ impl Database {
                 original_filename: row.get("original_filename"),
                 file_size: row.get("file_size"),
                 format: row.get("format"),
+                stream_offset: row.get("stream_offset"),
                 created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
                     .unwrap()
                     .with_timezone(&Utc),
@@ -1217,7 +1581,7 @@ impl Database {
         .bind(&audio_format.flac_seektable)
         .bind(audio_format.needs_headers)
         .bind(audio_format.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -1230,7 +1594,7 @@ impl Database {
     ) -> Result<Option<DbAudioFormat>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM audio_formats WHERE track_id = ?")
             .bind(track_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         if let Some(row) = row {
@@ -1250,6 +1614,31 @@ impl Database {
         }
     }
 
+    /// Get the distinct audio formats of each release of an album, as
+    /// (release ID, format) pairs
+    pub async fn get_audio_formats_for_album(
+        &self,
+        album_id: &str,
+    ) -> Result<Vec<(String, String)>, sqlx::Error> {
+        let rows = sqlx::query(
+            r#"
+            SELECT DISTINCT t.release_id, af.format FROM audio_formats af
+            JOIN tracks t ON t.id = af.track_id
+            JOIN releases r ON r.id = t.release_id
+            WHERE r.album_id = ?
+            ORDER BY t.release_id, af.format
+            "#,
+        )
+        .bind(album_id)
+        .fetch_all(&self.reader)
+        .await?;
+
+        Ok(rows
+            .into_iter()
+            .map(|row| (row.get("release_id"), row.get("format")))
+            .collect())
+    }
+
     /// Insert track chunk coordinates
     pub async fn insert_track_chunk_coords(
         &self,
@@ -1273,12 +1662,58 @@ impl Database {
         .bind(coords.start_time_ms)
         .bind(coords.end_time_ms)
         .bind(coords.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
     }
 
+    /// Insert the audio formats and chunk coordinates of many tracks in a single
+    /// transaction, so a track never has one without the other
+    pub async fn insert_track_metadata_batch(
+        &self,
+        audio_formats: &[DbAudioFormat],
+        coords: &[DbTrackChunkCoords],
+    ) -> Result<(), sqlx::Error> {
+        let mut tx = self.writer.begin().await?;
+        for batch in audio_formats.chunks(rows_per_statement(7)) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                "INSERT INTO audio_formats (id, track_id, format, flac_headers, flac_seektable, \
+                 needs_headers, created_at) ",
+            );
+            query.push_values(batch, |mut row, audio_format| {
+                row.push_bind(&audio_format.id)
+                    .push_bind(&audio_format.track_id)
+                    .push_bind(&audio_format.format)
+                    .push_bind(&audio_format.flac_headers)
+                    .push_bind(&audio_format.flac_seektable)
+                    .push_bind(audio_format.needs_headers)
+                    .push_bind(audio_format.created_at.to_rfc3339());
+            });
+            query.build().execute(&mut *tx).await?;
+        }
+        for batch in coords.chunks(rows_per_statement(9)) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                "INSERT INTO track_chunk_coords (id, track_id, start_chunk_index, end_chunk_index, \
+                 start_byte_offset, end_byte_offset, start_time_ms, end_time_ms, created_at) ",
+            );
+            query.push_values(batch, |mut row, coords| {
+                row.push_bind(&coords.id)
+                    .push_bind(&coords.track_id)
+                    .push_bind(coords.start_chunk_index)
+                    .push_bind(coords.end_chunk_index)
+                    .push_bind(coords.start_byte_offset)
+                    .push_bind(coords.end_byte_offset)
+                    .push_bind(coords.start_time_ms)
+                    .push_bind(coords.end_time_ms)
+                    .push_bind(coords.created_at.to_rfc3339());
+            });
+            query.build().execute(&mut *tx).await?;
+        }
+        tx.commit().await?;
+        Ok(())
+    }
+
     /// Get track chunk coordinates for a track
     pub async fn get_track_chunk_coords(
         &self,
@@ -1286,7 +1721,7 @@ impl Database {
     ) -> Result<Option<DbTrackChunkCoords>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM track_chunk_coords WHERE track_id = ?")
             .bind(track_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         if let Some(row) = row {
@@ -1320,7 +1755,7 @@ impl Database {
         .bind(release_id)
         .bind(*chunk_range.start())
         .bind(*chunk_range.end())
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut chunks = Vec::new();
@@ -1352,11 +1787,26 @@ impl Database {
     /// - Files (via FOREIGN KEY ON DELETE CASCADE)
     /// - Chunks (via FOREIGN KEY ON DELETE CASCADE)
     /// - Track artists, audio formats, track chunk coords (via FOREIGN KEY ON DELETE CASCADE)
+    ///
+    /// The storage locations of the release's chunks are queued in
+    /// pending_chunk_deletes in the same transaction.
     pub async fn delete_release(&self, release_id: &str) -> Result<(), sqlx::Error> {
+        let mut tx = self.writer.begin().await?;
+        sqlx::query(
+            r#"
+            INSERT OR IGNORE INTO pending_chunk_deletes (storage_location, created_at)
+            SELECT storage_location, ? FROM chunks WHERE release_id = ?
+            "#,
+        )
+        .bind(Utc::now().to_rfc3339())
+        .bind(release_id)
+        .execute(&mut *tx)
+        .await?;
         sqlx::query("DELETE FROM releases WHERE id = ?")
             .bind(release_id)
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
+        tx.commit().await?;
         Ok(())
     }
 
@@ -1367,11 +1817,54 @@ impl Database {
     /// - Album artists (via FOREIGN KEY ON DELETE CASCADE)
     /// - Album discogs (via FOREIGN KEY ON DELETE CASCADE)
     /// - All tracks, files, chunks, etc. from releases (via cascading)
+    ///
+    /// The storage locations of all its chunks are queued in
+    /// pending_chunk_deletes in the same transaction.
     pub async fn delete_album(&self, album_id: &str) -> Result<(), sqlx::Error> {
+        let mut tx = self.writer.begin().await?;
+        sqlx::query(
+            r#"
+            INSERT OR IGNORE INTO pending_chunk_deletes (storage_location, created_at)
+            SELECT c.storage_location, ? FROM chunks c
+            JOIN releases r ON c.release_id = r.id
+            WHERE r.album_id = ?
+            "#,
+        )
+        .bind(Utc::now().to_rfc3339())
+        .bind(album_id)
+        .execute(&mut *tx)
+        .await?;
         sqlx::query("DELETE FROM albums WHERE id = ?")
             .bind(album_id)
-            .execute(&self.pool)
+            .execute(&mut *tx)
             .await?;
+        tx.commit().await?;
+        Ok(())
+    }
+
+    /// Storage locations of deleted chunks whose cloud objects may still exist
+    pub async fn get_pending_chunk_deletes(&self) -> Result<Vec<String>, sqlx::Error> {
+        sqlx::query_scalar("SELECT storage_location FROM pending_chunk_deletes")
+            .fetch_all(&self.reader)
+            .await
+    }
+
+    /// Forget pending deletes whose cloud objects are gone
+    pub async fn remove_pending_chunk_deletes(
+        &self,
+        storage_locations: &[String],
+    ) -> Result<(), sqlx::Error> {
+        for batch in storage_locations.chunks(MAX_BIND_PARAMS) {
+            let mut query = QueryBuilder::<Sqlite>::new(
+                "DELETE FROM pending_chunk_deletes WHERE storage_location IN (",
+            );
+            let mut location_list = query.separated(", ");
+            for storage_location in batch {
+                location_list.push_bind(storage_location);
+            }
+            query.push(")");
+            query.build().execute(&self.writer).await?;
+        }
         Ok(())
     }
 
@@ -1431,17 +1924,17 @@ impl Database {
             sqlx::query(query)
                 .bind(master_id.unwrap())
                 .bind(release_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         } else if master_id.is_some() {
             sqlx::query(query)
                 .bind(master_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         } else {
             sqlx::query(query)
                 .bind(release_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         };
 
@@ -1541,17 +2034,17 @@ impl Database {
             sqlx::query(query)
                 .bind(release_id.unwrap())
                 .bind(release_group_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         } else if release_id.is_some() {
             sqlx::query(query)
                 .bind(release_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         } else {
             sqlx::query(query)
                 .bind(release_group_id.unwrap())
-                .fetch_optional(&self.pool)
+                .fetch_optional(&self.reader)
                 .await?
         };
 
@@ -1615,7 +2108,7 @@ impl Database {
         .bind(torrent.num_pieces)
         .bind(torrent.is_seeding)
         .bind(torrent.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
         Ok(())
     }
@@ -1635,7 +2128,7 @@ impl Database {
             "#,
         )
         .bind(release_id)
-        .fetch_optional(&self.pool)
+        .fetch_optional(&self.reader)
         .await?;
 
         Ok(row.map(|row| DbTorrent {
@@ -1654,88 +2147,44 @@ impl Database {
         }))
     }
 
-    /// Insert a torrent piece mapping
-    pub async fn insert_torrent_piece_mapping(
+    /// Insert or replace the piece map for a torrent
+    pub async fn insert_torrent_piece_map(
         &self,
-        mapping: &DbTorrentPieceMapping,
+        piece_map: &DbTorrentPieceMap,
     ) -> Result<(), sqlx::Error> {
         sqlx::query(
             r#"
-            INSERT INTO torrent_piece_mappings (
-                id, torrent_id, piece_index, chunk_ids,
-                start_byte_in_first_chunk, end_byte_in_last_chunk
-            ) VALUES (?, ?, ?, ?, ?, ?)
+            INSERT OR REPLACE INTO torrent_piece_maps (
+                torrent_id, piece_map, created_at
+            ) VALUES (?, ?, ?)
             "#,
         )
-        .bind(&mapping.id)
-        .bind(&mapping.torrent_id)
-        .bind(mapping.piece_index)
-        .bind(&mapping.chunk_ids)
-        .bind(mapping.start_byte_in_first_chunk)
-        .bind(mapping.end_byte_in_last_chunk)
-        .execute(&self.pool)
+        .bind(&piece_map.torrent_id)
+        .bind(&piece_map.piece_map)
+        .bind(piece_map.created_at.to_rfc3339())
+        .execute(&self.writer)
         .await?;
         Ok(())
     }
 
-    /// Get piece mappings for a torrent
-    pub async fn get_torrent_piece_mappings(
-        &self,
-        torrent_id: &str,
-    ) -> Result<Vec<DbTorrentPieceMapping>, sqlx::Error> {
-        let rows = sqlx::query(
-            r#"
-            SELECT id, torrent_id, piece_index, chunk_ids,
-                   start_byte_in_first_chunk, end_byte_in_last_chunk
-            FROM torrent_piece_mappings
-            WHERE torrent_id = ?
-            ORDER BY piece_index
-            "#,
-        )
-        .bind(torrent_id)
-        .fetch_all(&self.pool)
-        .await?;
-
-        Ok(rows
-            .into_iter()
-            .map(|row| DbTorrentPieceMapping {
-                id: row.get("id"),
-                torrent_id: row.get("torrent_id"),
-                piece_index: row.get("piece_index"),
-                chunk_ids: row.get("chunk_ids"),
-                start_byte_in_first_chunk: row.get("start_byte_in_first_chunk"),
-                end_byte_in_last_chunk: row.get("end_byte_in_last_chunk"),
-            })
-            .collect())
-    }
-
-    /// Get a specific piece mapping
-    pub async fn get_torrent_piece_mapping(
+    /// Get the piece map for a torrent
+    pub async fn get_torrent_piece_map(
         &self,
         torrent_id: &str,
-        piece_index: i32,
-    ) -> Result<Option<DbTorrentPieceMapping>, sqlx::Error> {
+    ) -> Result<Option<DbTorrentPieceMap>, sqlx::Error> {
         let row = sqlx::query(
-            r#"
-            SELECT id, torrent_id, piece_index, chunk_ids,
-                   start_byte_in_first_chunk, end_byte_in_last_chunk
-            FROM torrent_piece_mappings
-            WHERE torrent_id = ? AND piece_index = ?
-            LIMIT 1
-            "#,
+            "SELECT torrent_id, piece_map, created_at FROM torrent_piece_maps WHERE torrent_id = ?",
         )
         .bind(torrent_id)
-        .bind(piece_index)
-        .fetch_optional(&self.pool)
+        .fetch_optional(&self.reader)
         .await?;
 
-        Ok(row.map(|row| DbTorrentPieceMapping {
-            id: row.get("id"),
+        Ok(row.map(|row| DbTorrentPieceMap {
             torrent_id: row.get("torrent_id"),
-            piece_index: row.get("piece_index"),
-            chunk_ids: row.get("chunk_ids"),
-            start_byte_in_first_chunk: row.get("start_byte_in_first_chunk"),
-            end_byte_in_last_chunk: row.get("end_byte_in_last_chunk"),
+            piece_map: row.get("piece_map"),
+            created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
+                .unwrap()
+                .with_timezone(&Utc),
         }))
     }
 
@@ -1748,7 +2197,7 @@ impl Database {
         sqlx::query("UPDATE torrents SET is_seeding = ? WHERE id = ?")
             .bind(is_seeding)
             .bind(torrent_id)
-            .execute(&self.pool)
+            .execute(&self.writer)
             .await?;
         Ok(())
     }
@@ -1763,7 +2212,7 @@ impl Database {
             WHERE is_seeding = TRUE
             "#,
         )
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         Ok(rows
@@ -1804,7 +2253,7 @@ impl Database {
         .bind(image.width)
         .bind(image.height)
         .bind(image.created_at.to_rfc3339())
-        .execute(&self.pool)
+        .execute(&self.writer)
         .await?;
 
         Ok(())
@@ -1819,7 +2268,7 @@ impl Database {
             "SELECT * FROM images WHERE release_id = ? ORDER BY is_cover DESC, filename",
         )
         .bind(release_id)
-        .fetch_all(&self.pool)
+        .fetch_all(&self.reader)
         .await?;
 
         let mut images = Vec::new();
@@ -1848,7 +2297,7 @@ impl Database {
     ) -> Result<Option<DbImage>, sqlx::Error> {
         let row = sqlx::query("SELECT * FROM images WHERE release_id = ? AND is_cover = TRUE")
             .bind(release_id)
-            .fetch_optional(&self.pool)
+            .fetch_optional(&self.reader)
             .await?;
 
         Ok(row.map(|row| DbImage {
@@ -1865,13 +2314,48 @@ impl Database {
         }))
     }
 
+    /// Get the cover images of all releases of an album
+    pub async fn get_cover_images_for_album(
+        &self,
+        album_id: &str,
+    ) -> Result<Vec<DbImage>, sqlx::Error> {
+        let rows = sqlx::query(
+            r#"
+            SELECT i.* FROM images i
+            JOIN releases r ON r.id = i.release_id
+            WHERE r.album_id = ? AND i.is_cover = TRUE
+            "#,
+        )
+        .bind(album_id)
+        .fetch_all(&self.reader)
+        .await?;
+
+        let mut images = Vec::new();
+        for row in rows {
+            images.push(DbImage {
+                id: row.get("id"),
+                release_id: row.get("release_id"),
+                filename: row.get("filename"),
+                is_cover: row.get("is_cover"),
+                source: row.get("source"),
+                width: row.get("width"),
+                height: row.get("height"),
+                created_at: DateTime::parse_from_rfc3339(&row.get::<String, _>("created_at"))
+                    .unwrap()
+                    .with_timezone(&Utc),
+            });
+        }
+
+        Ok(images)
+    }
+
     /// Set an image as the cover (and unset any previous cover)
     pub async fn set_cover_image(
         &self,
         release_id: &str,
         image_id: &str,
     ) -> Result<(), sqlx::Error> {
-        let mut tx = self.pool.begin().await?;
+        let mut tx = self.writer.begin().await?;
 
         // Unset any existing cover for this release
         sqlx::query("UPDATE images SET is_cover = FALSE WHERE release_id = ? AND is_cover = TRUE")
@@ -1893,7 +2377,7 @@ impl Database {
     pub async fn delete_image(&self, image_id: &str) -> Result<(), sqlx::Error> {
         sqlx::query("DELETE FROM images WHERE id = ?")
             .bind(image_id)
-            .execute(&self.pool)
+            .execute(&self.writer)
             .await?;
         Ok(())
     }
@@ -177,6 +177,8 @@ pub struct DbRelease {
     pub country: Option<String>,
     /// Barcode
     pub barcode: Option<String>,
+    /// Size of this release's chunks, chosen when its data is chunked (None until then)
+    pub chunk_size_bytes: Option<i64>,
     pub import_status: ImportStatus,
     pub created_at: DateTime<Utc>,
     pub updated_at: DateTime<Utc>,
@@ -226,6 +228,8 @@ pub struct DbFile {
     pub original_filename: String,
     pub file_size: i64,
     pub format: String, // "flac", "mp3", etc.
+    /// Byte offset where this file starts in the release's chunk stream
+    pub stream_offset: i64,
     pub created_at: DateTime<Utc>,
 }
 
@@ -427,6 +431,7 @@ impl DbRelease {
             catalog_number: None,
             country: None,
             barcode: None,
+            chunk_size_bytes: None,
             import_status: ImportStatus::Queued,
             created_at: now,
             updated_at: now,
@@ -448,6 +453,7 @@ impl DbRelease {
             catalog_number: None, // TODO: Extract from Discogs release
             country: None,        // TODO: Extract from Discogs release country
             barcode: None,        // TODO: Extract from Discogs release identifiers
+            chunk_size_bytes: None,
             import_status: ImportStatus::Queued,
             created_at: now,
             updated_at: now,
@@ -475,6 +481,7 @@ impl DbRelease {
             catalog_number: release.catalog_number.clone(),
             country: release.country.clone(),
             barcode: release.barcode.clone(),
+            chunk_size_bytes: None,
             import_status: ImportStatus::Queued,
             created_at: now,
             updated_at: now,
@@ -528,13 +535,20 @@ impl DbFile {
     ///
     /// Files are linked to releases. Used for reconstructing original file structure
     /// during export or BitTorrent seeding.
-    pub fn new(release_id: &str, original_filename: &str, file_size: i64, format: &str) -> Self {
+    pub fn new(
+        release_id: &str,
+        original_filename: &str,
+        file_size: i64,
+        format: &str,
+        stream_offset: i64,
+    ) -> Self {
         DbFile {
             id: Uuid::new_v4().to_string(),
             release_id: release_id.to_string(),
             original_filename: original_filename.to_string(),
             file_size,
             format: format.to_string(),
+            stream_offset,
             created_at: Utc::now(),
         }
     }
@@ -628,15 +642,15 @@ pub struct DbTorrent {
     pub created_at: DateTime<Utc>,
 }
 
-/// Maps torrent pieces to bae chunks
+/// Maps every piece of a torrent to bae chunks
+///
+/// `piece_map` is the binary encoding produced by `torrent::piece_mapper::PieceMap`:
+/// chunk indices into the release's chunk table plus packed byte offsets per piece.
 #[derive(Debug, Clone, Serialize, Deserialize)]
-pub struct DbTorrentPieceMapping {
-    pub id: String,
+pub struct DbTorrentPieceMap {
     pub torrent_id: String,
-    pub piece_index: i32,
-    pub chunk_ids: String, // JSON array of chunk IDs
-    pub start_byte_in_first_chunk: i64,
-    pub end_byte_in_last_chunk: i64,
+    pub piece_map: Vec<u8>,
+    pub created_at: DateTime<Utc>,
 }
 
 impl DbTorrent {
@@ -664,26 +678,13 @@ impl DbTorrent {
     }
 }
 
-impl DbTorrentPieceMapping {
-    pub fn new(
-        torrent_id: &str,
-        piece_index: i32,
-        chunk_ids: Vec<String>,
-        start_byte_in_first_chunk: i64,
-        end_byte_in_last_chunk: i64,
-    ) -> Result<Self, serde_json::Error> {
-        Ok(DbTorrentPieceMapping {
-            id: Uuid::new_v4().to_string(),
+impl DbTorrentPieceMap {
+    pub fn new(torrent_id: &str, piece_map: Vec<u8>) -> Self {
+        DbTorrentPieceMap {
             torrent_id: torrent_id.to_string(),
-            piece_index,
-            chunk_ids: serde_json::to_string(&chunk_ids)?,
-            start_byte_in_first_chunk,
-            end_byte_in_last_chunk,
-        })
-    }
-
-    pub fn chunk_ids(&self) -> Result<Vec<String>, serde_json::Error> {
-        serde_json::from_str(&self.chunk_ids)
+            piece_map,
+            created_at: Utc::now(),
+        }
     }
 }
 
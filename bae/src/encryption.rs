@@ -2,6 +2,8 @@ use aes_gcm::{
     aead::{Aead, AeadCore, KeyInit, OsRng},
     Aes256Gcm, Key, Nonce,
 };
+use chacha20poly1305::ChaCha20Poly1305;
+use serde::Deserialize;
 use thiserror::Error;
 use tracing::{error, info};
 
@@ -17,21 +19,77 @@ pub enum EncryptionError {
     Io(#[from] std::io::Error),
 }
 
-/// Manages encryption keys and provides AES-256-GCM encryption/decryption
+/// AEAD cipher a chunk is encrypted with, recorded in the chunk itself
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Deserialize)]
+pub enum ChunkCipher {
+    /// Fastest where the CPU has AES instructions
+    #[serde(rename = "aes-256-gcm")]
+    Aes256Gcm,
+    /// Fast in software, for ARM NAS boxes and older CPUs without AES instructions
+    #[serde(rename = "chacha20-poly1305")]
+    ChaCha20Poly1305,
+}
+
+impl ChunkCipher {
+    /// AES-256-GCM if this CPU accelerates it, ChaCha20-Poly1305 otherwise
+    pub fn detect() -> Self {
+        if cpu_has_aes() {
+            ChunkCipher::Aes256Gcm
+        } else {
+            ChunkCipher::ChaCha20Poly1305
+        }
+    }
+
+    /// ID stored in the chunk format
+    fn id(self) -> u8 {
+        match self {
+            ChunkCipher::Aes256Gcm => 1,
+            ChunkCipher::ChaCha20Poly1305 => 2,
+        }
+    }
+
+    fn from_id(id: u8) -> Option<Self> {
+        match id {
+            1 => Some(ChunkCipher::Aes256Gcm),
+            2 => Some(ChunkCipher::ChaCha20Poly1305),
+            _ => None,
+        }
+    }
+}
+
+fn cpu_has_aes() -> bool {
+    #[cfg(target_arch = "x86_64")]
+    return std::arch::is_x86_feature_detected!("aes")
+        && std::arch::is_x86_feature_detected!("pclmulqdq");
+
+    #[cfg(target_arch = "aarch64")]
+    return std::arch::is_aarch64_feature_detected!("aes")
+        && std::arch::is_aarch64_feature_detected!("pmull");
+
+    #[allow(unreachable_code)]
+    false
+}
+
+/// Manages encryption keys and provides authenticated chunk encryption/decryption
 ///
 /// This implements the security model described in the README:
 /// - Files are split into chunks and each chunk is encrypted separately
-/// - Uses AES-256-GCM for authenticated encryption
+/// - Uses AES-256-GCM or ChaCha20-Poly1305 for authenticated encryption
 /// - Each chunk gets a unique nonce for security
+///
+/// New chunks use the configured cipher. Decryption uses whichever cipher the
+/// chunk records, so a library can hold chunks written with both.
 #[derive(Clone)]
 pub struct EncryptionService {
-    cipher: Aes256Gcm,
+    chunk_cipher: ChunkCipher,
+    aes: Aes256Gcm,
+    chacha: ChaCha20Poly1305,
 }
 
 impl std::fmt::Debug for EncryptionService {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.debug_struct("EncryptionService")
-            .field("cipher", &"<initialized>")
+            .field("chunk_cipher", &self.chunk_cipher)
             .finish()
     }
 }
@@ -54,13 +112,11 @@ impl EncryptionService {
         let key_array: [u8; 32] = key_bytes.try_into().map_err(|_| {
             EncryptionError::KeyManagement("Failed to convert key bytes to array".to_string())
         })?;
-        let key = Key::<Aes256Gcm>::from_slice(&key_array);
-        let cipher = Aes256Gcm::new(key);
 
-        Ok(EncryptionService { cipher })
+        Ok(Self::with_key(&key_array, config.chunk_cipher))
     }
 
-    /// Create an encryption service with a raw key (for testing)
+    /// Create an AES-256-GCM encryption service with a raw key (for testing)
     #[cfg(feature = "test-utils")]
     #[allow(unused)] // Used in tests
     pub fn new_with_key(key_bytes: Vec<u8>) -> Self {
@@ -69,47 +125,40 @@ impl EncryptionService {
         }
 
         let key_array: [u8; 32] = key_bytes.try_into().unwrap();
-        let key = Key::<Aes256Gcm>::from_slice(&key_array);
-        let cipher = Aes256Gcm::new(key);
-
-        EncryptionService { cipher }
-    }
-
-    /// Encrypt data with AES-256-GCM
-    /// Returns (encrypted_data, nonce) - both needed for decryption
-    pub fn encrypt(&self, plaintext: &[u8]) -> Result<(Vec<u8>, Vec<u8>), EncryptionError> {
-        // Generate a unique nonce for this encryption
-        let nonce = Aes256Gcm::generate_nonce(&mut OsRng);
-
-        // Encrypt the data
-        let ciphertext = self.cipher.encrypt(&nonce, plaintext).map_err(|e| {
-            EncryptionError::Encryption(format!("AES-GCM encryption failed: {}", e))
-        })?;
-
-        Ok((ciphertext, nonce.to_vec()))
+        Self::with_key(&key_array, ChunkCipher::Aes256Gcm)
     }
 
-    /// Decrypt data with AES-256-GCM
-    /// Requires both the encrypted data and the nonce used during encryption
-    pub fn decrypt(&self, ciphertext: &[u8], nonce: &[u8]) -> Result<Vec<u8>, EncryptionError> {
-        // Convert nonce bytes back to Nonce
-        if nonce.len() != 12 {
-            return Err(EncryptionError::Decryption(
-                "Invalid nonce length, expected 12 bytes".to_string(),
-            ));
+    fn with_key(key_array: &[u8; 32], chunk_cipher: ChunkCipher) -> Self {
+        EncryptionService {
+            chunk_cipher,
+            aes: Aes256Gcm::new(Key::<Aes256Gcm>::from_slice(key_array)),
+            chacha: ChaCha20Poly1305::new(chacha20poly1305::Key::from_slice(key_array)),
         }
+    }
 
-        let nonce_array: [u8; 12] = nonce.try_into().map_err(|_| {
-            EncryptionError::Decryption("Failed to convert nonce bytes to array".to_string())
-        })?;
-        let nonce = Nonce::from_slice(&nonce_array);
-
-        // Decrypt the data
-        let plaintext = self.cipher.decrypt(nonce, ciphertext).map_err(|e| {
-            EncryptionError::Decryption(format!("AES-GCM decryption failed: {}", e))
+    /// Encrypt a chunk with the configured cipher and a fresh nonce
+    pub fn encrypt_chunk(&self, plaintext: &[u8]) -> Result<EncryptedChunk, EncryptionError> {
+        let cipher = self.chunk_cipher;
+        let (encrypted_data, nonce) = match cipher {
+            ChunkCipher::Aes256Gcm => {
+                let nonce = Aes256Gcm::generate_nonce(&mut OsRng);
+                (self.aes.encrypt(&nonce, plaintext), nonce)
+            }
+            ChunkCipher::ChaCha20Poly1305 => {
+                let nonce = ChaCha20Poly1305::generate_nonce(&mut OsRng);
+                (self.chacha.encrypt(&nonce, plaintext), nonce)
+            }
+        };
+        let encrypted_data = encrypted_data.map_err(|e| {
+            EncryptionError::Encryption(format!("{:?} encryption failed: {}", cipher, e))
         })?;
 
-        Ok(plaintext)
+        Ok(EncryptedChunk::new(
+            cipher,
+            encrypted_data,
+            nonce.to_vec(),
+            "master".to_string(),
+        ))
     }
 
     /// Decrypt a chunk from its serialized format
@@ -121,14 +170,31 @@ impl EncryptionService {
         // Note: We don't verify key_id anymore since we only have one master key per app
         // The encrypted_chunk still stores it for backward compatibility
 
-        // Decrypt using the nonce and encrypted data
-        self.decrypt(&encrypted_chunk.encrypted_data, &encrypted_chunk.nonce)
+        // Both ciphers use 96-bit nonces
+        let nonce: [u8; 12] = encrypted_chunk.nonce.as_slice().try_into().map_err(|_| {
+            EncryptionError::Decryption("Invalid nonce length, expected 12 bytes".to_string())
+        })?;
+        let nonce = Nonce::from_slice(&nonce);
+
+        let ciphertext = encrypted_chunk.encrypted_data.as_slice();
+        let plaintext = match encrypted_chunk.cipher {
+            ChunkCipher::Aes256Gcm => self.aes.decrypt(nonce, ciphertext),
+            ChunkCipher::ChaCha20Poly1305 => self.chacha.decrypt(nonce, ciphertext),
+        };
+
+        plaintext.map_err(|e| {
+            EncryptionError::Decryption(format!(
+                "{:?} decryption failed: {}",
+                encrypted_chunk.cipher, e
+            ))
+        })
     }
 }
 
 /// Encrypted chunk format that includes all data needed for decryption
 #[derive(Debug, Clone)]
 pub struct EncryptedChunk {
+    pub cipher: ChunkCipher,
     pub encrypted_data: Vec<u8>,
     pub nonce: Vec<u8>,
     pub key_id: String,
@@ -136,8 +202,14 @@ pub struct EncryptedChunk {
 
 impl EncryptedChunk {
     /// Create a new encrypted chunk
-    pub fn new(encrypted_data: Vec<u8>, nonce: Vec<u8>, key_id: String) -> Self {
+    pub fn new(
+        cipher: ChunkCipher,
+        encrypted_data: Vec<u8>,
+        nonce: Vec<u8>,
+        key_id: String,
+    ) -> Self {
         EncryptedChunk {
+            cipher,
             encrypted_data,
             nonce,
             key_id,
@@ -145,10 +217,13 @@ impl EncryptedChunk {
     }
 
     /// Serialize the encrypted chunk to bytes for storage
-    /// Format: [nonce_len(4)][nonce][key_id_len(4)][key_id][encrypted_data]
+    /// Format: [cipher_id(1)][nonce_len(4)][nonce][key_id_len(4)][key_id][encrypted_data]
     pub fn to_bytes(&self) -> Vec<u8> {
         let mut bytes = Vec::new();
 
+        // Write cipher ID
+        bytes.push(self.cipher.id());
+
         // Write nonce length and nonce
         bytes.extend_from_slice(&(self.nonce.len() as u32).to_le_bytes());
         bytes.extend_from_slice(&self.nonce);
@@ -165,17 +240,29 @@ impl EncryptedChunk {
     }
 
     /// Deserialize encrypted chunk from bytes
+    ///
+    /// Chunks written before the cipher was recorded have no cipher ID and start with
+    /// the nonce length, whose first byte (12) is no known ID. They are AES-256-GCM.
     pub fn from_bytes(bytes: &[u8]) -> Result<Self, EncryptionError> {
-        if bytes.len() < 8 {
+        if bytes.len() < 9 {
             return Err(EncryptionError::Decryption(
                 "Invalid chunk format".to_string(),
             ));
         }
 
-        let mut offset = 0;
+        // Read cipher ID, if the chunk has one
+        let (cipher, mut offset) = match ChunkCipher::from_id(bytes[0]) {
+            Some(cipher) => (cipher, 1),
+            None => (ChunkCipher::Aes256Gcm, 0),
+        };
 
         // Read nonce length and nonce
-        let nonce_len = u32::from_le_bytes([bytes[0], bytes[1], bytes[2], bytes[3]]) as usize;
+        let nonce_len = u32::from_le_bytes([
+            bytes[offset],
+            bytes[offset + 1],
+            bytes[offset + 2],
+            bytes[offset + 3],
+        ]) as usize;
         offset += 4;
 
         if offset + nonce_len > bytes.len() {
@@ -216,6 +303,7 @@ impl EncryptedChunk {
         let encrypted_data = bytes[offset..].to_vec();
 
         Ok(EncryptedChunk {
+            cipher,
             encrypted_data,
             nonce,
             key_id,
@@ -227,14 +315,13 @@ impl EncryptedChunk {
 mod tests {
     use super::*;
 
-    /// Create a test encryption service with a pre-populated test key (avoids keyring)
-    fn create_test_encryption_service() -> EncryptionService {
+    /// Create a test config with a generated key (avoids keyring)
+    fn create_test_config(chunk_cipher: ChunkCipher) -> crate::config::Config {
         // Generate a test encryption key
         let test_key = Aes256Gcm::generate_key(OsRng);
         let test_key_hex = hex::encode(test_key.as_ref() as &[u8]);
 
-        // Create a test config with the generated key
-        let test_config = crate::config::Config {
+        crate::config::Config {
             library_id: "test-library".to_string(),
             discogs_api_key: "test-key".to_string(),
             s3_config: crate::cloud_storage::S3Config {
@@ -244,38 +331,103 @@ mod tests {
                 secret_access_key: "test-secret".to_string(),
                 endpoint_url: None,
             },
+            storage_path: None,
             encryption_key: test_key_hex,
+            chunk_cipher,
             max_import_encrypt_workers: 4,
             max_import_upload_workers: 20,
             max_import_db_write_workers: 10,
-            chunk_size_bytes: 1024 * 1024,
-        };
+            min_chunk_size_bytes: 256 * 1024,
+            max_chunk_size_bytes: 16 * 1024 * 1024,
+            chunk_layout: crate::import::ChunkLayoutMode::Contiguous,
+            torrent_bind_interface: None,
+            seed_cache_max_bytes: 1024 * 1024 * 1024,
+            seed_pin_max_bytes: 512 * 1024 * 1024,
+            torrent_active_seeds: 100,
+            torrent_active_limit: 120,
+            lan_peers: None,
+            memory_budget_bytes: 1024 * 1024 * 1024,
+        }
+    }
 
-        EncryptionService::new(&test_config).expect("Failed to create test encryption service")
+    /// Create a test encryption service with a pre-populated test key (avoids keyring)
+    fn create_test_encryption_service() -> EncryptionService {
+        EncryptionService::new(&create_test_config(ChunkCipher::Aes256Gcm))
+            .expect("Failed to create test encryption service")
     }
 
     #[test]
     fn test_encryption_roundtrip() {
-        let encryption_service = create_test_encryption_service();
         let plaintext = b"Hello, world! This is a test message for encryption.";
 
-        // Encrypt
-        let (ciphertext, nonce) = encryption_service.encrypt(plaintext).unwrap();
+        for cipher in [ChunkCipher::Aes256Gcm, ChunkCipher::ChaCha20Poly1305] {
+            let encryption_service = EncryptionService::new(&create_test_config(cipher)).unwrap();
+
+            // Encrypt
+            let chunk = encryption_service.encrypt_chunk(plaintext).unwrap();
+
+            // Verify ciphertext is different from plaintext
+            assert_eq!(chunk.cipher, cipher);
+            assert_ne!(chunk.encrypted_data, plaintext);
+            assert_eq!(chunk.nonce.len(), 12); // Both ciphers use 12 byte nonces
+
+            // Decrypt
+            let decrypted = encryption_service.decrypt_chunk(&chunk.to_bytes()).unwrap();
+
+            // Verify decryption matches original
+            assert_eq!(decrypted, plaintext);
+        }
+    }
+
+    #[test]
+    fn test_decrypt_chunk_without_cipher_id() {
+        let encryption_service = create_test_encryption_service();
+        let plaintext = b"Chunk imported before the cipher was recorded";
+
+        // The old layout is the current one without the leading cipher ID
+        let chunk = encryption_service.encrypt_chunk(plaintext).unwrap();
+        let legacy_bytes = chunk.to_bytes()[1..].to_vec();
+        assert_eq!(legacy_bytes[0], 12);
+
+        let legacy_chunk = EncryptedChunk::from_bytes(&legacy_bytes).unwrap();
+        assert_eq!(legacy_chunk.cipher, ChunkCipher::Aes256Gcm);
+        assert_eq!(legacy_chunk.key_id, "master");
+        assert_eq!(
+            encryption_service.decrypt_chunk(&legacy_bytes).unwrap(),
+            plaintext
+        );
+    }
 
-        // Verify ciphertext is different from plaintext
-        assert_ne!(ciphertext, plaintext);
-        assert_eq!(nonce.len(), 12); // AES-GCM nonce is 12 bytes
+    #[test]
+    fn test_decrypt_dispatches_on_stored_cipher() {
+        let aes_config = create_test_config(ChunkCipher::Aes256Gcm);
+        let chacha_config = crate::config::Config {
+            chunk_cipher: ChunkCipher::ChaCha20Poly1305,
+            ..aes_config.clone()
+        };
+        let aes_service = EncryptionService::new(&aes_config).unwrap();
+        let chacha_service = EncryptionService::new(&chacha_config).unwrap();
+        let plaintext = b"Chunk written on a NAS without AES instructions";
 
-        // Decrypt
-        let decrypted = encryption_service.decrypt(&ciphertext, &nonce).unwrap();
+        let chunk = chacha_service.encrypt_chunk(plaintext).unwrap();
+        assert_eq!(chunk.cipher, ChunkCipher::ChaCha20Poly1305);
 
-        // Verify decryption matches original
-        assert_eq!(decrypted, plaintext);
+        // A service configured for AES still reads ChaCha20-Poly1305 chunks, and vice versa
+        assert_eq!(
+            aes_service.decrypt_chunk(&chunk.to_bytes()).unwrap(),
+            plaintext
+        );
+        let chunk = aes_service.encrypt_chunk(plaintext).unwrap();
+        assert_eq!(
+            chacha_service.decrypt_chunk(&chunk.to_bytes()).unwrap(),
+            plaintext
+        );
     }
 
     #[test]
     fn test_encrypted_chunk_serialization() {
         let chunk = EncryptedChunk::new(
+            ChunkCipher::ChaCha20Poly1305,
             vec![1, 2, 3, 4, 5],
             vec![6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17], // 12 bytes
             "test_key_id".to_string(),
@@ -288,6 +440,7 @@ mod tests {
         let deserialized = EncryptedChunk::from_bytes(&bytes).unwrap();
 
         // Verify
+        assert_eq!(deserialized.cipher, chunk.cipher);
         assert_eq!(deserialized.encrypted_data, chunk.encrypted_data);
         assert_eq!(deserialized.nonce, chunk.nonce);
         assert_eq!(deserialized.key_id, chunk.key_id);
@@ -299,17 +452,21 @@ mod tests {
         let plaintext = b"Same message";
 
         // Encrypt twice
-        let (ciphertext1, nonce1) = encryption_service.encrypt(plaintext).unwrap();
-        let (ciphertext2, nonce2) = encryption_service.encrypt(plaintext).unwrap();
+        let chunk1 = encryption_service.encrypt_chunk(plaintext).unwrap();
+        let chunk2 = encryption_service.encrypt_chunk(plaintext).unwrap();
 
         // Nonces should be different
-        assert_ne!(nonce1, nonce2);
+        assert_ne!(chunk1.nonce, chunk2.nonce);
         // Ciphertexts should be different (due to different nonces)
-        assert_ne!(ciphertext1, ciphertext2);
+        assert_ne!(chunk1.encrypted_data, chunk2.encrypted_data);
 
         // Both should decrypt to the same plaintext
-        let decrypted1 = encryption_service.decrypt(&ciphertext1, &nonce1).unwrap();
-        let decrypted2 = encryption_service.decrypt(&ciphertext2, &nonce2).unwrap();
+        let decrypted1 = encryption_service
+            .decrypt_chunk(&chunk1.to_bytes())
+            .unwrap();
+        let decrypted2 = encryption_service
+            .decrypt_chunk(&chunk2.to_bytes())
+            .unwrap();
 
         assert_eq!(decrypted1, plaintext);
         assert_eq!(decrypted2, plaintext);
@@ -1,15 +1,20 @@
 // Album Layout Analyzer (Phase 2 of Import)
 //
 // Calculates the chunk layout for an album by treating all files as a single concatenated
-// byte stream divided into fixed-size chunks.
+// byte stream divided into fixed-size chunks. The chunk size is chosen per release from
+// its total size and track count (see `choose_chunk_size`).
 //
 // ## Unified Approach for All Import Types
 //
 // Both one-file-per-track and CUE/FLAC imports follow the same process:
-// 1. Concatenate all files into a virtual byte stream
+// 1. Lay all files out in a virtual byte stream
 // 2. Divide the stream into fixed-size chunks
 // 3. Calculate chunk ranges for each track
 //
+// Files are either packed back to back (`ChunkLayoutMode::Contiguous`) or each
+// track file starts on a chunk boundary (`ChunkLayoutMode::TrackAligned`), with
+// small non-track files filling the gaps that alignment leaves behind.
+//
 // The only difference is HOW we calculate track boundaries:
 // - **One-file-per-track**: Track boundaries = file boundaries in the stream
 // - **CUE/FLAC**: Track boundaries = time-based byte positions from CUE sheet
@@ -22,11 +27,19 @@
 
 use crate::cue_flac::CueFlacProcessor;
 use crate::import::types::FileToChunks;
-use crate::import::types::{CueFlacLayoutData, CueFlacMetadata, DiscoveredFile, TrackFile};
-use std::collections::HashMap;
+use crate::import::types::{
+    ChunkLayoutMode, CueFlacLayoutData, CueFlacMetadata, DiscoveredFile, TrackFile,
+};
+use std::collections::{HashMap, HashSet};
 use std::path::{Path, PathBuf};
 use tracing::debug;
 
+/// Chunks an average track is split into, so seeks and partial plays fetch little extra
+const TARGET_CHUNKS_PER_TRACK: u64 = 16;
+
+/// Upper bound on chunks per release before the chunk size grows past the per-track target
+const MAX_CHUNKS_PER_RELEASE: u64 = 4096;
+
 // FFI bindings for libFLAC seektable generation
 extern crate libflac_sys;
 
@@ -548,11 +561,19 @@ impl AlbumChunkLayout {
         discovered_files: Vec<DiscoveredFile>,
         tracks_to_files: &[TrackFile],
         chunk_size: usize,
+        layout_mode: ChunkLayoutMode,
         // Pre-parsed CUE/FLAC metadata from validation phase (None for non-CUE/FLAC imports)
         cue_flac_metadata: Option<std::collections::HashMap<PathBuf, CueFlacMetadata>>,
     ) -> Result<Self, String> {
         // Calculate how files map to chunks
-        let files_to_chunks = calculate_files_to_chunks(&discovered_files, chunk_size);
+        let files_to_chunks = match layout_mode {
+            ChunkLayoutMode::Contiguous => calculate_files_to_chunks(&discovered_files, chunk_size),
+            ChunkLayoutMode::TrackAligned => {
+                let track_paths: HashSet<&PathBuf> =
+                    tracks_to_files.iter().map(|tf| &tf.file_path).collect();
+                calculate_track_aligned_files_to_chunks(&discovered_files, &track_paths, chunk_size)
+            }
+        };
 
         // Total chunks = last chunk index + 1 (chunks are 0-indexed)
         let total_chunks = files_to_chunks
@@ -579,6 +600,28 @@ impl AlbumChunkLayout {
     }
 }
 
+/// Choose the chunk size for a release from its total size and track count.
+///
+/// Small releases get small chunks, so playing a track doesn't download much of
+/// its neighbours. Large releases get large chunks, so they don't need tens of
+/// thousands of requests. The result is a power of two within
+/// `[min_chunk_size, max_chunk_size]`.
+pub fn choose_chunk_size(
+    discovered_files: &[DiscoveredFile],
+    track_count: usize,
+    min_chunk_size: usize,
+    max_chunk_size: usize,
+) -> usize {
+    let total_bytes: u64 = discovered_files.iter().map(|f| f.size).sum();
+    let per_track = total_bytes / track_count.max(1) as u64 / TARGET_CHUNKS_PER_TRACK;
+    let per_release = total_bytes.div_ceil(MAX_CHUNKS_PER_RELEASE);
+    let chunk_size = per_track.max(per_release).max(1).next_power_of_two();
+
+    (chunk_size as usize)
+        .min(max_chunk_size)
+        .max(min_chunk_size)
+}
+
 /// Calculate file-to-chunk mappings from files discovered during import validation.
 ///
 /// Treats all files as a single concatenated byte stream, divided into fixed-size chunks.
@@ -589,26 +632,69 @@ fn calculate_files_to_chunks(files: &[DiscoveredFile], chunk_size: usize) -> Vec
     let mut files_to_chunks = Vec::new();
 
     for file in files {
-        let start_byte = total_bytes_processed;
-        let end_byte = total_bytes_processed + file.size;
-
-        let start_chunk_index = (start_byte / chunk_size as u64) as i32;
-        let end_chunk_index = ((end_byte - 1) / chunk_size as u64) as i32;
-
-        files_to_chunks.push(FileToChunks {
-            file_path: file.path.clone(),
-            start_chunk_index,
-            end_chunk_index,
-            start_byte_offset: (start_byte % chunk_size as u64) as i64,
-            end_byte_offset: ((end_byte - 1) % chunk_size as u64) as i64,
+        files_to_chunks.push(place_file(file, total_bytes_processed, chunk_size));
+        total_bytes_processed += file.size;
+    }
+
+    files_to_chunks
+}
+
+/// Calculate file-to-chunk mappings with every track file starting on a chunk boundary.
+///
+/// Track files keep their discovery order. After each one, non-track files that fit
+/// in the rest of its last chunk are packed in (first fit, in discovery order), so
+/// alignment costs at most one partial chunk of padding per track. Non-track files
+/// that never fit are appended after the last track.
+/// Mappings are returned in stream order, which is the order the producer reads them.
+fn calculate_track_aligned_files_to_chunks(
+    files: &[DiscoveredFile],
+    track_paths: &HashSet<&PathBuf>,
+    chunk_size: usize,
+) -> Vec<FileToChunks> {
+    let chunk_size_u64 = chunk_size as u64;
+    let (track_files, mut other_files): (Vec<&DiscoveredFile>, Vec<&DiscoveredFile>) =
+        files.iter().partition(|f| track_paths.contains(&f.path));
+
+    let mut files_to_chunks = Vec::with_capacity(files.len());
+    let mut stream_pos = 0u64;
+
+    for track_file in track_files {
+        stream_pos = stream_pos.div_ceil(chunk_size_u64) * chunk_size_u64;
+        files_to_chunks.push(place_file(track_file, stream_pos, chunk_size));
+        stream_pos += track_file.size;
+
+        let gap_end = stream_pos.div_ceil(chunk_size_u64) * chunk_size_u64;
+        other_files.retain(|other| {
+            if other.size > gap_end - stream_pos {
+                return true;
+            }
+            files_to_chunks.push(place_file(other, stream_pos, chunk_size));
+            stream_pos += other.size;
+            false
         });
+    }
 
-        total_bytes_processed = end_byte;
+    for other in other_files {
+        files_to_chunks.push(place_file(other, stream_pos, chunk_size));
+        stream_pos += other.size;
     }
 
     files_to_chunks
 }
 
+/// Map a file placed at `start_byte` of the release stream onto its chunks
+fn place_file(file: &DiscoveredFile, start_byte: u64, chunk_size: usize) -> FileToChunks {
+    let end_byte = start_byte + file.size;
+
+    FileToChunks {
+        file_path: file.path.clone(),
+        start_chunk_index: (start_byte / chunk_size as u64) as i32,
+        end_chunk_index: ((end_byte - 1) / chunk_size as u64) as i32,
+        start_byte_offset: (start_byte % chunk_size as u64) as i64,
+        end_byte_offset: ((end_byte - 1) % chunk_size as u64) as i64,
+    }
+}
+
 /// Build chunk→track mappings for progress tracking during import.
 ///
 /// Creates reverse mappings from chunks to tracks so we can:
@@ -787,6 +873,43 @@ fn build_chunk_track_mappings(
 mod tests {
     use super::*;
 
+    #[test]
+    fn test_choose_chunk_size_scales_with_release() {
+        const MIB: u64 = 1024 * 1024;
+        let files = |sizes: &[u64]| -> Vec<DiscoveredFile> {
+            sizes
+                .iter()
+                .enumerate()
+                .map(|(i, &size)| DiscoveredFile {
+                    path: PathBuf::from(format!("{:02}.flac", i + 1)),
+                    size,
+                })
+                .collect()
+        };
+        let (min, max) = (256 * 1024, 16 * 1024 * 1024);
+
+        // 4-track EP, 5 MiB per track: 5 MiB / 16 rounds up to 512 KiB
+        assert_eq!(
+            choose_chunk_size(&files(&[5 * MIB; 4]), 4, min, max),
+            512 * 1024
+        );
+
+        // 12-track album, 30 MiB per track: 30 MiB / 16 rounds up to 2 MiB
+        assert_eq!(
+            choose_chunk_size(&files(&[30 * MIB; 12]), 12, min, max),
+            2 * 1024 * 1024
+        );
+
+        // 50 GiB box set: bounded by the maximum
+        assert_eq!(
+            choose_chunk_size(&files(&[100 * MIB; 512]), 512, min, max),
+            max
+        );
+
+        // A single tiny file: bounded by the minimum
+        assert_eq!(choose_chunk_size(&files(&[100 * 1024]), 1, min, max), min);
+    }
+
     #[test]
     fn test_calculate_file_mappings_integration_test_sizes() {
         let chunk_size = 1024 * 1024; // 1MB
@@ -822,7 +945,14 @@ mod tests {
             },
         ];
 
-        let layout = AlbumChunkLayout::build(files, &tracks, chunk_size, None).unwrap();
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::Contiguous,
+            None,
+        )
+        .unwrap();
 
         // Verify we got 3 mappings
         assert_eq!(layout.files_to_chunks.len(), 3);
@@ -934,7 +1064,14 @@ mod tests {
             },
         ];
 
-        let layout = AlbumChunkLayout::build(files, &tracks, chunk_size, None).unwrap();
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::Contiguous,
+            None,
+        )
+        .unwrap();
 
         // All three files together = 1.2MB = 2 chunks (0 and 1)
         assert_eq!(layout.total_chunks, 2);
@@ -987,7 +1124,14 @@ mod tests {
             file_path: PathBuf::from("track1.flac"),
         }];
 
-        let layout = AlbumChunkLayout::build(files, &tracks, chunk_size, None).unwrap();
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::Contiguous,
+            None,
+        )
+        .unwrap();
 
         // cover.jpg (200KB) + track1.flac (900KB) = 1.1MB = 2 chunks
         // album.cue (5KB) continues in chunk 1
@@ -1033,7 +1177,14 @@ mod tests {
             },
         ];
 
-        let layout = AlbumChunkLayout::build(files, &tracks, chunk_size, None).unwrap();
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::Contiguous,
+            None,
+        )
+        .unwrap();
 
         // 3MB = 3 chunks
         assert_eq!(layout.total_chunks, 3);
@@ -1091,7 +1242,14 @@ mod tests {
             },
         ];
 
-        let layout = AlbumChunkLayout::build(files, &tracks, chunk_size, None).unwrap();
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::Contiguous,
+            None,
+        )
+        .unwrap();
 
         // Total: 100KB + 200KB + 800KB + 2MB = 3.1MB = 3 chunks
         assert_eq!(layout.total_chunks, 3);
@@ -1114,4 +1272,77 @@ mod tests {
         assert_eq!(chunk_2.len(), 1);
         assert_eq!(chunk_2[0], "track-3");
     }
+
+    #[test]
+    fn test_track_aligned_layout_starts_tracks_on_chunk_boundaries() {
+        let chunk_size = 1000;
+
+        let files = vec![
+            DiscoveredFile {
+                path: PathBuf::from("01.flac"),
+                size: 1_500,
+            },
+            DiscoveredFile {
+                path: PathBuf::from("02.flac"),
+                size: 2_200,
+            },
+            DiscoveredFile {
+                path: PathBuf::from("album.cue"),
+                size: 300, // fits in the tail of 01.flac's last chunk
+            },
+            DiscoveredFile {
+                path: PathBuf::from("cover.jpg"),
+                size: 900, // too big for either gap, goes at the end
+            },
+        ];
+
+        let tracks = vec![
+            TrackFile {
+                db_track_id: "track-1".to_string(),
+                file_path: PathBuf::from("01.flac"),
+            },
+            TrackFile {
+                db_track_id: "track-2".to_string(),
+                file_path: PathBuf::from("02.flac"),
+            },
+        ];
+
+        let layout = AlbumChunkLayout::build(
+            files,
+            &tracks,
+            chunk_size,
+            ChunkLayoutMode::TrackAligned,
+            None,
+        )
+        .unwrap();
+
+        let placed: Vec<(&str, i32, i64, i32)> = layout
+            .files_to_chunks
+            .iter()
+            .map(|f| {
+                (
+                    f.file_path.to_str().unwrap(),
+                    f.start_chunk_index,
+                    f.start_byte_offset,
+                    f.end_chunk_index,
+                )
+            })
+            .collect();
+        assert_eq!(
+            placed,
+            vec![
+                ("01.flac", 0, 0, 1),
+                ("album.cue", 1, 500, 1),
+                ("02.flac", 2, 0, 4),
+                ("cover.jpg", 4, 200, 5),
+            ]
+        );
+        assert_eq!(layout.total_chunks, 6);
+
+        // Neither track shares a chunk with the other
+        assert_eq!(layout.track_chunk_counts.get("track-1"), Some(&2));
+        assert_eq!(layout.track_chunk_counts.get("track-2"), Some(&3));
+        assert_eq!(layout.chunk_to_track.get(&1).unwrap(), &vec!["track-1"]);
+        assert_eq!(layout.chunk_to_track.get(&2).unwrap(), &vec!["track-2"]);
+    }
 }
@@ -500,103 +500,93 @@ fn extract_track_offsets_from_log(
     Ok((track_offsets, raw_sectors))
 }
 
-/// Calculate MusicBrainz DiscID from LOG file alone
-/// This is the most efficient method as it doesn't require CUE or audio files
-pub fn calculate_mb_discid_from_log(log_path: &Path) -> Result<String, MetadataDetectionError> {
-    info!("🎵 Calculating MusicBrainz DiscID from LOG: {:?}", log_path);
-
-    // Read LOG file - handle UTF-16 and non-UTF-8 content gracefully
-    info!("📄 Reading LOG file: {:?}", log_path);
-    let log_bytes = fs::read(log_path)?;
-    info!("📏 LOG file size: {} bytes", log_bytes.len());
+/// Where a disc's table of contents is read from for DiscID calculation
+#[derive(Debug, Clone, PartialEq)]
+pub enum DiscTocSource {
+    /// EAC/XLD rip log: track offsets and lead-out both come from the TOC table
+    Log(PathBuf),
+    /// Single-file CUE for track offsets, FLAC STREAMINFO for the lead-out
+    CueFlac { cue: PathBuf, flac: PathBuf },
+}
 
-    // Try to decode - LOG files can be UTF-16 (Windows EAC) or UTF-8
-    let log_content = if log_bytes.len() >= 2 && log_bytes[0] == 0xFF && log_bytes[1] == 0xFE {
-        // UTF-16 LE BOM
-        info!("📄 Detected UTF-16 LE encoding");
+/// Decode a rip log - LOG files can be UTF-16 (Windows EAC) or UTF-8
+fn decode_log_bytes(log_bytes: &[u8]) -> String {
+    if log_bytes.len() >= 2 && log_bytes[0] == 0xFF && log_bytes[1] == 0xFE {
+        debug!("📄 Detected UTF-16 LE encoding");
         let utf16_chars: Vec<u16> = log_bytes[2..]
             .chunks_exact(2)
             .map(|chunk| u16::from_le_bytes([chunk[0], chunk[1]]))
             .collect();
         String::from_utf16_lossy(&utf16_chars)
     } else if log_bytes.len() >= 2 && log_bytes[0] == 0xFE && log_bytes[1] == 0xFF {
-        // UTF-16 BE BOM
-        info!("📄 Detected UTF-16 BE encoding");
+        debug!("📄 Detected UTF-16 BE encoding");
         let utf16_chars: Vec<u16> = log_bytes[2..]
             .chunks_exact(2)
             .map(|chunk| u16::from_be_bytes([chunk[0], chunk[1]]))
             .collect();
         String::from_utf16_lossy(&utf16_chars)
     } else {
-        // Try UTF-8, using lossy conversion if needed
-        info!("📄 Assuming UTF-8 encoding");
-        String::from_utf8_lossy(&log_bytes).to_string()
-    };
-    info!("📄 LOG file decoded, length: {} chars", log_content.len());
+        debug!("📄 Assuming UTF-8 encoding");
+        String::from_utf8_lossy(log_bytes).to_string()
+    }
+}
+
+/// Compute the MusicBrainz DiscID for a TOC
+/// `track_offsets` and `lead_out` already include the 150-sector lead-in
+fn mb_discid_from_toc(
+    track_offsets: &[i32],
+    lead_out: i32,
+) -> Result<String, MetadataDetectionError> {
+    // The discid crate expects: offsets[0] = lead-out, offsets[1..] = track offsets
+    let mut offsets = Vec::with_capacity(track_offsets.len() + 1);
+    offsets.push(lead_out);
+    offsets.extend_from_slice(track_offsets);
+
+    debug!(
+        "📋 Offsets array (lead-out first, then tracks): {:?}",
+        offsets
+    );
+
+    let disc = discid::DiscId::put(1, &offsets).map_err(|e| {
+        MetadataDetectionError::Io(std::io::Error::other(format!(
+            "Failed to calculate DiscID: {}",
+            e
+        )))
+    })?;
+
+    Ok(disc.id().to_string())
+}
+
+/// Calculate MusicBrainz DiscID from LOG file alone
+/// This is the most efficient method as it doesn't require CUE or audio files
+pub fn calculate_mb_discid_from_log(log_path: &Path) -> Result<String, MetadataDetectionError> {
+    info!("🎵 Calculating MusicBrainz DiscID from LOG: {:?}", log_path);
+
+    let log_content = decode_log_bytes(&fs::read(log_path)?);
 
-    // Extract track offsets from log
     let (track_offsets, raw_track_sectors) = extract_track_offsets_from_log(&log_content)?;
-    info!("📊 Found {} track(s) in LOG file", track_offsets.len());
-    info!(
+    debug!(
         "📊 LOG METHOD - Raw track start sectors (before adding 150): {:?}",
         raw_track_sectors
     );
 
-    // Extract lead-out from log
     let (lead_out_sectors, raw_leadout_sector) = extract_leadout_from_log(&log_content).ok_or_else(|| {
-        warn!("⚠️ Could not extract lead-out sector from log file. Log content preview (first 500 chars):\n{}", 
+        warn!("⚠️ Could not extract lead-out sector from log file. Log content preview (first 500 chars):\n{}",
               log_content.chars().take(500).collect::<String>());
         MetadataDetectionError::Io(std::io::Error::new(
             std::io::ErrorKind::InvalidData,
             "Could not extract lead-out sector from log file",
         ))
     })?;
-    info!(
-        "📏 LOG METHOD - Raw lead-out sector (before adding 150): {}",
-        raw_leadout_sector
-    );
-    info!(
+    debug!(
         "📏 LOG METHOD - Lead-out offset: {} sectors (raw: {} + 150)",
         lead_out_sectors, raw_leadout_sector
     );
 
-    // Build offsets array in the format expected by discid:
-    // [lead_out, track1_offset, track2_offset, ...]
-    let mut offsets = Vec::with_capacity(track_offsets.len() + 1);
-    offsets.push(lead_out_sectors);
-    offsets.extend_from_slice(&track_offsets);
-
-    let first_track = 1;
-    let last_track = track_offsets.len() as i32;
-
-    info!(
-        "🎯 First track: {}, Last track: {}, Total offsets: {}",
-        first_track,
-        last_track,
-        offsets.len()
-    );
-
-    // Print all offsets for comparison
-    info!("📋 LOG METHOD - Offsets array (lead-out first, then tracks):");
-    info!("   Lead-out: {} sectors", offsets[0]);
-    for (i, offset) in offsets.iter().enumerate().skip(1) {
-        info!("   Track {}: {} sectors", i, offset);
-    }
-    info!("📋 LOG METHOD - Raw offsets array: {:?}", offsets);
-
-    // Create DiscID using discid crate
-    let disc = discid::DiscId::put(first_track, &offsets).map_err(|e| {
-        MetadataDetectionError::Io(std::io::Error::other(format!(
-            "Failed to calculate DiscID: {}",
-            e
-        )))
-    })?;
-
-    let mb_discid_str = disc.id();
-    info!("✅ MusicBrainz DiscID: {}", mb_discid_str);
-    println!("🎵 MusicBrainz DiscID result: {}", mb_discid_str);
+    let mb_discid = mb_discid_from_toc(&track_offsets, lead_out_sectors)?;
+    info!("✅ MusicBrainz DiscID from {:?}: {}", log_path, mb_discid);
 
-    Ok(mb_discid_str.to_string())
+    Ok(mb_discid)
 }
 
 /// Calculate MusicBrainz DiscID from CUE file and FLAC file
@@ -610,74 +600,65 @@ pub fn calculate_mb_discid_from_cue_flac(
         cue_path, flac_path
     );
 
-    // Read CUE file
     let cue_content = fs::read_to_string(cue_path)?;
 
-    // Extract track offsets
     let (track_offsets, raw_track_sectors) = extract_track_offsets_from_cue(&cue_content)?;
-    info!("📊 Found {} track(s) in CUE file", track_offsets.len());
-    info!(
+    debug!(
         "📊 CUE/FLAC METHOD - Raw track start sectors (before adding 150): {:?}",
         raw_track_sectors
     );
 
-    // Get FLAC duration
+    // Only the FLAC metadata blocks are read, the audio is never decoded
     let duration_seconds = get_flac_duration_seconds(flac_path)?;
-    info!("⏱️ FLAC duration: {:.2} seconds", duration_seconds);
 
     // Calculate lead-out offset: total duration in sectors + lead-in
     let raw_leadout_sector = (duration_seconds * 75.0).round() as i32;
     let lead_out_sectors = raw_leadout_sector + 150;
-    info!(
-        "📏 CUE/FLAC METHOD - Raw lead-out sector (from FLAC duration): {} sectors",
-        raw_leadout_sector
-    );
-    info!(
-        "📏 CUE/FLAC METHOD - Lead-out offset: {} sectors (raw: {} + 150)",
-        lead_out_sectors, raw_leadout_sector
+    debug!(
+        "📏 CUE/FLAC METHOD - Lead-out offset: {} sectors (raw: {} + 150, FLAC duration {:.2}s)",
+        lead_out_sectors, raw_leadout_sector, duration_seconds
     );
 
-    // Build offsets array in the format expected by discid:
-    // [lead_out, track1_offset, track2_offset, ...]
-    // The discid crate expects: offsets[0] = lead-out, offsets[1..] = track offsets
-    let mut offsets = Vec::with_capacity(track_offsets.len() + 1);
-    offsets.push(lead_out_sectors);
-    offsets.extend_from_slice(&track_offsets);
-
-    let first_track = 1;
-    let last_track = track_offsets.len() as i32;
+    let mb_discid = mb_discid_from_toc(&track_offsets, lead_out_sectors)?;
+    info!("✅ MusicBrainz DiscID from {:?}: {}", cue_path, mb_discid);
 
-    info!(
-        "🎯 First track: {}, Last track: {}, Total offsets: {}",
-        first_track,
-        last_track,
-        offsets.len()
-    );
+    Ok(mb_discid)
+}
 
-    // Print all offsets for comparison
-    info!("📋 CUE/FLAC METHOD - Offsets array (lead-out first, then tracks):");
-    info!("   Lead-out: {} sectors", offsets[0]);
-    for (i, offset) in offsets.iter().enumerate().skip(1) {
-        info!("   Track {}: {} sectors", i, offset);
+/// Calculate MusicBrainz DiscID from a single TOC source
+pub fn calculate_mb_discid(source: &DiscTocSource) -> Result<String, MetadataDetectionError> {
+    match source {
+        DiscTocSource::Log(log) => calculate_mb_discid_from_log(log),
+        DiscTocSource::CueFlac { cue, flac } => calculate_mb_discid_from_cue_flac(cue, flac),
     }
-    info!("📋 CUE/FLAC METHOD - Raw offsets array: {:?}", offsets);
-
-    // Create DiscID using discid crate
-    // The discid crate API: DiscId::put(first, offsets) where:
-    // - first = first track number (usually 1)
-    // - offsets[0] = lead-out (total sectors)
-    // - offsets[1..] = track offsets
-    let disc = discid::DiscId::put(first_track, &offsets).map_err(|e| {
-        MetadataDetectionError::Io(std::io::Error::other(format!(
-            "Failed to calculate DiscID: {}",
-            e
-        )))
-    })?;
+}
+
+/// Calculate MusicBrainz DiscIDs for many discs at once
+/// TOC extraction is file-bound and independent per disc, so sources are processed in
+/// parallel and a multi-disc release costs about as much as its slowest disc.
+/// Results are returned in the same order as `sources`.
+pub fn calculate_mb_discids(
+    sources: &[DiscTocSource],
+) -> Vec<Result<String, MetadataDetectionError>> {
+    use rayon::prelude::*;
 
-    let mb_discid_str = disc.id();
-    info!("✅ MusicBrainz DiscID calculated: {}", mb_discid_str);
+    sources.par_iter().map(calculate_mb_discid).collect()
+}
 
-    Ok(mb_discid_str.to_string())
+/// Calculate the DiscIDs of `(disc, source)` pairs in one parallel batch and return
+/// the first success in order, with its disc
+fn first_mb_discid(discs: &[(usize, DiscTocSource)]) -> Option<(usize, String)> {
+    let sources: Vec<DiscTocSource> = discs.iter().map(|(_, source)| source.clone()).collect();
+    calculate_mb_discids(&sources)
+        .into_iter()
+        .zip(discs)
+        .find_map(|(result, (disc, source))| match result {
+            Ok(id) => Some((*disc, id)),
+            Err(e) => {
+                warn!("✗ Failed to calculate MB DiscID from {:?}: {}", source, e);
+                None
+            }
+        })
 }
 
 /// Read MP3 metadata using id3
@@ -831,7 +812,6 @@ pub fn detect_metadata(folder_path: PathBuf) -> Result<FolderMetadata, MetadataD
     let mut album_sources = Vec::new();
     let mut year_sources = Vec::new();
     let mut discid: Option<String> = None;
-    let mut mb_discid: Option<String> = None;
     let mut track_count: Option<u32> = None;
 
     // Check for CUE files first (highest priority for DISCID)
@@ -884,104 +864,125 @@ pub fn detect_metadata(folder_path: PathBuf) -> Result<FolderMetadata, MetadataD
         audio_files.len()
     );
 
-    // Process CUE files
-    for cue_path in &cue_files {
-        debug!("Reading CUE file: {:?}", cue_path);
-        if let Ok(content) = fs::read_to_string(cue_path) {
-            // Check if this is a single-file CUE (true CUE/FLAC) or documentation-only
-            let is_cue_flac_release = is_single_file_cue(&content);
-
-            if !is_cue_flac_release {
-                debug!(
-                    "📄 CUE is documentation-only (multiple FILE directives): {:?}",
-                    cue_path
-                );
-            }
+    let cue_contents: Vec<(&PathBuf, String)> = cue_files
+        .iter()
+        .filter_map(|cue_path| {
+            debug!("Reading CUE file: {:?}", cue_path);
+            fs::read_to_string(cue_path)
+                .ok()
+                .map(|content| (cue_path, content))
+        })
+        .collect();
+
+    // Calculate MusicBrainz DiscIDs - only for true CUE/FLAC releases.
+    // The first disc (in CUE order) that yields an ID wins, preferring its LOG over
+    // the FLAC fallback. LOGs are cheap to read, so every disc's LOG goes into one
+    // parallel batch first; FLACs are only decoded for the discs before the first
+    // LOG hit, since a later disc can't win.
+    let mut log_discs = Vec::new();
+    let mut cue_flac_discs = Vec::new();
+    let mut disc_count = 0;
+    for (cue_path, content) in &cue_contents {
+        if !is_single_file_cue(content) {
+            continue;
+        }
 
-            // Extract FreeDB DISCID (useful regardless of CUE type)
-            if discid.is_none() {
-                discid = extract_discid_from_cue(&content);
-                if let Some(ref id) = discid {
-                    info!("💿 Found FreeDB DISCID in CUE: {}", id);
-                }
-            }
+        let disc = disc_count;
+        disc_count += 1;
+        let cue_stem = cue_path.file_stem().and_then(|s| s.to_str()).unwrap_or("");
 
-            // Calculate MusicBrainz DiscID - only for true CUE/FLAC releases
-            if mb_discid.is_none() && is_cue_flac_release {
-                let cue_stem = cue_path.file_stem().and_then(|s| s.to_str()).unwrap_or("");
+        if let Some(log_path) = log_files
+            .iter()
+            .find(|p| p.file_stem().and_then(|s| s.to_str()) == Some(cue_stem))
+        {
+            log_discs.push((disc, DiscTocSource::Log(log_path.clone())));
+        } else {
+            debug!("No matching LOG file found for CUE stem: {}", cue_stem);
+        }
 
-                // Try matching log file first (more efficient, no audio download needed)
-                if let Some(log_path) = log_files
-                    .iter()
-                    .find(|p| p.file_stem().and_then(|s| s.to_str()) == Some(cue_stem))
-                {
-                    info!(
-                        "🔍 Attempting MB DiscID calculation from LOG file: {:?}",
-                        log_path
-                    );
-                    match calculate_mb_discid_from_log(log_path) {
-                        Ok(id) => {
-                            info!("✅ Calculated MusicBrainz DiscID from log: {}", id);
-                            mb_discid = Some(id);
-                        }
-                        Err(e) => {
-                            warn!("✗ Failed to calculate MB DiscID from log: {}", e);
-                            info!("🔄 Will try FLAC file as fallback if available");
-                        }
-                    }
-                } else {
-                    debug!("No matching LOG file found for CUE stem: {}", cue_stem);
-                }
+        if let Some(flac_path) = find_matching_flac_for_cue(cue_path, content, &audio_files) {
+            cue_flac_discs.push((
+                disc,
+                DiscTocSource::CueFlac {
+                    cue: (*cue_path).clone(),
+                    flac: flac_path.clone(),
+                },
+            ));
+        }
+    }
 
-                // Fall back to FLAC if log didn't work
-                if mb_discid.is_none() {
-                    if let Some(flac_path) =
-                        find_matching_flac_for_cue(cue_path, &content, &audio_files)
-                    {
-                        info!("📀 Found matching FLAC file: {:?}", flac_path);
-                        match calculate_mb_discid_from_cue_flac(cue_path, flac_path) {
-                            Ok(id) => {
-                                info!("✅ Calculated MusicBrainz DiscID from FLAC: {}", id);
-                                mb_discid = Some(id);
-                            }
-                            Err(e) => {
-                                warn!("✗ Failed to calculate MB DiscID from FLAC: {}", e);
-                            }
-                        }
-                    }
-                }
+    if disc_count > 0 {
+        info!(
+            "🔍 Calculating MB DiscIDs for {} disc(s) from {} LOG file(s)",
+            disc_count,
+            log_discs.len()
+        );
+    }
+
+    let log_hit = first_mb_discid(&log_discs);
+    let fallback_discs = log_hit.as_ref().map_or(disc_count, |(disc, _)| *disc);
+    cue_flac_discs.retain(|(disc, _)| *disc < fallback_discs);
+
+    if !cue_flac_discs.is_empty() {
+        info!(
+            "🔍 Calculating MB DiscIDs from CUE/FLAC for {} disc(s) without a usable LOG",
+            cue_flac_discs.len()
+        );
+    }
+
+    let mb_discid = first_mb_discid(&cue_flac_discs)
+        .or(log_hit)
+        .map(|(_, id)| id);
+
+    // Process CUE files
+    for (cue_path, content) in &cue_contents {
+        // Check if this is a single-file CUE (true CUE/FLAC) or documentation-only
+        let is_cue_flac_release = is_single_file_cue(content);
+
+        if !is_cue_flac_release {
+            debug!(
+                "📄 CUE is documentation-only (multiple FILE directives): {:?}",
+                cue_path
+            );
+        }
+
+        // Extract FreeDB DISCID (useful regardless of CUE type)
+        if discid.is_none() {
+            discid = extract_discid_from_cue(content);
+            if let Some(ref id) = discid {
+                info!("💿 Found FreeDB DISCID in CUE: {}", id);
             }
+        }
 
-            // Extract year from REM DATE (useful regardless of CUE type)
-            if year_sources.is_empty() {
-                if let Some(y) = extract_year_from_cue(&content) {
-                    year_sources.push((y, 0.9)); // High confidence from CUE
-                }
+        // Extract year from REM DATE (useful regardless of CUE type)
+        if year_sources.is_empty() {
+            if let Some(y) = extract_year_from_cue(&content) {
+                year_sources.push((y, 0.9)); // High confidence from CUE
             }
+        }
 
-            // Parse CUE sheet for title/performer - ONLY for true CUE/FLAC releases
-            // Documentation-only CUEs often have per-disc titles like "Electric Ladyland (Disc 1)"
-            // which we don't want to use as the album name
-            if is_cue_flac_release {
-                match CueFlacProcessor::parse_cue_sheet(cue_path) {
-                    Ok(cue_sheet) => {
-                        info!(
-                            "✓ Parsed CUE: artist='{}', album='{}', tracks={}",
-                            cue_sheet.performer,
-                            cue_sheet.title,
-                            cue_sheet.tracks.len()
-                        );
-                        if !cue_sheet.performer.is_empty() {
-                            artist_sources.push((cue_sheet.performer.clone(), 0.9));
-                        }
-                        if !cue_sheet.title.is_empty() {
-                            album_sources.push((cue_sheet.title.clone(), 0.9));
-                        }
-                        track_count = Some(cue_sheet.tracks.len() as u32);
+        // Parse CUE sheet for title/performer - ONLY for true CUE/FLAC releases
+        // Documentation-only CUEs often have per-disc titles like "Electric Ladyland (Disc 1)"
+        // which we don't want to use as the album name
+        if is_cue_flac_release {
+            match CueFlacProcessor::parse_cue_sheet(cue_path) {
+                Ok(cue_sheet) => {
+                    info!(
+                        "✓ Parsed CUE: artist='{}', album='{}', tracks={}",
+                        cue_sheet.performer,
+                        cue_sheet.title,
+                        cue_sheet.tracks.len()
+                    );
+                    if !cue_sheet.performer.is_empty() {
+                        artist_sources.push((cue_sheet.performer.clone(), 0.9));
                     }
-                    Err(e) => {
-                        warn!("✗ Failed to parse CUE file {:?}: {}", cue_path, e);
+                    if !cue_sheet.title.is_empty() {
+                        album_sources.push((cue_sheet.title.clone(), 0.9));
                     }
+                    track_count = Some(cue_sheet.tracks.len() as u32);
+                }
+                Err(e) => {
+                    warn!("✗ Failed to parse CUE file {:?}: {}", cue_path, e);
                 }
             }
         }
@@ -1325,4 +1326,26 @@ mod tests {
             }
         }
     }
+
+    #[test]
+    fn test_calculate_mb_discids_keeps_source_order() {
+        let log_path = PathBuf::from("tests/fixtures/acdc_back_in_black.log");
+        if !log_path.exists() {
+            eprintln!("LOG file not found, skipping test");
+            return;
+        }
+
+        let sources = vec![
+            DiscTocSource::Log(PathBuf::from("tests/fixtures/missing.log")),
+            DiscTocSource::Log(log_path.clone()),
+            DiscTocSource::Log(log_path.clone()),
+        ];
+        let results = calculate_mb_discids(&sources);
+
+        let expected = calculate_mb_discid_from_log(&log_path).unwrap();
+        assert_eq!(results.len(), 3);
+        assert!(results[0].is_err());
+        assert_eq!(results[1].as_ref().unwrap(), &expected);
+        assert_eq!(results[2].as_ref().unwrap(), &expected);
+    }
 }
@@ -9,8 +9,9 @@ use crate::discogs::DiscogsRelease;
 use crate::import::cover_art::download_cover_art_to_bae_folder;
 use crate::import::discogs_parser::parse_discogs_release;
 use crate::import::musicbrainz_parser::fetch_and_parse_mb_release;
+use crate::import::pipeline::stats::PipelineStats;
 use crate::import::progress::ImportProgressHandle;
-use crate::import::track_to_file_mapper::map_tracks_to_files;
+use crate::import::track_to_file_mapper::TrackFileIndexCache;
 use crate::import::types::{
     DiscoveredFile, ImportCommand, ImportProgress, ImportRequest, TorrentSource, TrackFile,
 };
@@ -27,7 +28,11 @@ pub struct ImportServiceHandle {
     pub requests_tx: mpsc::UnboundedSender<ImportCommand>,
     pub progress_handle: ImportProgressHandle,
     pub library_manager: SharedLibraryManager,
+    /// Stage counters of the import pipeline, for measuring throughput
+    pub pipeline_stats: PipelineStats,
     pub runtime_handle: tokio::runtime::Handle,
+    /// Index of the last folder's files, shared by the candidate releases tried on it
+    track_file_indexes: TrackFileIndexCache,
 }
 
 /// Torrent-specific metadata for import
@@ -56,6 +61,7 @@ impl ImportServiceHandle {
         requests_tx: mpsc::UnboundedSender<ImportCommand>,
         progress_rx: mpsc::UnboundedReceiver<ImportProgress>,
         library_manager: SharedLibraryManager,
+        pipeline_stats: PipelineStats,
         runtime_handle: tokio::runtime::Handle,
     ) -> Self {
         let progress_handle = ImportProgressHandle::new(progress_rx, runtime_handle.clone());
@@ -64,7 +70,9 @@ impl ImportServiceHandle {
             requests_tx,
             progress_handle,
             library_manager,
+            pipeline_stats,
             runtime_handle,
+            track_file_indexes: TrackFileIndexCache::default(),
         }
     }
 
@@ -188,7 +196,10 @@ impl ImportServiceHandle {
         let discovered_files = discover_folder_files(&folder)?;
 
         // 3. Build track-to-file mapping (validates and parses CUE sheets if present)
-        let mapping_result = map_tracks_to_files(&db_tracks, &discovered_files).await?;
+        let mapping_result = self
+            .track_file_indexes
+            .get_or_build(&discovered_files)?
+            .map_tracks(&db_tracks)?;
         let tracks_to_files = mapping_result.track_files.clone();
         let cue_flac_metadata = mapping_result.cue_flac_metadata.clone();
 
@@ -335,7 +346,10 @@ impl ImportServiceHandle {
         // Build track-to-file mapping
         // Note: For torrents, we'll need to wait for files to download or map based on filenames
         // For now, this is a simplified version that assumes files match by name
-        let mapping_result = map_tracks_to_files(&db_tracks, &discovered_files).await?;
+        let mapping_result = self
+            .track_file_indexes
+            .get_or_build(&discovered_files)?
+            .map_tracks(&db_tracks)?;
         let tracks_to_files = mapping_result.track_files.clone();
         // Note: cue_flac_metadata will be re-parsed after torrent download completes
 
@@ -1,6 +1,7 @@
-use crate::db::{DbAudioFormat, DbFile, DbTrackChunkCoords};
+use crate::db::{DbAudioFormat, DbFile, DbTorrentPieceMap, DbTrackChunkCoords};
 use crate::import::types::{CueFlacLayoutData, FileToChunks, TrackFile};
 use crate::library::LibraryManager;
+use crate::torrent::piece_mapper::{PieceMap, TorrentPieceMapper};
 use std::collections::HashMap;
 use std::path::PathBuf;
 use tracing::debug;
@@ -24,203 +25,64 @@ impl<'a> MetadataPersister<'a> {
         Self { library }
     }
 
-    /// Persist metadata for a single track.
+    /// Persist metadata for a set of tracks.
     ///
-    /// Persists the track's chunk coordinates and audio format needed for playback.
-    /// This is called immediately when a track's chunks complete, before marking it complete.
+    /// Persists each track's chunk coordinates and audio format needed for playback.
+    /// This is called immediately when a chunk completes one or more tracks, before
+    /// marking them complete. All rows are written in one transaction, with one batched
+    /// insert per table.
     ///
-    /// Returns Ok(()) if the track's metadata was successfully persisted.
-    pub async fn persist_track_metadata(
+    /// Returns Ok(()) if the tracks' metadata was successfully persisted.
+    pub async fn persist_tracks_metadata(
         &self,
-        _release_id: &str,
-        track_id: &str,
+        track_ids: &[String],
         track_files: &[TrackFile],
         files_to_chunks: &[FileToChunks],
-        _chunk_size_bytes: usize,
+        chunk_size_bytes: usize,
         cue_flac_data: &HashMap<PathBuf, CueFlacLayoutData>,
     ) -> Result<(), String> {
-        // Find the TrackFile for this track
-        let track_file = track_files
-            .iter()
-            .find(|tf| tf.db_track_id == track_id)
-            .ok_or_else(|| format!("Track {} not found in track_files", track_id))?;
-
-        // Find the FileToChunks for this track's file
-        let file_to_chunks = files_to_chunks
-            .iter()
-            .find(|ftc| ftc.file_path == track_file.file_path)
-            .ok_or_else(|| {
-                format!(
-                    "No chunk mapping found for file: {}",
-                    track_file.file_path.display()
-                )
-            })?;
-
-        let format = track_file
-            .file_path
-            .extension()
-            .and_then(|ext| ext.to_str())
-            .unwrap_or("unknown")
-            .to_lowercase();
-
-        // Check if this is part of a CUE/FLAC file
-        // A CUE/FLAC file will have multiple tracks mapping to the same file
-        let is_cue_flac = track_files
-            .iter()
-            .filter(|tf| tf.file_path == track_file.file_path)
-            .count()
-            > 1
-            && format == "flac";
-
-        if is_cue_flac {
-            // Get CUE/FLAC layout data
-            let cue_flac_layout = cue_flac_data.get(&track_file.file_path).ok_or_else(|| {
-                format!(
-                    "No pre-calculated CUE/FLAC data found for {}",
-                    track_file.file_path.display()
-                )
-            })?;
-
-            // Find the CUE track corresponding to this track
-            let cue_track = cue_flac_layout
-                .cue_sheet
-                .tracks
-                .iter()
-                .enumerate()
-                .find_map(|(idx, ct)| {
-                    // Match by position in the file (assumes order matches)
-                    track_files
-                        .iter()
-                        .filter(|tf| tf.file_path == track_file.file_path)
-                        .nth(idx)
-                        .filter(|tf| tf.db_track_id == track_id)
-                        .map(|_| ct)
-                })
-                .ok_or_else(|| {
-                    format!(
-                        "Could not find CUE track corresponding to track {}",
-                        track_id
-                    )
-                })?;
-
-            // Get pre-calculated chunk range for this track
-            let (start_chunk_index, end_chunk_index) = cue_flac_layout
-                .track_chunk_ranges
-                .get(track_id)
-                .ok_or_else(|| format!("No chunk range found for track {}", track_id))?;
-
-            // Get the actual byte positions from album_chunk_layout
-            // These are stored in the track_byte_ranges map
-            let (start_byte, end_byte) = cue_flac_layout
-                .track_byte_ranges
-                .get(track_id)
-                .ok_or_else(|| format!("No byte range found for track {}", track_id))?;
-
-            // Convert absolute byte positions to offsets within the chunk range
-            let chunk_size_i64 = _chunk_size_bytes as i64;
-            let start_byte_offset = start_byte % chunk_size_i64;
-            let end_byte_offset = end_byte % chunk_size_i64;
-
-            debug!(
-                "Track {}: storing byte offsets {}-{} within chunks {}-{}",
-                track_id, start_byte_offset, end_byte_offset, start_chunk_index, end_chunk_index
-            );
-
-            // For CUE/FLAC, we store the original album FLAC headers and seektable
-            // Playback will download track's chunks, prepend headers,
-            // and use Symphonia to seek to the track's time position and decode
-            // The seektable enables accurate seeking by mapping sample positions to byte positions
-            let flac_seektable = if let Some(ref seektable) = cue_flac_layout.seektable {
-                Some(
-                    bincode::serialize(seektable)
-                        .map_err(|e| format!("Failed to serialize seektable: {}", e))?,
-                )
-            } else {
-                None
-            };
+        if track_ids.is_empty() {
+            return Ok(());
+        }
 
-            let audio_format = DbAudioFormat::new_with_seektable(
-                track_id,
-                "flac",
-                Some(cue_flac_layout.flac_headers.headers.clone()), // Original album headers
-                flac_seektable, // Serialized seektable for accurate seeking
-                true,           // needs_headers = true for CUE/FLAC
-            );
-            self.library
-                .add_audio_format(&audio_format)
-                .await
-                .map_err(|e| format!("Failed to insert audio format: {}", e))?;
-
-            // Create track chunk coordinates
-            // Byte offsets: which chunks and bytes within them contain the track
-            // Time offsets: where to seek with Symphonia during decode
-            let coords = DbTrackChunkCoords::new(
-                track_id,
-                *start_chunk_index,
-                *end_chunk_index,
-                start_byte_offset,
-                end_byte_offset,
-                cue_track.start_time_ms as i64,
-                cue_track.end_time_ms.unwrap_or(0) as i64,
-            );
-            self.library
-                .add_track_chunk_coords(&coords)
-                .await
-                .map_err(|e| format!("Failed to insert track chunk coords: {}", e))?;
-        } else {
-            // Regular one-file-per-track: use single file logic
-            // Create audio format (no headers for one-file-per-track)
-            let audio_format = DbAudioFormat::new(
-                track_id, &format, None,  // No headers - they're already in the chunks
-                false, // needs_headers = false for regular files
-            );
-            self.library
-                .add_audio_format(&audio_format)
-                .await
-                .map_err(|e| format!("Failed to insert audio format: {}", e))?;
-
-            // Create track chunk coordinates
-            // For one-file-per-track, the track boundaries = file boundaries in the stream
-            let coords = DbTrackChunkCoords::new(
+        let mut audio_formats = Vec::with_capacity(track_ids.len());
+        let mut coords = Vec::with_capacity(track_ids.len());
+        for track_id in track_ids {
+            let (audio_format, track_coords) = build_track_metadata(
                 track_id,
-                file_to_chunks.start_chunk_index,
-                file_to_chunks.end_chunk_index,
-                file_to_chunks.start_byte_offset,
-                file_to_chunks.end_byte_offset,
-                0, // start_time_ms: 0 = beginning (metadata only)
-                0, // end_time_ms: 0 = end (metadata only)
-            );
-            self.library
-                .add_track_chunk_coords(&coords)
-                .await
-                .map_err(|e| format!("Failed to insert track chunk coords: {}", e))?;
+                track_files,
+                files_to_chunks,
+                chunk_size_bytes,
+                cue_flac_data,
+            )?;
+            audio_formats.push(audio_format);
+            coords.push(track_coords);
         }
 
+        self.library
+            .add_track_metadata_batch(&audio_formats, &coords)
+            .await
+            .map_err(|e| format!("Failed to insert track metadata: {}", e))?;
+
         Ok(())
     }
 
     /// Persist release-level metadata to database.
     ///
-    /// Creates DbFile records for all files in the release (for export metadata).
+    /// Creates DbFile records for all files in the release (for export metadata),
+    /// including where each file starts in the release's chunk stream.
     /// Track-level metadata (DbAudioFormat and DbTrackChunkCoords) is persisted
-    /// per-track as tracks complete via `persist_track_metadata()`.
+    /// as tracks complete via `persist_tracks_metadata()`.
     pub async fn persist_release_metadata(
         &self,
         release_id: &str,
-        track_files: &[TrackFile],
         files_to_chunks: &[FileToChunks],
+        chunk_size_bytes: usize,
     ) -> Result<(), String> {
-        // Collect unique file paths from tracks
-        let mut unique_file_paths: std::collections::HashSet<&PathBuf> =
-            track_files.iter().map(|tf| &tf.file_path).collect();
-
-        // Also include files that might not be associated with tracks (cover.jpg, etc.)
+        // Create DbFile record for each file in the layout (tracks, cover.jpg, etc.)
+        let mut db_files = Vec::with_capacity(files_to_chunks.len());
         for file_to_chunks in files_to_chunks {
-            unique_file_paths.insert(&file_to_chunks.file_path);
-        }
-
-        // Create DbFile record for each unique file
-        for file_path in unique_file_paths {
+            let file_path = &file_to_chunks.file_path;
             let file_metadata = std::fs::metadata(file_path)
                 .map_err(|e| format!("Failed to read file metadata: {}", e))?;
             let file_size = file_metadata.len() as i64;
@@ -229,15 +91,227 @@ impl<'a> MetadataPersister<'a> {
                 .and_then(|ext| ext.to_str())
                 .unwrap_or("unknown")
                 .to_lowercase();
+            let stream_offset = file_to_chunks.start_chunk_index as i64 * chunk_size_bytes as i64
+                + file_to_chunks.start_byte_offset;
 
             let filename = file_path.file_name().unwrap().to_str().unwrap();
-            let db_file = DbFile::new(release_id, filename, file_size, &format);
-            self.library
-                .add_file(&db_file)
-                .await
-                .map_err(|e| format!("Failed to insert file: {}", e))?;
+            db_files.push(DbFile::new(
+                release_id,
+                filename,
+                file_size,
+                &format,
+                stream_offset,
+            ));
+        }
+
+        self.library
+            .add_files(&db_files)
+            .await
+            .map_err(|e| format!("Failed to insert files: {}", e))?;
+
+        Ok(())
+    }
+
+    /// Persist the piece map for a release imported from a torrent.
+    ///
+    /// The release's chunk stream is the torrent's files concatenated in torrent
+    /// order, so every piece maps onto a contiguous run of release chunks. The
+    /// whole map is encoded into a single row so that seeding can serve pieces
+    /// straight from the release chunks.
+    pub async fn persist_torrent_piece_map(&self, release_id: &str) -> Result<(), String> {
+        let torrent = self
+            .library
+            .get_torrent_by_release(release_id)
+            .await
+            .map_err(|e| format!("Failed to load torrent: {}", e))?
+            .ok_or_else(|| format!("No torrent found for release {}", release_id))?;
+
+        let chunks = self
+            .library
+            .get_chunks_for_release(release_id)
+            .await
+            .map_err(|e| format!("Failed to load chunks: {}", e))?;
+
+        let chunk_size_bytes = self
+            .library
+            .get_release_chunk_size(release_id)
+            .await
+            .map_err(|e| format!("Failed to load chunk size: {}", e))?;
+
+        let piece_map = PieceMap::encode(&TorrentPieceMapper::new(
+            torrent.piece_length as usize,
+            chunk_size_bytes,
+            torrent.num_pieces as usize,
+            torrent.total_size_bytes as usize,
+        ));
+
+        if let Some(&last_chunk) = piece_map.referenced_chunks().last() {
+            if last_chunk >= chunks.len() {
+                return Err(format!(
+                    "Torrent references chunk {} but release has {} chunks",
+                    last_chunk,
+                    chunks.len()
+                ));
+            }
         }
 
+        self.library
+            .insert_torrent_piece_map(&DbTorrentPieceMap::new(&torrent.id, piece_map.into_bytes()))
+            .await
+            .map_err(|e| format!("Failed to insert torrent piece map: {}", e))?;
+
         Ok(())
     }
 }
+
+/// Build the audio format and chunk coordinates for one track.
+fn build_track_metadata(
+    track_id: &str,
+    track_files: &[TrackFile],
+    files_to_chunks: &[FileToChunks],
+    chunk_size_bytes: usize,
+    cue_flac_data: &HashMap<PathBuf, CueFlacLayoutData>,
+) -> Result<(DbAudioFormat, DbTrackChunkCoords), String> {
+    // Find the TrackFile for this track
+    let track_file = track_files
+        .iter()
+        .find(|tf| tf.db_track_id == track_id)
+        .ok_or_else(|| format!("Track {} not found in track_files", track_id))?;
+
+    // Find the FileToChunks for this track's file
+    let file_to_chunks = files_to_chunks
+        .iter()
+        .find(|ftc| ftc.file_path == track_file.file_path)
+        .ok_or_else(|| {
+            format!(
+                "No chunk mapping found for file: {}",
+                track_file.file_path.display()
+            )
+        })?;
+
+    let format = track_file
+        .file_path
+        .extension()
+        .and_then(|ext| ext.to_str())
+        .unwrap_or("unknown")
+        .to_lowercase();
+
+    // Check if this is part of a CUE/FLAC file
+    // A CUE/FLAC file will have multiple tracks mapping to the same file
+    let is_cue_flac = track_files
+        .iter()
+        .filter(|tf| tf.file_path == track_file.file_path)
+        .count()
+        > 1
+        && format == "flac";
+
+    if is_cue_flac {
+        // Get CUE/FLAC layout data
+        let cue_flac_layout = cue_flac_data.get(&track_file.file_path).ok_or_else(|| {
+            format!(
+                "No pre-calculated CUE/FLAC data found for {}",
+                track_file.file_path.display()
+            )
+        })?;
+
+        // Find the CUE track corresponding to this track
+        let cue_track = cue_flac_layout
+            .cue_sheet
+            .tracks
+            .iter()
+            .enumerate()
+            .find_map(|(idx, ct)| {
+                // Match by position in the file (assumes order matches)
+                track_files
+                    .iter()
+                    .filter(|tf| tf.file_path == track_file.file_path)
+                    .nth(idx)
+                    .filter(|tf| tf.db_track_id == track_id)
+                    .map(|_| ct)
+            })
+            .ok_or_else(|| {
+                format!(
+                    "Could not find CUE track corresponding to track {}",
+                    track_id
+                )
+            })?;
+
+        // Get pre-calculated chunk range for this track
+        let (start_chunk_index, end_chunk_index) = cue_flac_layout
+            .track_chunk_ranges
+            .get(track_id)
+            .ok_or_else(|| format!("No chunk range found for track {}", track_id))?;
+
+        // Get the actual byte positions from album_chunk_layout
+        // These are stored in the track_byte_ranges map
+        let (start_byte, end_byte) = cue_flac_layout
+            .track_byte_ranges
+            .get(track_id)
+            .ok_or_else(|| format!("No byte range found for track {}", track_id))?;
+
+        // Convert absolute byte positions to offsets within the chunk range
+        let chunk_size_i64 = chunk_size_bytes as i64;
+        let start_byte_offset = start_byte % chunk_size_i64;
+        let end_byte_offset = end_byte % chunk_size_i64;
+
+        debug!(
+            "Track {}: storing byte offsets {}-{} within chunks {}-{}",
+            track_id, start_byte_offset, end_byte_offset, start_chunk_index, end_chunk_index
+        );
+
+        // For CUE/FLAC, we store the original album FLAC headers and seektable
+        // Playback will download track's chunks, prepend headers,
+        // and use Symphonia to seek to the track's time position and decode
+        // The seektable enables accurate seeking by mapping sample positions to byte positions
+        let flac_seektable = if let Some(ref seektable) = cue_flac_layout.seektable {
+            Some(
+                bincode::serialize(seektable)
+                    .map_err(|e| format!("Failed to serialize seektable: {}", e))?,
+            )
+        } else {
+            None
+        };
+
+        let audio_format = DbAudioFormat::new_with_seektable(
+            track_id,
+            "flac",
+            Some(cue_flac_layout.flac_headers.headers.clone()), // Original album headers
+            flac_seektable, // Serialized seektable for accurate seeking
+            true,           // needs_headers = true for CUE/FLAC
+        );
+
+        // Create track chunk coordinates
+        // Byte offsets: which chunks and bytes within them contain the track
+        // Time offsets: where to seek with Symphonia during decode
+        let coords = DbTrackChunkCoords::new(
+            track_id,
+            *start_chunk_index,
+            *end_chunk_index,
+            start_byte_offset,
+            end_byte_offset,
+            cue_track.start_time_ms as i64,
+            cue_track.end_time_ms.unwrap_or(0) as i64,
+        );
+        Ok((audio_format, coords))
+    } else {
+        // Regular one-file-per-track: use single file logic
+        // Create audio format (no headers for one-file-per-track)
+        let audio_format = DbAudioFormat::new(
+            track_id, &format, None,  // No headers - they're already in the chunks
+            false, // needs_headers = false for regular files
+        );
+
+        // Create track chunk coordinates
+        // For one-file-per-track, the track boundaries = file boundaries in the stream
+        let coords = DbTrackChunkCoords::new(
+            track_id,
+            file_to_chunks.start_chunk_index,
+            file_to_chunks.end_chunk_index,
+            file_to_chunks.start_byte_offset,
+            file_to_chunks.end_byte_offset,
+            0, // start_time_ms: 0 = beginning (metadata only)
+            0, // end_time_ms: 0 = end (metadata only)
+        );
+        Ok((audio_format, coords))
+    }
+}
@@ -29,6 +29,7 @@
 // - `ImportHandle`: Send requests and subscribe to progress
 // - `ImportRequest`: Album import requests
 // - `ImportProgress`: Real-time progress updates with phase information
+// - `PipelineStats`: Per-stage busy time and concurrency of the pipeline
 
 mod album_chunk_layout;
 pub mod cover_art;
@@ -37,7 +38,7 @@ mod discogs_parser;
 mod folder_metadata_detector;
 pub(crate) mod folder_scanner;
 mod handle;
-mod metadata_persister;
+pub(crate) mod metadata_persister;
 mod musicbrainz_parser;
 mod pipeline;
 mod progress;
@@ -48,12 +49,13 @@ mod types;
 // Public API exports
 pub use discogs_matcher::{rank_discogs_matches, rank_mb_matches, MatchCandidate, MatchSource};
 pub use folder_metadata_detector::{
-    calculate_mb_discid_from_cue_flac, calculate_mb_discid_from_log, detect_folder_contents,
-    detect_metadata, FolderMetadata,
+    calculate_mb_discid_from_cue_flac, calculate_mb_discid_from_log, calculate_mb_discids,
+    detect_folder_contents, detect_metadata, DiscTocSource, FolderMetadata,
 };
 pub use folder_scanner::{
     AudioContent, CategorizedFiles, DetectedRelease, ScannedCueFlacPair, ScannedFile,
 };
 pub use handle::{ImportServiceHandle, TorrentFileMetadata, TorrentImportMetadata};
+pub use pipeline::stats::{PipelineSnapshot, PipelineStage, PipelineStats, StageSnapshot};
 pub use service::{ImportConfig, ImportService};
-pub use types::{ImportProgress, ImportRequest, TorrentSource};
+pub use types::{ChunkLayoutMode, ImportProgress, ImportRequest, TorrentSource};
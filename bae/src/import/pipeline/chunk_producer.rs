@@ -3,29 +3,77 @@
 // Reads files sequentially and produces chunks for the import pipeline.
 // Uses pre-calculated file mappings to ensure chunk production matches layout analysis.
 
+use crate::import::pipeline::stats::{PipelineStage, PipelineStats};
 use crate::import::pipeline::ChunkData;
 use crate::import::types::FileToChunks;
+use crate::memory::{MemoryGovernor, MemoryLease};
 use tokio::io::{AsyncReadExt, BufReader};
 use tokio::sync::mpsc;
 use uuid::Uuid;
 
 /// Read files sequentially and stream chunks as they're produced.
 ///
-/// Uses the pre-calculated file_mappings to know exactly which chunks each file spans.
-/// This ensures chunk production matches the layout analysis done in calculate_file_mappings().
+/// Uses the pre-calculated file_mappings to know exactly where each file starts.
+/// This ensures chunk production matches the layout analysis done in AlbumChunkLayout::build().
 ///
-/// Files are concatenated into a single byte stream divided into fixed-size chunks.
-/// Chunks are sent as soon as they're complete, allowing downstream processing to start.
+/// Files are written into a single byte stream divided into fixed-size chunks, in
+/// stream order. Any gap before a file's start (left by track-aligned layouts) is
+/// zero-filled. Chunks are sent as soon as they're complete, allowing downstream
+/// processing to start.
+///
+/// Each chunk buffer is leased from `memory` before it is filled, so reading waits
+/// while the chunks already in the pipeline use up the budget.
 pub async fn produce_chunk_stream_from_files(
     files_to_chunks: Vec<FileToChunks>,
     chunk_size: usize,
+    memory: MemoryGovernor,
+    stats: PipelineStats,
     chunk_tx: mpsc::Sender<Result<ChunkData, String>>,
 ) {
+    let mut current_chunk_lease = memory.acquire(chunk_size as u64).await;
     let mut current_chunk_buffer = Vec::with_capacity(chunk_size);
     let mut current_chunk_index = 0i32;
 
     // Iterate through files using file_mappings (which already did the chunking calculation)
     for file_to_chunks in files_to_chunks {
+        let file_start = file_to_chunks.start_chunk_index as u64 * chunk_size as u64
+            + file_to_chunks.start_byte_offset as u64;
+        let stream_pos =
+            current_chunk_index as u64 * chunk_size as u64 + current_chunk_buffer.len() as u64;
+
+        if file_start < stream_pos {
+            let _ = chunk_tx
+                .send(Err(format!(
+                    "File {:?} starts at byte {} but the stream is already at byte {}",
+                    file_to_chunks.file_path, file_start, stream_pos
+                )))
+                .await;
+            return;
+        }
+
+        // Zero-fill up to the file's start
+        let mut padding = file_start - stream_pos;
+        while padding > 0 {
+            let fill = padding.min((chunk_size - current_chunk_buffer.len()) as u64);
+            current_chunk_buffer.resize(current_chunk_buffer.len() + fill as usize, 0);
+            padding -= fill;
+
+            if current_chunk_buffer.len() == chunk_size {
+                let chunk = finalize_chunk(
+                    current_chunk_index,
+                    current_chunk_buffer,
+                    current_chunk_lease,
+                );
+                stats.chunk_queued();
+                if chunk_tx.send(Ok(chunk)).await.is_err() {
+                    return;
+                }
+                current_chunk_index += 1;
+                current_chunk_lease = memory.acquire(chunk_size as u64).await;
+                current_chunk_buffer = Vec::with_capacity(chunk_size);
+            }
+        }
+
         let file_handle = match tokio::fs::File::open(&file_to_chunks.file_path).await {
             Ok(f) => f,
             Err(e) => {
@@ -42,11 +90,20 @@ pub async fn produce_chunk_stream_from_files(
         let mut reader = BufReader::new(file_handle);
 
         loop {
+            // Read straight into the chunk buffer, which has room for the rest of the chunk
             let space_remaining = chunk_size - current_chunk_buffer.len();
-            let mut temp_buffer = vec![0u8; space_remaining];
+            let read_timer = stats.start(PipelineStage::Read);
+            let read_result = (&mut reader)
+                .take(space_remaining as u64)
+                .read_buf(&mut current_chunk_buffer)
+                .await;
+            drop(read_timer);
 
-            let bytes_read = match reader.read(&mut temp_buffer).await {
-                Ok(n) => n,
+            let bytes_read = match read_result {
+                Ok(n) => {
+                    stats.record_read(n);
+                    n
+                }
                 Err(e) => {
                     let _ = chunk_tx
                         .send(Err(format!("Failed to read from file: {}", e)))
@@ -60,17 +117,20 @@ pub async fn produce_chunk_stream_from_files(
                 break;
             }
 
-            // Add the bytes we read to current chunk
-            current_chunk_buffer.extend_from_slice(&temp_buffer[..bytes_read]);
-
             // If chunk is full, send it and start a new one
             if current_chunk_buffer.len() == chunk_size {
-                let chunk = finalize_chunk(current_chunk_index, current_chunk_buffer);
+                let chunk = finalize_chunk(
+                    current_chunk_index,
+                    current_chunk_buffer,
+                    current_chunk_lease,
+                );
+                stats.chunk_queued();
                 if chunk_tx.send(Ok(chunk)).await.is_err() {
                     // Receiver dropped, stop reading
                     return;
                 }
                 current_chunk_index += 1;
+                current_chunk_lease = memory.acquire(chunk_size as u64).await;
                 current_chunk_buffer = Vec::with_capacity(chunk_size);
             }
         }
@@ -78,16 +138,22 @@ pub async fn produce_chunk_stream_from_files(
 
     // Send final partial chunk if any data remains
     if !current_chunk_buffer.is_empty() {
-        let chunk = finalize_chunk(current_chunk_index, current_chunk_buffer);
+        let chunk = finalize_chunk(
+            current_chunk_index,
+            current_chunk_buffer,
+            current_chunk_lease,
+        );
+        stats.chunk_queued();
         let _ = chunk_tx.send(Ok(chunk)).await;
     }
 }
 
 /// Finalize a chunk by creating ChunkData with a unique ID.
-fn finalize_chunk(chunk_index: i32, data: Vec<u8>) -> ChunkData {
+fn finalize_chunk(chunk_index: i32, data: Vec<u8>, lease: MemoryLease) -> ChunkData {
     ChunkData {
         chunk_id: Uuid::new_v4().to_string(),
         chunk_index,
         data,
+        lease,
     }
 }
@@ -9,21 +9,28 @@
 // - Persistence: DB writes for chunk metadata
 // - Progress Tracking: Track completion and emit progress events
 //
-// The pipeline ensures bounded memory usage and fail-fast error handling.
+// Every chunk holds a lease from the memory governor from the moment it is read
+// until it is uploaded, so the pipeline slows down when memory is short. The
+// pipeline ensures bounded memory usage and fail-fast error handling.
+//
+// Every stage records its busy time and concurrency in PipelineStats.
 
 pub(super) mod chunk_producer;
+pub mod stats;
 
 use std::collections::HashMap;
 use std::path::PathBuf;
 
 use crate::cloud_storage::CloudStorageManager;
 use crate::db::DbChunk;
-use crate::encryption::{EncryptedChunk, EncryptionService};
+use crate::encryption::EncryptionService;
 use crate::import::progress::ImportProgressTracker;
 use crate::import::service::ImportConfig;
 use crate::import::types::{CueFlacLayoutData, FileToChunks, TrackFile};
 use crate::library::LibraryManager;
+use crate::memory::MemoryLease;
 use futures::stream::{Stream, StreamExt};
+use stats::{PipelineStage, PipelineStats};
 use tokio::sync::mpsc;
 use tokio_stream::wrappers::ReceiverStream;
 use tracing::error;
@@ -54,6 +61,7 @@ pub(super) fn build_import_pipeline(
     files_to_chunks: Vec<FileToChunks>,
     chunk_size_bytes: usize,
     cue_flac_data: HashMap<PathBuf, CueFlacLayoutData>,
+    stats: PipelineStats,
 ) -> (
     impl Stream<Item = Result<(), String>>,
     mpsc::Sender<Result<ChunkData, String>>,
@@ -61,10 +69,10 @@ pub(super) fn build_import_pipeline(
     // Clone library_manager for both persistence and progress tracking stages
     let library_manager_persist = library_manager.clone();
     let library_manager_track = library_manager;
-
-    // Clone release_id for both persistence and progress tracking stages
-    let release_id_persist = release_id.clone();
-    let release_id_track = release_id.clone();
+    let stats_encrypt = stats.clone();
+    let stats_upload = stats.clone();
+    let stats_persist = stats.clone();
+    let stats_track = stats;
 
     // Stage 1: Read files and stream chunks (bounded channel for backpressure)
     let (chunk_tx, chunk_rx) = mpsc::channel::<Result<ChunkData, String>>(10);
@@ -73,8 +81,13 @@ pub(super) fn build_import_pipeline(
     let stream = ReceiverStream::new(chunk_rx)
         .map(move |chunk_data_result| {
             let encryption_service = encryption_service.clone();
+            let stats = stats_encrypt.clone();
+            if chunk_data_result.is_ok() {
+                stats.chunk_dequeued();
+            }
             async move {
                 let chunk_data = chunk_data_result?;
+                let _timer = stats.start(PipelineStage::Encrypt);
                 let join_result = tokio::task::spawn_blocking(move || {
                     encrypt_chunk_blocking(chunk_data, &encryption_service)
                 })
@@ -87,20 +100,24 @@ pub(super) fn build_import_pipeline(
         // Stage 3: Upload chunks (bounded I/O)
         .map(move |encrypted_result| {
             let cloud_storage = cloud_storage.clone();
+            let stats = stats_upload.clone();
             async move {
                 let encrypted = encrypted_result?;
+                let _timer = stats.start(PipelineStage::Upload);
                 upload_chunk(encrypted, &cloud_storage).await
             }
         })
         .buffer_unordered(config.max_upload_workers)
         // Stage 4: Persist chunk metadata to database
         .map(move |upload_result| {
-            let release_id = release_id_persist.clone();
+            let release_id = release_id.clone();
             let library_manager = library_manager_persist.clone();
+            let stats = stats_persist.clone();
 
             async move {
                 match upload_result {
                     Ok(uploaded_chunk) => {
+                        let _timer = stats.start(PipelineStage::Persist);
                         persist_chunk(&uploaded_chunk, &release_id, &library_manager).await?;
                         Ok(uploaded_chunk)
                     }
@@ -116,20 +133,20 @@ pub(super) fn build_import_pipeline(
         .map(move |persist_result| {
             let library_manager = library_manager_track.clone();
             let progress_tracker = progress_tracker.clone();
-            let release_id = release_id_track.clone();
             let track_files_clone = track_files.clone();
             let files_to_chunks_clone = files_to_chunks.clone();
             let chunk_size_bytes_clone = chunk_size_bytes;
             let cue_flac_data_clone = cue_flac_data.clone();
+            let stats = stats_track.clone();
 
             async move {
                 match persist_result {
                     Ok(uploaded_chunk) => {
+                        let _timer = stats.start(PipelineStage::Track);
                         track_progress(
                             uploaded_chunk,
                             &library_manager,
                             &progress_tracker,
-                            &release_id,
                             &track_files_clone,
                             &files_to_chunks_clone,
                             chunk_size_bytes_clone,
@@ -160,12 +177,13 @@ pub(super) struct ChunkData {
     pub(super) chunk_id: String,
     pub(super) chunk_index: i32,
     pub(super) data: Vec<u8>,
+    pub(super) lease: MemoryLease,
 }
 
 /// Encrypted chunk data ready for upload.
 ///
 /// Stage 2 output: Encryption workers produce these by encrypting ChunkData
-/// via spawn_blocking. The encrypted_data includes AES-256-GCM ciphertext,
+/// via spawn_blocking. The encrypted_data includes the cipher ID, ciphertext,
 /// nonce, and authentication tag.
 ///
 /// Example: `{ chunk_id: "uuid-123", chunk_index: 0, encrypted_data: [1.01MB encrypted bytes] }`
@@ -173,6 +191,8 @@ pub(super) struct EncryptedChunkData {
     pub(super) chunk_id: String,
     pub(super) chunk_index: i32,
     pub(super) encrypted_data: Vec<u8>,
+    /// Released with the data once the chunk is uploaded
+    pub(super) _lease: MemoryLease,
 }
 
 /// Chunk successfully uploaded to cloud storage.
@@ -193,7 +213,7 @@ pub(super) struct UploadedChunk {
 // Pipeline Stage Functions
 // ============================================================================
 
-/// Encrypt a chunk using AES-256-GCM.
+/// Encrypt a chunk with the library's chunk cipher.
 ///
 /// CPU-bound operation called from spawn_blocking to avoid starving async I/O.
 /// Wraps encrypted data with nonce and authentication tag, ready for cloud upload.
@@ -201,18 +221,18 @@ pub(super) fn encrypt_chunk_blocking(
     chunk_data: ChunkData,
     encryption_service: &EncryptionService,
 ) -> Result<EncryptedChunkData, String> {
-    let (ciphertext, nonce) = encryption_service
-        .encrypt(&chunk_data.data)
+    let encrypted_chunk = encryption_service
+        .encrypt_chunk(&chunk_data.data)
         .map_err(|e| format!("Encryption failed: {}", e))?;
 
-    // Create EncryptedChunk and serialize to bytes (includes nonce and authentication tag)
-    let encrypted_chunk = EncryptedChunk::new(ciphertext, nonce, "master".to_string());
+    // Serialize to bytes (includes cipher ID, nonce and authentication tag)
     let encrypted_bytes = encrypted_chunk.to_bytes();
 
     Ok(EncryptedChunkData {
         chunk_id: chunk_data.chunk_id,
         chunk_index: chunk_data.chunk_index,
         encrypted_data: encrypted_bytes,
+        _lease: chunk_data.lease,
     })
 }
 
@@ -273,7 +293,6 @@ async fn track_progress(
     uploaded_chunk: UploadedChunk,
     library_manager: &LibraryManager,
     progress_tracker: &ImportProgressTracker,
-    release_id: &str,
     track_files: &[TrackFile],
     files_to_chunks: &[FileToChunks],
     chunk_size_bytes: usize,
@@ -282,22 +301,20 @@ async fn track_progress(
     // Track progress and get newly completed tracks
     let newly_completed_tracks = progress_tracker.on_chunk_complete(uploaded_chunk.chunk_index);
 
-    // Persist metadata and mark newly completed tracks in the database
+    // Persist metadata for all newly completed tracks before marking them complete
     let persister = crate::import::metadata_persister::MetadataPersister::new(library_manager);
-    for track_id in &newly_completed_tracks {
-        // Persist track metadata before marking complete
-        persister
-            .persist_track_metadata(
-                release_id,
-                track_id,
-                track_files,
-                files_to_chunks,
-                chunk_size_bytes,
-                cue_flac_data,
-            )
-            .await
-            .map_err(|e| format!("Failed to persist track metadata: {}", e))?;
+    persister
+        .persist_tracks_metadata(
+            &newly_completed_tracks,
+            track_files,
+            files_to_chunks,
+            chunk_size_bytes,
+            cue_flac_data,
+        )
+        .await
+        .map_err(|e| format!("Failed to persist track metadata: {}", e))?;
 
+    for track_id in &newly_completed_tracks {
         // Mark track complete
         library_manager
             .mark_track_complete(track_id)
@@ -0,0 +1,194 @@
+// Pipeline Stage Counters
+//
+// Each stage records how long its items are being worked on and how many are
+// worked on at once. Busy time over wall time is the stage's mean concurrency,
+// and mean concurrency over its worker count is its utilization. A stage near
+// full utilization while the others idle is the bottleneck.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+/// Stages of the import pipeline, in order
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PipelineStage {
+    Read,
+    Encrypt,
+    Upload,
+    Persist,
+    Track,
+}
+
+impl PipelineStage {
+    pub const ALL: [PipelineStage; 5] = [
+        PipelineStage::Read,
+        PipelineStage::Encrypt,
+        PipelineStage::Upload,
+        PipelineStage::Persist,
+        PipelineStage::Track,
+    ];
+
+    pub fn name(&self) -> &'static str {
+        match self {
+            PipelineStage::Read => "read",
+            PipelineStage::Encrypt => "encrypt",
+            PipelineStage::Upload => "upload",
+            PipelineStage::Persist => "persist",
+            PipelineStage::Track => "track",
+        }
+    }
+}
+
+#[derive(Default)]
+struct StageCounters {
+    busy_nanos: AtomicU64,
+    completed: AtomicU64,
+    in_flight: AtomicU64,
+    peak_in_flight: AtomicU64,
+}
+
+#[derive(Default)]
+struct Counters {
+    stages: [StageCounters; 5],
+    bytes_read: AtomicU64,
+    /// Chunks read but not yet picked up for encryption
+    queued_chunks: AtomicU64,
+    peak_queued_chunks: AtomicU64,
+}
+
+/// Counters shared by every import the service runs
+#[derive(Clone, Default)]
+pub struct PipelineStats {
+    counters: Arc<Counters>,
+}
+
+/// Counters of one stage since the last [`PipelineStats::take`]
+#[derive(Debug, Clone)]
+pub struct StageSnapshot {
+    pub stage: PipelineStage,
+    /// Time spent on items, summed over concurrent items
+    pub busy: Duration,
+    /// Items finished (chunks, or file reads for the read stage)
+    pub completed: u64,
+    /// Most items worked on at once
+    pub peak_in_flight: u64,
+}
+
+/// Pipeline counters since the last [`PipelineStats::take`]
+#[derive(Debug, Clone)]
+pub struct PipelineSnapshot {
+    pub stages: Vec<StageSnapshot>,
+    pub bytes_read: u64,
+    /// Most chunks waiting between the reader and the encryption workers
+    pub peak_queued_chunks: u64,
+}
+
+/// Marks one item as being worked on by a stage until dropped
+pub(crate) struct StageTimer {
+    counters: Arc<Counters>,
+    stage: PipelineStage,
+    started: Instant,
+}
+
+impl PipelineStats {
+    pub(crate) fn start(&self, stage: PipelineStage) -> StageTimer {
+        let stage_counters = &self.counters.stages[stage as usize];
+        let in_flight = stage_counters.in_flight.fetch_add(1, Ordering::Relaxed) + 1;
+        stage_counters
+            .peak_in_flight
+            .fetch_max(in_flight, Ordering::Relaxed);
+        StageTimer {
+            counters: self.counters.clone(),
+            stage,
+            started: Instant::now(),
+        }
+    }
+
+    pub(crate) fn record_read(&self, bytes: usize) {
+        self.counters
+            .bytes_read
+            .fetch_add(bytes as u64, Ordering::Relaxed);
+    }
+
+    pub(crate) fn chunk_queued(&self) {
+        let queued = self.counters.queued_chunks.fetch_add(1, Ordering::Relaxed) + 1;
+        self.counters
+            .peak_queued_chunks
+            .fetch_max(queued, Ordering::Relaxed);
+    }
+
+    pub(crate) fn chunk_dequeued(&self) {
+        self.counters.queued_chunks.fetch_sub(1, Ordering::Relaxed);
+    }
+
+    /// Return the counters and start over, e.g. between benchmark runs
+    ///
+    /// Peaks restart from what is in flight right now.
+    pub fn take(&self) -> PipelineSnapshot {
+        let counters = &self.counters;
+        let stages = PipelineStage::ALL
+            .iter()
+            .map(|&stage| {
+                let stage_counters = &counters.stages[stage as usize];
+                let in_flight = stage_counters.in_flight.load(Ordering::Relaxed);
+                StageSnapshot {
+                    stage,
+                    busy: Duration::from_nanos(
+                        stage_counters.busy_nanos.swap(0, Ordering::Relaxed),
+                    ),
+                    completed: stage_counters.completed.swap(0, Ordering::Relaxed),
+                    peak_in_flight: stage_counters
+                        .peak_in_flight
+                        .swap(in_flight, Ordering::Relaxed),
+                }
+            })
+            .collect();
+        let queued_chunks = counters.queued_chunks.load(Ordering::Relaxed);
+
+        PipelineSnapshot {
+            stages,
+            bytes_read: counters.bytes_read.swap(0, Ordering::Relaxed),
+            peak_queued_chunks: counters
+                .peak_queued_chunks
+                .swap(queued_chunks, Ordering::Relaxed),
+        }
+    }
+}
+
+impl Drop for StageTimer {
+    fn drop(&mut self) {
+        let stage_counters = &self.counters.stages[self.stage as usize];
+        stage_counters
+            .busy_nanos
+            .fetch_add(self.started.elapsed().as_nanos() as u64, Ordering::Relaxed);
+        stage_counters.completed.fetch_add(1, Ordering::Relaxed);
+        stage_counters.in_flight.fetch_sub(1, Ordering::Relaxed);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_take_resets_counters_but_keeps_in_flight_peak() {
+        let stats = PipelineStats::default();
+
+        let running = stats.start(PipelineStage::Upload);
+        drop(stats.start(PipelineStage::Upload));
+        stats.record_read(1024);
+
+        let snapshot = stats.take();
+        let upload = &snapshot.stages[PipelineStage::Upload as usize];
+        assert_eq!(upload.completed, 1);
+        assert_eq!(upload.peak_in_flight, 2);
+        assert_eq!(snapshot.bytes_read, 1024);
+
+        drop(running);
+        let snapshot = stats.take();
+        let upload = &snapshot.stages[PipelineStage::Upload as usize];
+        assert_eq!(upload.completed, 1);
+        assert_eq!(upload.peak_in_flight, 1);
+        assert_eq!(snapshot.bytes_read, 0);
+    }
+}
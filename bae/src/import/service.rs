@@ -20,6 +20,7 @@
 //
 // 3. Chunk Phase (async, in ImportService::run_chunk_phase):
 //    - Mark album as 'importing'
+//    - Choose the release's chunk size from its total size and track count
 //    - Streaming pipeline: read → encrypt → upload → persist (bounded parallelism)
 //    - Emit progress with ImportPhase::Chunk
 //    - Mark album/tracks as 'complete'
@@ -39,16 +40,18 @@ use crate::cd::RipProgress;
 use crate::cloud_storage::CloudStorageManager;
 use crate::db::{DbAlbum, DbRelease, DbTrack};
 use crate::encryption::EncryptionService;
-use crate::import::album_chunk_layout::AlbumChunkLayout;
+use crate::import::album_chunk_layout::{choose_chunk_size, AlbumChunkLayout};
 use crate::import::handle::{ImportServiceHandle, TorrentImportMetadata};
 use crate::import::metadata_persister::MetadataPersister;
 use crate::import::pipeline;
+use crate::import::pipeline::stats::PipelineStats;
 use crate::import::progress::ImportProgressTracker;
 use crate::import::types::{
-    CueFlacMetadata, DiscoveredFile, FileToChunks, ImportCommand, ImportProgress, TorrentSource,
+    ChunkLayoutMode, CueFlacMetadata, DiscoveredFile, ImportCommand, ImportProgress, TorrentSource,
     TrackFile,
 };
 use crate::library::SharedLibraryManager;
+use crate::memory::MemoryGovernor;
 use crate::torrent::TorrentManagerHandle;
 use futures::stream::StreamExt;
 use tokio::sync::mpsc;
@@ -57,14 +60,18 @@ use tracing::{error, info, warn};
 /// Configuration for import service
 #[derive(Clone)]
 pub struct ImportConfig {
-    /// Size of each chunk in bytes
-    pub chunk_size_bytes: usize,
+    /// Smallest chunk size a release can be given, in bytes
+    pub min_chunk_size_bytes: usize,
+    /// Largest chunk size a release can be given, in bytes
+    pub max_chunk_size_bytes: usize,
     /// Number of parallel encryption workers (CPU-bound, typically 2x CPU cores)
     pub max_encrypt_workers: usize,
     /// Number of parallel upload workers (I/O-bound)
     pub max_upload_workers: usize,
     /// Number of parallel DB write workers (I/O-bound)
     pub max_db_write_workers: usize,
+    /// How folder and CD imports lay files out in chunks (torrents are always contiguous)
+    pub chunk_layout: ChunkLayoutMode,
 }
 
 /// Import service that orchestrates the album import workflow
@@ -85,6 +92,10 @@ pub struct ImportService {
     cache_manager: CacheManager,
     /// Handle to torrent manager service for torrent operations
     torrent_handle: TorrentManagerHandle,
+    /// Memory budget chunk buffers are leased from
+    memory: MemoryGovernor,
+    /// Stage counters of every pipeline this service runs
+    pipeline_stats: PipelineStats,
 }
 
 impl ImportService {
@@ -101,9 +112,12 @@ impl ImportService {
         cloud_storage: CloudStorageManager,
         cache_manager: CacheManager,
         torrent_handle: TorrentManagerHandle,
+        memory: MemoryGovernor,
     ) -> ImportServiceHandle {
         let (commands_tx, commands_rx) = mpsc::unbounded_channel();
         let (progress_tx, progress_rx) = mpsc::unbounded_channel();
+        let pipeline_stats = PipelineStats::default();
+        let pipeline_stats_for_worker = pipeline_stats.clone();
 
         // Clone library_manager and cache_manager for the thread
         let library_manager_for_worker = library_manager.clone();
@@ -124,6 +138,8 @@ impl ImportService {
                     cloud_storage,
                     cache_manager: cache_manager_for_worker,
                     torrent_handle,
+                    memory,
+                    pipeline_stats: pipeline_stats_for_worker,
                 };
 
                 info!("Worker started");
@@ -143,7 +159,13 @@ impl ImportService {
             });
         });
 
-        ImportServiceHandle::new(commands_tx, progress_rx, library_manager, runtime_handle)
+        ImportServiceHandle::new(
+            commands_tx,
+            progress_rx,
+            library_manager,
+            pipeline_stats,
+            runtime_handle,
+        )
     }
 
     async fn do_import(&self, command: ImportCommand) {
@@ -242,9 +264,11 @@ impl ImportService {
             &db_release,
             &tracks_to_files,
             &discovered_files,
+            self.config.chunk_layout,
             cue_flac_metadata,
         )
         .await?;
+        self.complete_release(&db_release).await?;
 
         // Send completion event
         let _ = self
@@ -304,12 +328,16 @@ impl ImportService {
             .await
             .map_err(|e| format!("Failed to wait for metadata: {}", e))?;
 
-        // Download torrent and emit progress (Acquire phase)
+        // Download torrent and emit progress (Acquire phase), following the torrent
+        // manager's periodic status snapshots
+        let info_hash = torrent_handle.info_hash().await;
+        let mut status_rx = self.torrent_handle.subscribe_status();
         loop {
-            let progress = torrent_handle
-                .progress()
-                .await
-                .map_err(|e| format!("Failed to check torrent progress: {}", e))?;
+            let progress = status_rx
+                .borrow_and_update()
+                .get(&info_hash)
+                .map(|status| status.progress)
+                .unwrap_or(0.0);
 
             let percent = (progress * 100.0) as u8;
             let _ = self.progress_tx.send(ImportProgress::Progress {
@@ -322,7 +350,10 @@ impl ImportService {
                 break;
             }
 
-            tokio::time::sleep(tokio::time::Duration::from_millis(500)).await;
+            status_rx
+                .changed()
+                .await
+                .map_err(|_| "Torrent manager stopped during download".to_string())?;
         }
 
         // Wait a bit for libtorrent to finish writing files to disk
@@ -401,14 +432,26 @@ impl ImportService {
         // ========== CHUNK PHASE ==========
         // Now that data is acquired, run chunk phase (same as folder import)
 
+        // The piece map below relies on the chunk stream being the torrent's own byte
+        // stream, so torrents always use the contiguous layout
         self.run_chunk_phase(
             &db_release,
             &tracks_to_files,
             &discovered_files,
+            ChunkLayoutMode::Contiguous,
             Some(cue_flac_metadata),
         )
         .await?;
 
+        // ========== PERSIST PIECE MAP ==========
+        // Map every torrent piece onto the uploaded release chunks. The release is only
+        // marked complete once its piece map exists, so it can always be seeded.
+
+        MetadataPersister::new(library_manager)
+            .persist_torrent_piece_map(&db_release.id)
+            .await?;
+        self.complete_release(&db_release).await?;
+
         // ========== HANDOFF TO SEEDER ==========
         // Hand off to seeder if requested (fire-and-forget)
         if seed_after_download {
@@ -625,9 +668,11 @@ impl ImportService {
             &db_release,
             &tracks_to_files,
             &discovered_files,
+            self.config.chunk_layout,
             cue_flac_metadata,
         )
         .await?;
+        self.complete_release(&db_release).await?;
 
         // ========== CLEANUP TEMP DIRECTORY ==========
         // Remove temporary directory with ripped files
@@ -657,17 +702,39 @@ impl ImportService {
         db_release: &DbRelease,
         tracks_to_files: &[TrackFile],
         discovered_files: &[DiscoveredFile],
+        layout_mode: ChunkLayoutMode,
         cue_flac_metadata: Option<HashMap<PathBuf, CueFlacMetadata>>,
     ) -> Result<(), String> {
         let library_manager = self.library_manager.get();
 
+        // ========== CHOOSE CHUNK SIZE ==========
+        // Stored on the release so every reader splits its stream the same way
+
+        let chunk_size_bytes = choose_chunk_size(
+            discovered_files,
+            tracks_to_files.len(),
+            self.config.min_chunk_size_bytes,
+            self.config.max_chunk_size_bytes,
+        );
+
+        info!(
+            "Using {} byte chunks for release {}",
+            chunk_size_bytes, db_release.id
+        );
+
+        library_manager
+            .set_release_chunk_size(&db_release.id, chunk_size_bytes)
+            .await
+            .map_err(|e| format!("Failed to store chunk size: {}", e))?;
+
         // ========== COMPUTE LAYOUT FIRST ==========
         // Compute the layout before streaming so we have accurate progress tracking
 
         let chunk_layout = AlbumChunkLayout::build(
             discovered_files.to_vec(),
             tracks_to_files,
-            self.config.chunk_size_bytes,
+            chunk_size_bytes,
+            layout_mode,
             cue_flac_metadata.clone(),
         )?;
 
@@ -691,25 +758,16 @@ impl ImportService {
             progress_tracker,
             tracks_to_files.to_vec(),
             chunk_layout.files_to_chunks.clone(),
-            self.config.chunk_size_bytes,
+            chunk_size_bytes,
             chunk_layout.cue_flac_data.clone(),
+            self.pipeline_stats.clone(),
         );
 
-        // Use file producer
-        let files_to_chunks_for_producer: Vec<FileToChunks> = discovered_files
-            .iter()
-            .map(|f| FileToChunks {
-                file_path: f.path.clone(),
-                start_chunk_index: 0, // Unused by producer
-                end_chunk_index: 0,   // Unused by producer
-                start_byte_offset: 0, // Unused by producer
-                end_byte_offset: 0,   // Unused by producer
-            })
-            .collect();
-
         tokio::spawn(pipeline::chunk_producer::produce_chunk_stream_from_files(
-            files_to_chunks_for_producer,
-            self.config.chunk_size_bytes,
+            chunk_layout.files_to_chunks.clone(),
+            chunk_size_bytes,
+            self.memory.clone(),
+            self.pipeline_stats.clone(),
             chunk_tx,
         ));
 
@@ -725,23 +783,27 @@ impl ImportService {
 
         // ========== PERSIST RELEASE METADATA ==========
         // Track metadata was already persisted by the pipeline as tracks completed.
-        // Now persist release-level metadata (files) and mark release complete.
+        // Now persist release-level metadata (files). Callers mark the release complete
+        // once everything else it needs is persisted.
 
         let persister = MetadataPersister::new(library_manager);
         persister
             .persist_release_metadata(
                 &db_release.id,
-                tracks_to_files,
                 &chunk_layout.files_to_chunks,
+                chunk_size_bytes,
             )
             .await?;
 
-        // Mark release complete
-        library_manager
+        Ok(())
+    }
+
+    /// Mark a release complete after its chunks and metadata are all persisted
+    async fn complete_release(&self, db_release: &DbRelease) -> Result<(), String> {
+        self.library_manager
+            .get()
             .mark_release_complete(&db_release.id)
             .await
-            .map_err(|e| format!("Failed to mark release complete: {}", e))?;
-
-        Ok(())
+            .map_err(|e| format!("Failed to mark release complete: {}", e))
     }
 }
@@ -1,8 +1,9 @@
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::path::PathBuf;
+use std::sync::{Arc, Mutex};
 use tracing::{debug, info};
 
-use crate::cue_flac::{CueFlacPair, CueFlacProcessor};
+use crate::cue_flac::CueFlacProcessor;
 use crate::db::DbTrack;
 use crate::import::types::{CueFlacMetadata, DiscoveredFile, TrackFile, TrackToFileMappingResult};
 
@@ -17,189 +18,237 @@ pub async fn map_tracks_to_files(
     tracks: &[DbTrack],
     discovered_files: &[DiscoveredFile],
 ) -> Result<TrackToFileMappingResult, String> {
-    info!(
-        "Mapping {} tracks using {} pre-discovered files",
-        tracks.len(),
-        discovered_files.len()
-    );
-
-    // Extract paths from discovered files
-    let file_paths: Vec<PathBuf> = discovered_files.iter().map(|f| f.path.clone()).collect();
-
-    // Check for CUE/FLAC pairs from discovered files
-    let cue_flac_pairs = CueFlacProcessor::detect_cue_flac_from_paths(&file_paths)
-        .map_err(|e| format!("CUE/FLAC detection failed: {}", e))?;
-
-    // If no CUE/FLAC pairs, map tracks to individual audio files
-    if cue_flac_pairs.is_empty() {
-        return map_tracks_to_individual_files(tracks, &file_paths);
-    }
+    TrackFileIndex::build(discovered_files)?.map_tracks(tracks)
+}
 
-    // Map tracks to CUE/FLAC files
-    info!("Found {} CUE/FLAC pairs", cue_flac_pairs.len());
-    map_tracks_to_cue_flacs(tracks, cue_flac_pairs)
+/// Everything the mapper needs to know about a folder's files, computed once.
+///
+/// Building the index does all filesystem and per-file work (audio filtering,
+/// CUE/FLAC pairing, CUE sheet parsing). Mapping a track list against it is then a
+/// linear pass, so a folder can be re-mapped as often as its track list changes.
+pub struct TrackFileIndex {
+    /// Audio files in track order (sorted by path)
+    audio_files: Vec<PathBuf>,
+    /// Lowercased extensions present among `audio_files`
+    audio_formats: HashSet<String>,
+    /// Parsed CUE sheets for every CUE/FLAC pair, in pair order
+    cue_flacs: Vec<CueFlacMetadata>,
 }
 
-/// Map tracks to CUE/FLAC source files using CUE sheet parsing.
-/// Returns track mappings AND the parsed CUE metadata for use in later stages.
-fn map_tracks_to_cue_flacs(
-    tracks: &[DbTrack],
-    cue_flac_pairs: Vec<CueFlacPair>,
-) -> Result<TrackToFileMappingResult, String> {
-    let mut track_files = Vec::new();
-    let mut cue_flac_metadata = HashMap::new();
+/// The index of the last folder mapped, reused while its files are unchanged.
+///
+/// Importing a folder usually means trying candidate releases against it until one
+/// maps, so every candidate's track list is mapped against the same index instead of
+/// re-pairing and re-parsing the folder's CUE sheets.
+#[derive(Clone, Default)]
+pub struct TrackFileIndexCache {
+    /// Files the index was built from, and the index
+    last: Arc<Mutex<Option<(Vec<IndexedFile>, Arc<TrackFileIndex>)>>>,
+}
+
+/// Path, size and modification time of a file an index was built from
+///
+/// The modification time catches a CUE sheet edited in place without changing size.
+type IndexedFile = (PathBuf, u64, Option<std::time::SystemTime>);
+
+impl TrackFileIndexCache {
+    /// Index `discovered_files`, reusing the last index if they are the same files
+    pub fn get_or_build(
+        &self,
+        discovered_files: &[DiscoveredFile],
+    ) -> Result<Arc<TrackFileIndex>, String> {
+        let files: Vec<IndexedFile> = discovered_files
+            .iter()
+            .map(|f| {
+                let modified = std::fs::metadata(&f.path)
+                    .and_then(|metadata| metadata.modified())
+                    .ok();
+                (f.path.clone(), f.size, modified)
+            })
+            .collect();
 
-    for pair in cue_flac_pairs {
-        let (pair_mappings, pair_metadata) = map_tracks_to_cue_flac(&pair, tracks)?;
+        let mut last = self.last.lock().unwrap();
+        if let Some((last_files, index)) = last.as_ref() {
+            if *last_files == files {
+                debug!("Reusing track file index for {} files", files.len());
+                return Ok(index.clone());
+            }
+        }
 
-        track_files.extend(pair_mappings);
-        cue_flac_metadata.insert(pair.flac_path.clone(), pair_metadata);
+        let index = Arc::new(TrackFileIndex::build(discovered_files)?);
+        *last = Some((files, index.clone()));
+        Ok(index)
     }
+}
 
-    info!(
-        "Created {} CUE/FLAC mappings with validated metadata",
-        track_files.len()
-    );
+impl TrackFileIndex {
+    /// Index a folder's discovered files.
+    /// Fails if a CUE/FLAC pair is present but its CUE sheet is unusable.
+    pub fn build(discovered_files: &[DiscoveredFile]) -> Result<Self, String> {
+        // Extract paths from discovered files
+        let file_paths: Vec<PathBuf> = discovered_files.iter().map(|f| f.path.clone()).collect();
 
-    Ok(TrackToFileMappingResult {
-        track_files,
-        cue_flac_metadata: Some(cue_flac_metadata),
-    })
-}
+        // Check for CUE/FLAC pairs from discovered files
+        let cue_flac_pairs = CueFlacProcessor::detect_cue_flac_from_paths(&file_paths)
+            .map_err(|e| format!("CUE/FLAC detection failed: {}", e))?;
 
-/// Process a single CUE/FLAC pair: parse, validate, and create track mappings.
-/// Returns the track mappings and metadata for this pair.
-fn map_tracks_to_cue_flac(
-    pair: &CueFlacPair,
-    tracks: &[DbTrack],
-) -> Result<(Vec<TrackFile>, CueFlacMetadata), String> {
-    debug!(
-        "Processing CUE/FLAC pair: {} + {}",
-        pair.flac_path.display(),
-        pair.cue_path.display()
-    );
-
-    // Parse the CUE sheet (validation happens here)
-    let cue_sheet = CueFlacProcessor::parse_cue_sheet(&pair.cue_path)
-        .map_err(|e| format!("Failed to parse CUE sheet: {}", e))?;
-
-    debug!("CUE sheet contains {} tracks", cue_sheet.tracks.len());
-
-    if cue_sheet.tracks.is_empty() {
-        return Err(format!(
-            "CUE sheet '{}' contains no tracks. Check CUE file format.",
-            pair.cue_path.display()
-        ));
-    }
+        let mut cue_flacs = Vec::with_capacity(cue_flac_pairs.len());
+        for pair in cue_flac_pairs {
+            debug!(
+                "Processing CUE/FLAC pair: {} + {}",
+                pair.flac_path.display(),
+                pair.cue_path.display()
+            );
 
-    // Validate track count matches Discogs metadata
-    if cue_sheet.tracks.len() != tracks.len() {
-        return Err(format!(
-            "Track count mismatch: CUE sheet has {} tracks but Discogs has {} tracks",
-            cue_sheet.tracks.len(),
-            tracks.len()
-        ));
-    }
+            // Parse the CUE sheet (validation happens here)
+            let cue_sheet = CueFlacProcessor::parse_cue_sheet(&pair.cue_path)
+                .map_err(|e| format!("Failed to parse CUE sheet: {}", e))?;
 
-    // For CUE/FLAC, all tracks map to the same FLAC file
-    let mut mappings = Vec::new();
-    for (index, cue_track) in cue_sheet.tracks.iter().enumerate() {
-        if let Some(db_track) = tracks.get(index) {
-            mappings.push(TrackFile {
-                db_track_id: db_track.id.clone(),
-                file_path: pair.flac_path.clone(),
+            debug!("CUE sheet contains {} tracks", cue_sheet.tracks.len());
+
+            if cue_sheet.tracks.is_empty() {
+                return Err(format!(
+                    "CUE sheet '{}' contains no tracks. Check CUE file format.",
+                    pair.cue_path.display()
+                ));
+            }
+
+            cue_flacs.push(CueFlacMetadata {
+                cue_sheet,
+                cue_path: pair.cue_path,
+                flac_path: pair.flac_path,
             });
+        }
 
-            debug!(
-                "Mapped CUE track '{}' to DB track '{}'",
-                cue_track.title, db_track.title
-            );
+        let (audio_files, audio_formats) = filter_audio_files(&file_paths);
+
+        info!(
+            "Indexed {} audio files and {} CUE/FLAC pairs from {} discovered files",
+            audio_files.len(),
+            cue_flacs.len(),
+            discovered_files.len()
+        );
+
+        Ok(TrackFileIndex {
+            audio_files,
+            audio_formats,
+            cue_flacs,
+        })
+    }
+
+    /// Map a track list against the indexed files
+    pub fn map_tracks(&self, tracks: &[DbTrack]) -> Result<TrackToFileMappingResult, String> {
+        // If no CUE/FLAC pairs, map tracks to individual audio files
+        if self.cue_flacs.is_empty() {
+            return self.map_tracks_to_individual_files(tracks);
         }
+
+        self.map_tracks_to_cue_flacs(tracks)
     }
 
-    let metadata = CueFlacMetadata {
-        cue_sheet,
-        cue_path: pair.cue_path.clone(),
-        flac_path: pair.flac_path.clone(),
-    };
+    /// Map tracks to CUE/FLAC source files using the parsed CUE sheets.
+    /// Returns track mappings AND the parsed CUE metadata for use in later stages.
+    fn map_tracks_to_cue_flacs(
+        &self,
+        tracks: &[DbTrack],
+    ) -> Result<TrackToFileMappingResult, String> {
+        let mut track_files = Vec::new();
+        let mut cue_flac_metadata = HashMap::new();
+
+        for metadata in &self.cue_flacs {
+            // Validate track count matches Discogs metadata
+            if metadata.cue_sheet.tracks.len() != tracks.len() {
+                return Err(format!(
+                    "Track count mismatch: CUE sheet has {} tracks but Discogs has {} tracks",
+                    metadata.cue_sheet.tracks.len(),
+                    tracks.len()
+                ));
+            }
 
-    Ok((mappings, metadata))
-}
+            // For CUE/FLAC, all tracks map to the same FLAC file
+            track_files.extend(tracks.iter().map(|db_track| TrackFile {
+                db_track_id: db_track.id.clone(),
+                file_path: metadata.flac_path.clone(),
+            }));
+            cue_flac_metadata.insert(metadata.flac_path.clone(), metadata.clone());
+        }
 
-/// Map tracks to individual audio files using simple name-based matching
-fn map_tracks_to_individual_files(
-    tracks: &[DbTrack],
-    file_paths: &[PathBuf],
-) -> Result<TrackToFileMappingResult, String> {
-    let audio_files = filter_audio_files(file_paths);
+        info!(
+            "Created {} CUE/FLAC mappings with validated metadata",
+            track_files.len()
+        );
 
-    if audio_files.is_empty() {
-        return Err("No audio files found in discovered files".to_string());
+        Ok(TrackToFileMappingResult {
+            track_files,
+            cue_flac_metadata: Some(cue_flac_metadata),
+        })
     }
 
-    // Require exact 1:1 match between tracks and files
-    if audio_files.len() != tracks.len() {
-        return Err(format!(
-            "Track count mismatch: found {} audio files but have {} tracks",
-            audio_files.len(),
-            tracks.len()
-        ));
-    }
+    /// Map tracks to individual audio files using simple name-based matching
+    fn map_tracks_to_individual_files(
+        &self,
+        tracks: &[DbTrack],
+    ) -> Result<TrackToFileMappingResult, String> {
+        if self.audio_files.is_empty() {
+            return Err("No audio files found in discovered files".to_string());
+        }
 
-    // Verify all files have the same format
-    let formats: std::collections::HashSet<_> = audio_files
-        .iter()
-        .filter_map(|p| p.extension())
-        .filter_map(|e| e.to_str())
-        .map(|s| s.to_lowercase())
-        .collect();
-
-    if formats.len() > 1 {
-        return Err(format!(
-            "Mixed audio formats detected: {:?}. All tracks should be in the same format",
-            formats
-        ));
-    }
+        // Require exact 1:1 match between tracks and files
+        if self.audio_files.len() != tracks.len() {
+            return Err(format!(
+                "Track count mismatch: found {} audio files but have {} tracks",
+                self.audio_files.len(),
+                tracks.len()
+            ));
+        }
 
-    // Simple mapping strategy: sort files by name and match to track order
-    let mut mappings = Vec::new();
+        // Verify all files have the same format
+        if self.audio_formats.len() > 1 {
+            return Err(format!(
+                "Mixed audio formats detected: {:?}. All tracks should be in the same format",
+                self.audio_formats
+            ));
+        }
 
-    for (index, track) in tracks.iter().enumerate() {
-        if let Some(audio_file) = audio_files.get(index) {
-            mappings.push(TrackFile {
+        // Simple mapping strategy: files are sorted by name and matched to track order
+        let mappings: Vec<TrackFile> = tracks
+            .iter()
+            .zip(&self.audio_files)
+            .map(|(track, audio_file)| TrackFile {
                 db_track_id: track.id.clone(),
                 file_path: audio_file.clone(),
-            });
-        }
-    }
+            })
+            .collect();
 
-    info!("Mapped {} tracks to source files", mappings.len());
-    Ok(TrackToFileMappingResult {
-        track_files: mappings,
-        cue_flac_metadata: None,
-    })
+        info!("Mapped {} tracks to source files", mappings.len());
+        Ok(TrackToFileMappingResult {
+            track_files: mappings,
+            cue_flac_metadata: None,
+        })
+    }
 }
 
-/// Filter audio files from a list of paths
-fn filter_audio_files(paths: &[PathBuf]) -> Vec<PathBuf> {
+/// Filter audio files from a list of paths.
+/// Returns the sorted audio files and the set of (lowercased) formats among them.
+fn filter_audio_files(paths: &[PathBuf]) -> (Vec<PathBuf>, HashSet<String>) {
     let audio_extensions = ["mp3", "flac", "wav", "m4a", "aac", "ogg"];
-    let mut audio_files: Vec<PathBuf> = paths
-        .iter()
-        .filter(|path| {
-            if let Some(extension) = path.extension() {
-                if let Some(ext_str) = extension.to_str() {
-                    return audio_extensions.contains(&ext_str.to_lowercase().as_str());
-                }
-            }
-            false
-        })
-        .cloned()
-        .collect();
+    let mut audio_files = Vec::new();
+    let mut formats = HashSet::new();
+
+    for path in paths {
+        let Some(ext) = path.extension().and_then(|e| e.to_str()) else {
+            continue;
+        };
+        let ext = ext.to_lowercase();
+        if audio_extensions.contains(&ext.as_str()) {
+            audio_files.push(path.clone());
+            formats.insert(ext);
+        }
+    }
 
-    // Already sorted by parent function
     audio_files.sort();
     debug!("Filtered {} audio files", audio_files.len());
-    audio_files
+    (audio_files, formats)
 }
 
 #[cfg(test)]
@@ -272,6 +321,77 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_track_file_index_remaps_changed_tracks() {
+        let discovered_files = create_discovered_files(vec![
+            "/album/02-track2.flac",
+            "/album/01-track1.flac",
+            "/album/cover.jpg",
+        ]);
+        let index = TrackFileIndex::build(&discovered_files).unwrap();
+
+        let first = index.map_tracks(&create_test_tracks(2)).unwrap();
+        assert_eq!(first.track_files[0].db_track_id, "track-0");
+
+        let mut tracks = create_test_tracks(2);
+        tracks[0].id = "replaced".to_string();
+        let second = index.map_tracks(&tracks).unwrap();
+        assert_eq!(second.track_files[0].db_track_id, "replaced");
+        assert_eq!(
+            second.track_files[0].file_path,
+            PathBuf::from("/album/01-track1.flac")
+        );
+
+        assert!(index.map_tracks(&create_test_tracks(3)).is_err());
+    }
+
+    #[test]
+    fn test_track_file_index_cache_rebuilds_only_when_files_change() {
+        let cache = TrackFileIndexCache::default();
+        let mut discovered_files =
+            create_discovered_files(vec!["/album/01-track1.flac", "/album/02-track2.flac"]);
+
+        let first = cache.get_or_build(&discovered_files).unwrap();
+        let second = cache.get_or_build(&discovered_files).unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+
+        discovered_files.push(DiscoveredFile {
+            path: PathBuf::from("/album/03-track3.flac"),
+            size: 1024,
+        });
+        let third = cache.get_or_build(&discovered_files).unwrap();
+        assert!(!Arc::ptr_eq(&first, &third));
+        assert_eq!(
+            third
+                .map_tracks(&create_test_tracks(3))
+                .unwrap()
+                .track_files
+                .len(),
+            3
+        );
+    }
+
+    #[test]
+    fn test_track_file_index_cache_rebuilds_when_a_file_is_modified() {
+        let temp_dir = tempfile::tempdir().unwrap();
+        let path = temp_dir.path().join("01-track1.flac");
+        std::fs::write(&path, b"flac").unwrap();
+        let discovered_files = vec![DiscoveredFile {
+            path: path.clone(),
+            size: 4,
+        }];
+
+        let cache = TrackFileIndexCache::default();
+        let first = cache.get_or_build(&discovered_files).unwrap();
+
+        // Same path and size, but edited since
+        let file = std::fs::File::options().write(true).open(&path).unwrap();
+        file.set_modified(std::time::SystemTime::UNIX_EPOCH)
+            .unwrap();
+        let second = cache.get_or_build(&discovered_files).unwrap();
+        assert!(!Arc::ptr_eq(&first, &second));
+    }
+
     #[tokio::test]
     async fn test_map_tracks_to_files_no_audio_files() {
         let tracks = create_test_tracks(2);
@@ -13,7 +13,8 @@
 //! - Output: `TrackToFileMappingResult` (track→file mappings + optional CUE metadata)
 //!
 //! ## Phase 2: Chunk Layout Calculation
-//! - Concatenate all files into a single byte stream
+//! - Lay all files out in a single byte stream (back to back, or with track files
+//!   aligned to chunk boundaries - see `ChunkLayoutMode`)
 //! - Divide the stream into fixed-size chunks
 //! - Calculate chunk ranges for each track:
 //!   - One-file-per-track: Track boundaries = file boundaries in the stream
@@ -173,9 +174,23 @@ pub struct DiscoveredFile {
     pub size: u64,
 }
 
+/// How files are placed in a release's chunk stream (Phase 2).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum ChunkLayoutMode {
+    /// Files back to back in discovery order. Tracks usually start mid-chunk and
+    /// share their first and last chunks with neighbouring files. Required for
+    /// torrent imports, whose piece map assumes the torrent's own byte stream.
+    #[default]
+    Contiguous,
+    /// Every track file starts on a chunk boundary, so playing a track only fetches
+    /// its own chunks. Non-track files (cover art, CUE, logs) are packed into the
+    /// unused tail of track chunks, and any that don't fit go at the end.
+    TrackAligned,
+}
+
 /// Maps a file to its position in the chunked album stream (Phase 2 output).
 ///
-/// When all album files are concatenated into a single byte stream and divided into
+/// When all album files are laid out in a single byte stream and divided into
 /// fixed-size chunks, this records which chunks each file spans and the byte offsets
 /// within the first and last chunks.
 ///
@@ -0,0 +1,517 @@
+//! Sharing encrypted chunks between bae nodes on the same network
+//!
+//! Nodes that use the same bucket find each other through a static peer list and
+//! multicast announcements, and serve chunks from their local cache over HTTP.
+//! Every node in the group shares a token, which never goes over the wire:
+//! announcements are signed with it, and chunk requests answer a single-use
+//! challenge from the serving node with an HMAC. Chunks stay encrypted in transit,
+//! and a chunk that fails authenticated decryption is discarded so the reader
+//! falls back to the bucket.
+
+use crate::cache::CacheManager;
+use crate::encryption::EncryptionService;
+use axum::{
+    extract::{Path, State},
+    http::{header, HeaderMap, StatusCode},
+    response::{IntoResponse, Response},
+    routing::get,
+    Router,
+};
+use futures::future::{self, FutureExt};
+use hmac::{Hmac, Mac};
+use serde::Deserialize;
+use sha2::Sha256;
+use socket2::{Domain, Protocol, Socket, Type};
+use std::collections::HashMap;
+use std::net::{Ipv4Addr, SocketAddr, SocketAddrV4};
+use std::sync::{Arc, Mutex, RwLock};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+use tracing::{debug, error, info, warn};
+
+/// Port the chunk service listens on unless configured otherwise
+pub const DEFAULT_PORT: u16 = 4534;
+
+/// Multicast group nodes announce themselves on
+const DISCOVERY_GROUP: Ipv4Addr = Ipv4Addr::new(239, 255, 66, 77);
+const DISCOVERY_PORT: u16 = 45677;
+
+/// Announcements are `bae-chunks/2 <group> <node id> <service port> <unix time> <hmac>`,
+/// signed over everything before the HMAC
+const ANNOUNCE_PREFIX: &str = "bae-chunks/2";
+
+/// Announcements further than this from our clock are ignored, which limits replays
+const ANNOUNCE_MAX_AGE: Duration = Duration::from_secs(60);
+
+/// How often a node announces itself
+const ANNOUNCE_INTERVAL: Duration = Duration::from_secs(10);
+
+/// Discovered peers are forgotten once they stop announcing for this long
+const PEER_TTL: Duration = Duration::from_secs(35);
+
+/// Peers slower than this are given up on in favour of the bucket
+const PEER_CONNECT_TIMEOUT: Duration = Duration::from_millis(300);
+const PEER_REQUEST_TIMEOUT: Duration = Duration::from_secs(2);
+
+/// Peers that failed a request are skipped for this long rather than timing out on every miss
+const PEER_RETRY_AFTER: Duration = Duration::from_secs(30);
+
+/// Chunk requests authenticate with `Authorization: Bae-HMAC <challenge> <hmac>`
+const AUTH_SCHEME: &str = "Bae-HMAC";
+
+/// Challenges are single-use and must be answered within this long
+const CHALLENGE_TTL: Duration = Duration::from_secs(10);
+
+/// Outstanding challenges a node keeps before refusing to hand out more
+const MAX_OPEN_CHALLENGES: usize = 1024;
+
+type HmacSha256 = Hmac<Sha256>;
+
+/// Configuration of the LAN chunk service
+#[derive(Debug, Clone, Deserialize)]
+pub struct LanPeerConfig {
+    /// Port the chunk service listens on
+    #[serde(default = "default_port")]
+    pub port: u16,
+    /// Secret shared by all nodes allowed to fetch chunks from each other
+    pub token: String,
+    /// Peers to ask besides the ones found by multicast
+    #[serde(default)]
+    pub static_peers: Vec<SocketAddr>,
+    /// Whether to find peers through multicast announcements
+    #[serde(default = "default_discovery")]
+    pub discovery: bool,
+}
+
+fn default_port() -> u16 {
+    DEFAULT_PORT
+}
+
+fn default_discovery() -> bool {
+    true
+}
+
+/// Known peers and the client used to fetch chunks from them
+#[derive(Clone)]
+pub struct LanPeers {
+    client: reqwest::Client,
+    token: String,
+    /// Checks that a peer's chunk decrypts before it is handed out
+    encryption_service: EncryptionService,
+    static_peers: Vec<SocketAddr>,
+    /// Peers found by multicast, with when they last announced themselves
+    discovered: Arc<RwLock<HashMap<SocketAddr, Instant>>>,
+    /// Peers that were unreachable or served a bad chunk, with when they failed
+    failed: Arc<RwLock<HashMap<SocketAddr, Instant>>>,
+}
+
+impl LanPeers {
+    pub fn new(config: &LanPeerConfig, encryption_service: EncryptionService) -> Self {
+        let client = reqwest::Client::builder()
+            .connect_timeout(PEER_CONNECT_TIMEOUT)
+            .timeout(PEER_REQUEST_TIMEOUT)
+            .build()
+            .expect("Failed to create LAN peer HTTP client");
+
+        LanPeers {
+            client,
+            token: config.token.clone(),
+            encryption_service,
+            static_peers: config.static_peers.clone(),
+            discovered: Arc::new(RwLock::new(HashMap::new())),
+            failed: Arc::new(RwLock::new(HashMap::new())),
+        }
+    }
+
+    /// Ask every known peer for a chunk and return the first copy that decrypts
+    ///
+    /// Returns None if no peer has a good copy, so the caller falls back to the bucket.
+    pub async fn fetch_chunk(&self, chunk_id: &str) -> Option<Vec<u8>> {
+        let peers = self.peers();
+        if peers.is_empty() {
+            return None;
+        }
+
+        let requests = peers
+            .into_iter()
+            .map(|peer| self.fetch_from(peer, chunk_id).boxed());
+        match future::select_ok(requests).await {
+            Ok((data, _)) => Some(data),
+            Err(e) => {
+                debug!("No LAN peer served chunk {}: {}", chunk_id, e);
+
+                None
+            }
+        }
+    }
+
+    async fn fetch_from(&self, peer: SocketAddr, chunk_id: &str) -> Result<Vec<u8>, String> {
+        let challenge = self
+            .client
+            .get(format!("http://{}/challenge", peer))
+            .send()
+            .await
+            .and_then(|response| response.error_for_status())
+            .map_err(|e| self.peer_failed(peer, e.to_string()))?
+            .text()
+            .await
+            .map_err(|e| self.peer_failed(peer, e.to_string()))?;
+
+        let signature = sign(&self.token, &format!("{} {}", challenge, chunk_id));
+        let response = self
+            .client
+            .get(format!("http://{}/chunks/{}", peer, chunk_id))
+            .header(
+                header::AUTHORIZATION,
+                format!("{} {} {}", AUTH_SCHEME, challenge, signature),
+            )
+            .send()
+            .await
+            .map_err(|e| self.peer_failed(peer, e.to_string()))?;
+
+        // A miss is normal and doesn't count against the peer
+        if !response.status().is_success() {
+            return Err(format!("{}: {}", peer, response.status()));
+        }
+
+        let data = response
+            .bytes()
+            .await
+            .map_err(|e| self.peer_failed(peer, e.to_string()))?;
+
+        // Anyone on the network can answer, so only keep bytes that authenticate
+        self.encryption_service
+            .decrypt_chunk(&data)
+            .map_err(|e| self.peer_failed(peer, format!("bad chunk {}: {}", chunk_id, e)))?;
+
+        debug!("Fetched chunk {} from LAN peer {}", chunk_id, peer);
+
+        self.failed
+            .write()
+            .unwrap_or_else(|e| e.into_inner())
+            .remove(&peer);
+        Ok(data.to_vec())
+    }
+
+    /// Skip a peer for a while after a failed request, returning the error to report
+    fn peer_failed(&self, peer: SocketAddr, error: String) -> String {
+        let mut failed = self.failed.write().unwrap_or_else(|e| e.into_inner());
+        if failed.insert(peer, Instant::now()).is_none() {
+            info!(
+                "Skipping LAN peer {} for {:?}: {}",
+                peer, PEER_RETRY_AFTER, error
+            );
+        }
+        failed.retain(|_, failed_at| failed_at.elapsed() < PEER_RETRY_AFTER);
+        format!("{}: {}", peer, error)
+    }
+
+    /// Static peers plus the discovered ones that are still announcing, minus recent failures
+    fn peers(&self) -> Vec<SocketAddr> {
+        let mut peers = self.static_peers.clone();
+        let discovered = self.discovered.read().unwrap_or_else(|e| e.into_inner());
+        peers.extend(
+            discovered
+                .iter()
+                .filter(|(peer, last_seen)| {
+                    last_seen.elapsed() < PEER_TTL && !self.static_peers.contains(peer)
+                })
+                .map(|(peer, _)| *peer),
+        );
+
+        let failed = self.failed.read().unwrap_or_else(|e| e.into_inner());
+        peers.retain(|peer| {
+            failed
+                .get(peer)
+                .is_none_or(|failed_at| failed_at.elapsed() >= PEER_RETRY_AFTER)
+        });
+        peers
+    }
+
+    fn peer_announced(&self, peer: SocketAddr) {
+        let mut discovered = self.discovered.write().unwrap_or_else(|e| e.into_inner());
+        if discovered.insert(peer, Instant::now()).is_none() {
+            info!("Discovered LAN peer {}", peer);
+        }
+        discovered.retain(|_, last_seen| last_seen.elapsed() < PEER_TTL);
+    }
+}
+
+#[derive(Clone)]
+struct ChunkServiceState {
+    cache: CacheManager,
+    token: Arc<str>,
+    /// Challenges handed out and not yet answered, with when they were issued
+    challenges: Arc<Mutex<HashMap<String, Instant>>>,
+}
+
+/// Router serving encrypted chunks from the cache to authenticated peers
+pub fn create_chunk_router(cache: CacheManager, token: &str) -> Router {
+    Router::new()
+        .route("/challenge", get(get_challenge))
+        .route("/chunks/:chunk_id", get(get_chunk))
+        .with_state(ChunkServiceState {
+            cache,
+            token: Arc::from(token),
+            challenges: Arc::new(Mutex::new(HashMap::new())),
+        })
+}
+
+/// Serve chunks to peers until the listener fails
+///
+/// Plain HTTP is enough here: the token never crosses the network and chunks are
+/// only ever served encrypted.
+pub async fn serve_chunks(config: LanPeerConfig, cache: CacheManager) {
+    let listener = match tokio::net::TcpListener::bind(("0.0.0.0", config.port)).await {
+        Ok(listener) => {
+            info!("LAN chunk service listening on port {}", config.port);
+            listener
+        }
+        Err(e) => {
+            error!("Failed to bind LAN chunk service: {}", e);
+            return;
+        }
+    };
+
+    if let Err(e) = axum::serve(listener, create_chunk_router(cache, &config.token)).await {
+        error!("LAN chunk service error: {}", e);
+    }
+}
+
+/// Hand out a single-use challenge for the next chunk request
+async fn get_challenge(State(state): State<ChunkServiceState>) -> Response {
+    let mut challenges = state.challenges.lock().unwrap_or_else(|e| e.into_inner());
+    challenges.retain(|_, issued| issued.elapsed() < CHALLENGE_TTL);
+    if challenges.len() >= MAX_OPEN_CHALLENGES {
+        return StatusCode::SERVICE_UNAVAILABLE.into_response();
+    }
+
+    let challenge = hex::encode(rand::random::<[u8; 32]>());
+    challenges.insert(challenge.clone(), Instant::now());
+    challenge.into_response()
+}
+
+async fn get_chunk(
+    State(state): State<ChunkServiceState>,
+    Path(chunk_id): Path<String>,
+    headers: HeaderMap,
+) -> Response {
+    let credentials = headers
+        .get(header::AUTHORIZATION)
+        .and_then(|value| value.to_str().ok())
+        .and_then(|value| value.strip_prefix(AUTH_SCHEME)?.strip_prefix(' '))
+        .and_then(|value| value.split_once(' '));
+    let Some((challenge, signature)) = credentials else {
+        return StatusCode::UNAUTHORIZED.into_response();
+    };
+
+    // Challenges are consumed whether or not the signature checks out
+    let issued = state
+        .challenges
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+        .remove(challenge);
+    let fresh = issued.is_some_and(|issued| issued.elapsed() < CHALLENGE_TTL);
+    if !fresh
+        || !verify(
+            &state.token,
+            &format!("{} {}", challenge, chunk_id),
+            signature,
+        )
+    {
+        return StatusCode::UNAUTHORIZED.into_response();
+    }
+
+    match state.cache.get_chunk(&chunk_id).await {
+        Ok(Some(data)) => data.into_response(),
+        Ok(None) => StatusCode::NOT_FOUND.into_response(),
+        Err(e) => {
+            warn!("Failed to read chunk {} for a LAN peer: {}", chunk_id, e);
+
+            StatusCode::INTERNAL_SERVER_ERROR.into_response()
+        }
+    }
+}
+
+/// Hex HMAC-SHA256 of `message` keyed by the group token
+fn sign(token: &str, message: &str) -> String {
+    let mut mac =
+        HmacSha256::new_from_slice(token.as_bytes()).expect("HMAC takes keys of any size");
+    mac.update(message.as_bytes());
+    hex::encode(mac.finalize().into_bytes())
+}
+
+/// Check a hex HMAC from `sign` in constant time
+fn verify(token: &str, message: &str, signature: &str) -> bool {
+    let Ok(signature) = hex::decode(signature) else {
+        return false;
+    };
+    let mut mac =
+        HmacSha256::new_from_slice(token.as_bytes()).expect("HMAC takes keys of any size");
+    mac.update(message.as_bytes());
+    mac.verify_slice(&signature).is_ok()
+}
+
+/// Announce this node and collect announcements from others in the same group
+///
+/// `group` keeps nodes that use different buckets apart.
+pub async fn discover_peers(peers: LanPeers, group: String, service_port: u16) {
+    if let Err(e) = run_discovery(peers, group, service_port).await {
+        warn!("LAN peer discovery stopped: {}", e);
+    }
+}
+
+async fn run_discovery(peers: LanPeers, group: String, service_port: u16) -> std::io::Result<()> {
+    let socket = discovery_socket()?;
+    let node_id = uuid::Uuid::new_v4().to_string();
+    let target = SocketAddrV4::new(DISCOVERY_GROUP, DISCOVERY_PORT);
+
+    let mut announce_interval = tokio::time::interval(ANNOUNCE_INTERVAL);
+    let mut buf = [0u8; 512];
+    loop {
+        tokio::select! {
+            _ = announce_interval.tick() => {
+                let announcement = announcement(&peers.token, &group, &node_id, service_port, unix_time());
+                if let Err(e) = socket.send_to(announcement.as_bytes(), target).await {
+                    debug!("Failed to send LAN peer announcement: {}", e);
+                }
+            }
+            received = socket.recv_from(&mut buf) => {
+                let (len, from) = received?;
+                if let Some(port) = parse_announcement(&buf[..len], &peers.token, &group, &node_id, unix_time()) {
+                    peers.peer_announced(SocketAddr::new(from.ip(), port));
+                }
+            }
+        }
+    }
+}
+
+fn unix_time() -> u64 {
+    SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map(|since| since.as_secs())
+        .unwrap_or(0)
+}
+
+/// Signed announcement of this node's service port
+fn announcement(token: &str, group: &str, node_id: &str, service_port: u16, now: u64) -> String {
+    let message = format!(
+        "{} {} {} {} {}",
+        ANNOUNCE_PREFIX, group, node_id, service_port, now
+    );
+    let signature = sign(token, &message);
+    format!("{} {}", message, signature)
+}
+
+/// Multicast socket that several nodes on one host can share
+fn discovery_socket() -> std::io::Result<tokio::net::UdpSocket> {
+    let socket = Socket::new(Domain::IPV4, Type::DGRAM, Some(Protocol::UDP))?;
+    socket.set_reuse_address(true)?;
+    #[cfg(unix)]
+    socket.set_reuse_port(true)?;
+    socket.bind(&SocketAddrV4::new(Ipv4Addr::UNSPECIFIED, DISCOVERY_PORT).into())?;
+    socket.join_multicast_v4(&DISCOVERY_GROUP, &Ipv4Addr::UNSPECIFIED)?;
+    socket.set_multicast_loop_v4(true)?;
+    socket.set_nonblocking(true)?;
+    tokio::net::UdpSocket::from_std(socket.into())
+}
+
+/// Service port announced by another node of the same group
+///
+/// Announcements that aren't signed with the group token, or are too old, are ignored.
+fn parse_announcement(
+    message: &[u8],
+    token: &str,
+    group: &str,
+    own_node_id: &str,
+    now: u64,
+) -> Option<u16> {
+    let message = std::str::from_utf8(message).ok()?;
+    let (signed, signature) = message.rsplit_once(' ')?;
+    if !verify(token, signed, signature) {
+        return None;
+    }
+
+    let mut parts = signed.split_whitespace();
+    if parts.next()? != ANNOUNCE_PREFIX || parts.next()? != group {
+        return None;
+    }
+    if parts.next()? == own_node_id {
+        return None;
+    }
+    let port = parts.next()?.parse().ok()?;
+    let sent: u64 = parts.next()?.parse().ok()?;
+    if sent.abs_diff(now) > ANNOUNCE_MAX_AGE.as_secs() {
+        return None;
+    }
+    Some(port)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::cache::CacheConfig;
+
+    #[tokio::test]
+    async fn test_fetch_chunk_from_loopback_peer() {
+        let encryption_service = EncryptionService::new_with_key(vec![0u8; 32]);
+        let encrypted = encryption_service
+            .encrypt_chunk(b"audio bytes")
+            .unwrap()
+            .to_bytes();
+
+        let temp_dir = tempfile::tempdir().unwrap();
+        let cache = CacheManager::with_config(CacheConfig {
+            cache_dir: temp_dir.path().to_path_buf(),
+            max_size_bytes: 1024 * 1024,
+            max_chunks: 10,
+        })
+        .await
+        .unwrap();
+        cache.put_chunk("chunk-1", &encrypted).await.unwrap();
+        cache.put_chunk("chunk-3", b"not a chunk").await.unwrap();
+
+        let listener = tokio::net::TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let addr = listener.local_addr().unwrap();
+        tokio::spawn(async move {
+            axum::serve(listener, create_chunk_router(cache, "secret"))
+                .await
+                .unwrap();
+        });
+
+        let config = |token: &str| LanPeerConfig {
+            port: 0,
+            token: token.to_string(),
+            static_peers: vec![addr],
+            discovery: false,
+        };
+
+        let peers = LanPeers::new(&config("secret"), encryption_service.clone());
+        assert_eq!(peers.fetch_chunk("chunk-1").await, Some(encrypted.clone()));
+        assert_eq!(peers.fetch_chunk("chunk-2").await, None);
+
+        let wrong_token = LanPeers::new(&config("guess"), encryption_service.clone());
+        assert_eq!(wrong_token.fetch_chunk("chunk-1").await, None);
+
+        // A chunk that doesn't decrypt is dropped and the peer is skipped afterwards
+        assert_eq!(peers.fetch_chunk("chunk-3").await, None);
+        assert_eq!(peers.fetch_chunk("chunk-1").await, None);
+    }
+
+    #[test]
+    fn test_announcements_need_the_group_token() {
+        let message = announcement("secret", "bucket", "node-a", 4000, 1_000);
+
+        let parse = |token: &str, now: u64| {
+            parse_announcement(message.as_bytes(), token, "bucket", "node-b", now)
+        };
+        assert_eq!(parse("secret", 1_010), Some(4000));
+        assert_eq!(parse("guess", 1_010), None);
+        assert_eq!(parse("secret", 2_000), None);
+
+        let tampered = message.replace(" 4000 ", " 4001 ");
+        assert_eq!(
+            parse_announcement(tampered.as_bytes(), "secret", "bucket", "node-b", 1_010),
+            None
+        );
+    }
+}
@@ -16,7 +16,9 @@ pub mod db;
 pub mod discogs;
 pub mod encryption;
 pub mod import;
+pub mod lan_peers;
 pub mod library;
+pub mod memory;
 pub mod musicbrainz;
 pub mod network;
 pub mod torrent;
@@ -0,0 +1,155 @@
+use crate::db::{DbAlbum, DbArtist, DbImage, DbRelease, DbTrack, ImportStatus};
+use std::collections::{HashMap, VecDeque};
+
+/// Number of albums whose details are kept in memory
+const MAX_CACHED_ALBUMS: usize = 32;
+
+/// Everything the album page shows for one album
+#[derive(Debug, Clone)]
+pub struct AlbumDetail {
+    pub album: DbAlbum,
+    pub releases: Vec<DbRelease>,
+    pub artists: Vec<DbArtist>,
+    /// Tracks of every release, ordered by disc and track number within a release
+    pub tracks: Vec<DbTrack>,
+    /// Artists credited on each track (for compilations/features), keyed by track ID
+    pub track_artists: HashMap<String, Vec<DbArtist>>,
+    /// Distinct audio formats of each release, keyed by release ID
+    pub audio_formats: HashMap<String, Vec<String>>,
+    /// Cover image of each release that has one, keyed by release ID
+    pub cover_images: HashMap<String, DbImage>,
+}
+
+impl AlbumDetail {
+    /// Tracks of one release
+    pub fn tracks_for_release(&self, release_id: &str) -> Vec<DbTrack> {
+        self.tracks
+            .iter()
+            .filter(|track| track.release_id == release_id)
+            .cloned()
+            .collect()
+    }
+
+    /// Audio formats of a release for display, e.g. "FLAC" or "FLAC, MP3"
+    pub fn audio_format_summary(&self, release_id: &str) -> Option<String> {
+        let formats = self.audio_formats.get(release_id)?;
+        Some(
+            formats
+                .iter()
+                .map(|format| format.to_uppercase())
+                .collect::<Vec<_>>()
+                .join(", "),
+        )
+    }
+
+    /// Whether no release of the album is still being imported
+    fn is_settled(&self) -> bool {
+        self.releases.iter().all(|release| {
+            matches!(
+                release.import_status,
+                ImportStatus::Complete | ImportStatus::Failed
+            )
+        })
+    }
+}
+
+/// Recently opened album details
+///
+/// Only albums with no import in progress are kept, since import status and
+/// track durations change while a release imports. Every invalidation bumps the
+/// generation, so a load that raced with one is not stored.
+#[derive(Debug, Default)]
+pub struct AlbumDetailCache {
+    albums: VecDeque<AlbumDetail>,
+    generation: u64,
+}
+
+impl AlbumDetailCache {
+    pub fn get(&mut self, album_id: &str) -> Option<AlbumDetail> {
+        let index = self
+            .albums
+            .iter()
+            .position(|detail| detail.album.id == album_id)?;
+        let detail = self.albums.remove(index)?;
+        self.albums.push_front(detail.clone());
+        Some(detail)
+    }
+
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Store details loaded when the cache was at `generation`
+    pub fn insert(&mut self, detail: AlbumDetail, generation: u64) {
+        if generation != self.generation || !detail.is_settled() {
+            return;
+        }
+        self.albums
+            .retain(|cached| cached.album.id != detail.album.id);
+        self.albums.push_front(detail);
+        self.albums.truncate(MAX_CACHED_ALBUMS);
+    }
+
+    pub fn invalidate_album(&mut self, album_id: &str) {
+        self.generation += 1;
+        self.albums.retain(|detail| detail.album.id != album_id);
+    }
+
+    pub fn invalidate_release(&mut self, release_id: &str) {
+        self.generation += 1;
+        self.albums.retain(|detail| {
+            !detail
+                .releases
+                .iter()
+                .any(|release| release.id == release_id)
+        });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn album_detail(album_id: &str, release_id: &str, status: ImportStatus) -> AlbumDetail {
+        let mut album = DbAlbum::new_test("Test Album");
+        album.id = album_id.to_string();
+        let mut release = DbRelease::new_test(album_id, release_id);
+        release.import_status = status;
+        AlbumDetail {
+            album,
+            releases: vec![release],
+            artists: Vec::new(),
+            tracks: Vec::new(),
+            track_artists: HashMap::new(),
+            audio_formats: HashMap::new(),
+            cover_images: HashMap::new(),
+        }
+    }
+
+    #[test]
+    fn test_album_detail_cache_invalidation() {
+        let mut cache = AlbumDetailCache::default();
+
+        let generation = cache.generation();
+        cache.insert(
+            album_detail("album-1", "release-1", ImportStatus::Complete),
+            generation,
+        );
+        cache.insert(
+            album_detail("album-2", "release-2", ImportStatus::Importing),
+            generation,
+        );
+        assert!(cache.get("album-1").is_some());
+        assert!(cache.get("album-2").is_none());
+
+        cache.invalidate_release("release-1");
+        assert!(cache.get("album-1").is_none());
+
+        // A load that started before an invalidation is not stored
+        cache.insert(
+            album_detail("album-1", "release-1", ImportStatus::Complete),
+            generation,
+        );
+        assert!(cache.get("album-1").is_none());
+    }
+}
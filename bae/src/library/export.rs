@@ -1,21 +1,40 @@
 use crate::cache::CacheManager;
 use crate::cloud_storage::CloudStorageManager;
-use crate::db::DbChunk;
+use crate::db::{DbChunk, DbFile};
 use crate::encryption::EncryptionService;
 use crate::library::LibraryManager;
+use crate::memory::{LeaseKind, MemoryGovernor};
 use crate::playback::reassembly::reassemble_track;
 use futures::stream::{self, StreamExt};
 use std::path::Path;
+use std::sync::Arc;
 use tracing::{debug, info, warn};
 
+/// Maximum chunks downloaded, decrypted or being written at once during release export
+const MAX_IN_FLIGHT_CHUNKS: usize = 10;
+
 /// Export service for reconstructing files and tracks from chunks
 pub struct ExportService;
 
+/// A slice of one decrypted chunk that belongs at a given offset in an exported file
+#[derive(Debug, Clone, PartialEq)]
+struct ChunkWrite {
+    file_index: usize,
+    offset_in_chunk: usize,
+    offset_in_file: u64,
+    len: usize,
+}
+
 impl ExportService {
     /// Export all files for a release to a directory
     ///
-    /// Reconstructs files sequentially from chunks in the order they were imported.
-    /// Files are written with their original filenames to the target directory.
+    /// Files were imported into one byte stream split into chunks of the release's
+    /// chunk size, with each file at its recorded stream offset. That gives every
+    /// chunk's destination (file, offset) ranges up front.
+    /// Chunks are then downloaded and decrypted concurrently and written with
+    /// positional writes as soon as they arrive, in any order. Memory use is
+    /// bounded by the number of chunks in flight, not the size of the release,
+    /// and each chunk in flight is leased from the memory budget first.
     pub async fn export_release(
         release_id: &str,
         target_dir: &Path,
@@ -23,7 +42,7 @@ impl ExportService {
         cloud_storage: &CloudStorageManager,
         cache: &CacheManager,
         encryption_service: &EncryptionService,
-        _chunk_size_bytes: usize,
+        memory: &MemoryGovernor,
     ) -> Result<(), String> {
         info!(
             "Exporting release {} to {}",
@@ -31,13 +50,13 @@ impl ExportService {
             target_dir.display()
         );
 
-        // Get all files for the release, sorted by filename (matches import order)
+        // Get all files for the release, in stream order
         let mut files = library_manager
             .get_files_for_release(release_id)
             .await
             .map_err(|e| format!("Failed to get files: {}", e))?;
 
-        files.sort_by(|a, b| a.original_filename.cmp(&b.original_filename));
+        files.sort_by_key(|f| f.stream_offset);
 
         if files.is_empty() {
             return Err("No files found for release".to_string());
@@ -55,14 +74,45 @@ impl ExportService {
             return Err("No chunks found for release".to_string());
         }
 
-        // Download and decrypt all chunks in parallel (max 10 concurrent)
-        info!("Downloading {} chunks...", chunks.len());
-        let chunk_results: Vec<Result<(i32, Vec<u8>), String>> = stream::iter(chunks.iter())
-            .map(|chunk| {
+        let chunk_size_bytes = library_manager
+            .get_release_chunk_size(release_id)
+            .await
+            .map_err(|e| format!("Failed to get chunk size: {}", e))?;
+
+        // Work out where every chunk's bytes land before downloading anything
+        let chunk_writes = plan_chunk_writes(&files, chunks.len(), chunk_size_bytes)?;
+
+        // Create every output file at its final size so chunks can be written at any offset
+        let mut output_files = Vec::with_capacity(files.len());
+        for file in &files {
+            let file_path = target_dir.join(&file.original_filename);
+            let output = std::fs::File::create(&file_path)
+                .map_err(|e| format!("Failed to create file {}: {}", file.original_filename, e))?;
+            output.set_len(file.file_size as u64).map_err(|e| {
+                format!("Failed to allocate file {}: {}", file.original_filename, e)
+            })?;
+            output_files.push(output);
+        }
+        let output_files = Arc::new(output_files);
+
+        info!(
+            "Downloading {} chunks ({} in flight)...",
+            chunks.len(),
+            MAX_IN_FLIGHT_CHUNKS
+        );
+        let mut writes = stream::iter(chunks.iter().zip(chunk_writes))
+            .map(|(chunk, writes)| {
                 let cloud_storage = cloud_storage.clone();
                 let cache = cache.clone();
                 let encryption_service = encryption_service.clone();
+                let output_files = output_files.clone();
                 async move {
+                    if writes.is_empty() {
+                        return Ok(());
+                    }
+
+                    // Covers the encrypted and decrypted copies of the chunk
+                    let _lease = memory.acquire(2 * chunk.encrypted_size as u64).await;
                     let chunk_data = download_and_decrypt_chunk(
                         chunk,
                         &cloud_storage,
@@ -70,72 +120,25 @@ impl ExportService {
                         &encryption_service,
                     )
                     .await?;
-                    Ok::<_, String>((chunk.chunk_index, chunk_data))
+
+                    tokio::task::spawn_blocking(move || {
+                        write_chunk(&chunk_data, &writes, &output_files)
+                    })
+                    .await
+                    .map_err(|e| format!("Write task failed: {}", e))?
+                    .map_err(|e| format!("Failed to write chunk {}: {}", chunk.id, e))
                 }
             })
-            .buffer_unordered(10)
-            .collect()
-            .await;
-
-        // Check for errors and collect indexed chunks
-        let mut indexed_chunks: Vec<(i32, Vec<u8>)> = Vec::new();
-        for result in chunk_results {
-            indexed_chunks.push(result?);
-        }
+            .buffer_unordered(MAX_IN_FLIGHT_CHUNKS);
 
-        // Sort by chunk index to ensure correct order
-        indexed_chunks.sort_by_key(|(idx, _)| *idx);
-        let chunk_data: Vec<Vec<u8>> = indexed_chunks.into_iter().map(|(_, data)| data).collect();
-
-        // Reconstruct files sequentially
-        // Files are stored sequentially in chunks, so we iterate through chunks
-        // and extract file_size bytes for each file
-        let mut chunk_offset = 0usize;
-        let mut byte_offset_in_chunk = 0usize;
+        while let Some(result) = writes.next().await {
+            result?;
+        }
 
         for file in &files {
-            let file_size = file.file_size as usize;
-            let mut file_data = Vec::with_capacity(file_size);
-            let mut remaining_bytes = file_size;
-
-            // Extract file data from chunks
-            while remaining_bytes > 0 && chunk_offset < chunk_data.len() {
-                let current_chunk = &chunk_data[chunk_offset];
-                let available_in_chunk = current_chunk.len() - byte_offset_in_chunk;
-                let bytes_to_take = remaining_bytes.min(available_in_chunk);
-
-                file_data.extend_from_slice(
-                    &current_chunk[byte_offset_in_chunk..byte_offset_in_chunk + bytes_to_take],
-                );
-
-                remaining_bytes -= bytes_to_take;
-                byte_offset_in_chunk += bytes_to_take;
-
-                // Move to next chunk if we've consumed this one
-                if byte_offset_in_chunk >= current_chunk.len() {
-                    chunk_offset += 1;
-                    byte_offset_in_chunk = 0;
-                }
-            }
-
-            if remaining_bytes > 0 {
-                return Err(format!(
-                    "Not enough data to reconstruct file {} (needed {} bytes, got {})",
-                    file.original_filename,
-                    file_size,
-                    file_size - remaining_bytes
-                ));
-            }
-
-            // Write file to target directory
-            let file_path = target_dir.join(&file.original_filename);
-            std::fs::write(&file_path, &file_data)
-                .map_err(|e| format!("Failed to write file {}: {}", file.original_filename, e))?;
-
             debug!(
                 "Exported file {} ({} bytes)",
-                file.original_filename,
-                file_data.len()
+                file.original_filename, file.file_size
             );
         }
 
@@ -158,18 +161,19 @@ impl ExportService {
         cloud_storage: &CloudStorageManager,
         cache: &CacheManager,
         encryption_service: &EncryptionService,
-        chunk_size_bytes: usize,
+        memory: &MemoryGovernor,
     ) -> Result<(), String> {
         info!("Exporting track {} to {}", track_id, output_path.display());
 
         // Use existing reassemble_track function
-        let audio_data = reassemble_track(
+        let (audio_data, _lease) = reassemble_track(
             track_id,
             library_manager,
             cloud_storage,
             cache,
             encryption_service,
-            chunk_size_bytes,
+            memory,
+            LeaseKind::Buffer,
         )
         .await?;
 
@@ -238,3 +242,143 @@ async fn download_and_decrypt_chunk(
 
     Ok(decrypted_data)
 }
+
+/// Compute the destination ranges of every chunk.
+///
+/// Each file starts at its `stream_offset` in the release's byte stream, which
+/// is cut into `chunk_size` chunks. Returns one list of writes per chunk position.
+fn plan_chunk_writes(
+    files: &[DbFile],
+    num_chunks: usize,
+    chunk_size: usize,
+) -> Result<Vec<Vec<ChunkWrite>>, String> {
+    let mut plan = vec![Vec::new(); num_chunks];
+
+    for (file_index, file) in files.iter().enumerate() {
+        let file_size = file.file_size as usize;
+        let mut stream_pos = file.stream_offset as usize;
+        let mut written = 0usize;
+
+        while written < file_size {
+            let chunk_position = stream_pos / chunk_size;
+            let offset_in_chunk = stream_pos % chunk_size;
+            let len = (file_size - written).min(chunk_size - offset_in_chunk);
+
+            let chunk_writes = plan.get_mut(chunk_position).ok_or_else(|| {
+                format!(
+                    "Not enough data to reconstruct file {} (needed {} bytes, got {})",
+                    file.original_filename, file_size, written
+                )
+            })?;
+            chunk_writes.push(ChunkWrite {
+                file_index,
+                offset_in_chunk,
+                offset_in_file: written as u64,
+                len,
+            });
+
+            written += len;
+            stream_pos += len;
+        }
+    }
+
+    Ok(plan)
+}
+
+/// Write a decrypted chunk's slices into the output files with positional writes
+fn write_chunk(
+    chunk_data: &[u8],
+    writes: &[ChunkWrite],
+    output_files: &[std::fs::File],
+) -> std::io::Result<()> {
+    for write in writes {
+        let bytes = chunk_data
+            .get(write.offset_in_chunk..write.offset_in_chunk + write.len)
+            .ok_or_else(|| {
+                std::io::Error::new(
+                    std::io::ErrorKind::UnexpectedEof,
+                    format!(
+                        "chunk has {} bytes, expected at least {}",
+                        chunk_data.len(),
+                        write.offset_in_chunk + write.len
+                    ),
+                )
+            })?;
+        write_all_at(&output_files[write.file_index], bytes, write.offset_in_file)?;
+    }
+    Ok(())
+}
+
+/// Write at an offset with a positional write rather than seek + write
+#[cfg(unix)]
+fn write_all_at(file: &std::fs::File, buf: &[u8], offset: u64) -> std::io::Result<()> {
+    use std::os::unix::fs::FileExt;
+    file.write_all_at(buf, offset)
+}
+
+#[cfg(windows)]
+fn write_all_at(file: &std::fs::File, mut buf: &[u8], mut offset: u64) -> std::io::Result<()> {
+    use std::os::windows::fs::FileExt;
+    while !buf.is_empty() {
+        match file.seek_write(buf, offset)? {
+            0 => return Err(std::io::ErrorKind::WriteZero.into()),
+            n => {
+                buf = &buf[n..];
+                offset += n as u64;
+            }
+        }
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_plan_chunk_writes_spans_files_across_chunks() {
+        let files = vec![
+            DbFile::new("release", "01.flac", 6, "flac", 0),
+            DbFile::new("release", "02.flac", 5, "flac", 6),
+        ];
+
+        let plan = plan_chunk_writes(&files, 3, 4).unwrap();
+
+        let write = |file_index, offset_in_chunk, offset_in_file, len| ChunkWrite {
+            file_index,
+            offset_in_chunk,
+            offset_in_file,
+            len,
+        };
+        assert_eq!(plan[0], vec![write(0, 0, 0, 4)]);
+        assert_eq!(plan[1], vec![write(0, 0, 4, 2), write(1, 2, 0, 2)]);
+        assert_eq!(plan[2], vec![write(1, 0, 2, 3)]);
+    }
+
+    #[test]
+    fn test_plan_chunk_writes_rejects_missing_chunks() {
+        let files = vec![DbFile::new("release", "01.flac", 9, "flac", 0)];
+
+        assert!(plan_chunk_writes(&files, 2, 4).is_err());
+    }
+
+    #[test]
+    fn test_plan_chunk_writes_skips_alignment_padding() {
+        let files = vec![
+            DbFile::new("release", "01.flac", 6, "flac", 0),
+            DbFile::new("release", "cover.jpg", 1, "jpg", 6),
+            DbFile::new("release", "02.flac", 3, "flac", 8),
+        ];
+
+        let plan = plan_chunk_writes(&files, 3, 4).unwrap();
+
+        let write = |file_index, offset_in_chunk, offset_in_file, len| ChunkWrite {
+            file_index,
+            offset_in_chunk,
+            offset_in_file,
+            len,
+        };
+        assert_eq!(plan[1], vec![write(0, 0, 4, 2), write(1, 2, 0, 1)]);
+        assert_eq!(plan[2], vec![write(2, 0, 0, 3)]);
+    }
+}
@@ -1,14 +1,24 @@
 use crate::cache::CacheManager;
-use crate::cloud_storage::{CloudStorageError, CloudStorageManager};
+use crate::cloud_storage::{CloudStorageError, CloudStorageManager, DeleteJob};
 use crate::db::{
     Database, DbAlbum, DbAlbumArtist, DbArtist, DbAudioFormat, DbChunk, DbFile, DbImage, DbRelease,
     DbTorrent, DbTrack, DbTrackArtist, DbTrackChunkCoords, ImportStatus,
 };
 use crate::encryption::EncryptionService;
+use crate::library::album_detail::{AlbumDetail, AlbumDetailCache};
 use crate::library::export::ExportService;
+use crate::memory::MemoryGovernor;
+use std::collections::HashMap;
 use std::path::Path;
+use std::sync::{Arc, Mutex};
 use thiserror::Error;
-use tracing::warn;
+use tracing::{info, warn};
+
+/// Chunk size read for releases with none recorded
+///
+/// Sizes of releases imported before they were chosen per release are filled in from
+/// their chunks when the column is added, so only releases without chunks get this.
+const LEGACY_CHUNK_SIZE_BYTES: usize = 1024 * 1024;
 
 #[derive(Error, Debug)]
 pub enum LibraryError {
@@ -35,6 +45,7 @@ pub enum LibraryError {
 pub struct LibraryManager {
     database: Database,
     cloud_storage: CloudStorageManager,
+    album_details: Arc<Mutex<AlbumDetailCache>>,
 }
 
 impl LibraryManager {
@@ -43,6 +54,7 @@ impl LibraryManager {
         LibraryManager {
             database,
             cloud_storage,
+            album_details: Arc::new(Mutex::new(AlbumDetailCache::default())),
         }
     }
 
@@ -61,6 +73,10 @@ impl LibraryManager {
         self.database
             .insert_album_with_release_and_tracks(album, release, tracks)
             .await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_album(&album.id);
         Ok(())
     }
 
@@ -105,14 +121,42 @@ impl LibraryManager {
         self.database
             .update_release_status(release_id, ImportStatus::Complete)
             .await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_release(release_id);
+        Ok(())
+    }
+
+    /// Record the chunk size chosen for a release when its data is chunked
+    pub async fn set_release_chunk_size(
+        &self,
+        release_id: &str,
+        chunk_size_bytes: usize,
+    ) -> Result<(), LibraryError> {
+        self.database
+            .set_release_chunk_size(release_id, chunk_size_bytes as i64)
+            .await?;
         Ok(())
     }
 
+    /// Get the chunk size a release was imported with
+    ///
+    /// Releases without chunks may have none recorded, and read as the old default size.
+    pub async fn get_release_chunk_size(&self, release_id: &str) -> Result<usize, LibraryError> {
+        let chunk_size_bytes = self.database.get_release_chunk_size(release_id).await?;
+        Ok(chunk_size_bytes.map_or(LEGACY_CHUNK_SIZE_BYTES, |size| size as usize))
+    }
+
     /// Mark release as failed if import errors
     pub async fn mark_release_failed(&self, release_id: &str) -> Result<(), LibraryError> {
         self.database
             .update_release_status(release_id, ImportStatus::Failed)
             .await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_release(release_id);
         Ok(())
     }
 
@@ -128,6 +172,12 @@ impl LibraryManager {
         Ok(())
     }
 
+    /// Add many files to the library in one transaction
+    pub async fn add_files(&self, files: &[DbFile]) -> Result<(), LibraryError> {
+        self.database.insert_files(files).await?;
+        Ok(())
+    }
+
     /// Add audio format for a track
     pub async fn add_audio_format(&self, audio_format: &DbAudioFormat) -> Result<(), LibraryError> {
         self.database.insert_audio_format(audio_format).await?;
@@ -143,6 +193,18 @@ impl LibraryManager {
         Ok(())
     }
 
+    /// Add the audio formats and chunk coordinates of many tracks in one transaction
+    pub async fn add_track_metadata_batch(
+        &self,
+        audio_formats: &[DbAudioFormat],
+        coords: &[DbTrackChunkCoords],
+    ) -> Result<(), LibraryError> {
+        self.database
+            .insert_track_metadata_batch(audio_formats, coords)
+            .await?;
+        Ok(())
+    }
+
     /// Insert torrent metadata
     pub async fn insert_torrent(&self, torrent: &DbTorrent) -> Result<(), LibraryError> {
         self.database.insert_torrent(torrent).await?;
@@ -157,12 +219,12 @@ impl LibraryManager {
         Ok(self.database.get_torrent_by_release(release_id).await?)
     }
 
-    /// Insert torrent piece mapping
-    pub async fn insert_torrent_piece_mapping(
+    /// Insert the piece map for a torrent
+    pub async fn insert_torrent_piece_map(
         &self,
-        mapping: &crate::db::DbTorrentPieceMapping,
+        piece_map: &crate::db::DbTorrentPieceMap,
     ) -> Result<(), LibraryError> {
-        self.database.insert_torrent_piece_mapping(mapping).await?;
+        self.database.insert_torrent_piece_map(piece_map).await?;
         Ok(())
     }
 
@@ -193,6 +255,67 @@ impl LibraryManager {
         Ok(self.database.get_album_by_id(album_id).await?)
     }
 
+    /// Get everything the album page shows in one call
+    ///
+    /// Runs a few album-wide queries concurrently instead of one per release or
+    /// track. Albums with no import in progress are memoized until an import or
+    /// deletion touches them.
+    pub async fn get_album_detail(
+        &self,
+        album_id: &str,
+    ) -> Result<Option<AlbumDetail>, LibraryError> {
+        let generation = {
+            let mut album_details = self.album_details.lock().unwrap();
+            if let Some(detail) = album_details.get(album_id) {
+                return Ok(Some(detail));
+            }
+            album_details.generation()
+        };
+
+        let (album, releases, artists, tracks, track_artists, audio_formats, cover_images) = tokio::try_join!(
+            self.database.get_album_by_id(album_id),
+            self.database.get_releases_for_album(album_id),
+            self.database.get_artists_for_album(album_id),
+            self.database.get_tracks_for_album(album_id),
+            self.database.get_track_artists_for_album(album_id),
+            self.database.get_audio_formats_for_album(album_id),
+            self.database.get_cover_images_for_album(album_id),
+        )?;
+        let Some(album) = album else {
+            return Ok(None);
+        };
+
+        let mut artists_by_track: HashMap<String, Vec<DbArtist>> = HashMap::new();
+        for (track_id, artist) in track_artists {
+            artists_by_track.entry(track_id).or_default().push(artist);
+        }
+        let mut formats_by_release: HashMap<String, Vec<String>> = HashMap::new();
+        for (release_id, format) in audio_formats {
+            formats_by_release
+                .entry(release_id)
+                .or_default()
+                .push(format);
+        }
+
+        let detail = AlbumDetail {
+            album,
+            releases,
+            artists,
+            tracks,
+            track_artists: artists_by_track,
+            audio_formats: formats_by_release,
+            cover_images: cover_images
+                .into_iter()
+                .map(|image| (image.release_id.clone(), image))
+                .collect(),
+        };
+        self.album_details
+            .lock()
+            .unwrap()
+            .insert(detail.clone(), generation);
+        Ok(Some(detail))
+    }
+
     /// Get all releases for a specific album
     pub async fn get_releases_for_album(
         &self,
@@ -345,6 +468,22 @@ impl LibraryManager {
         Ok(self.database.get_artists_for_album(album_id).await?)
     }
 
+    /// Get the artists of many albums at once, keyed by album ID
+    pub async fn get_artists_for_albums(
+        &self,
+        album_ids: &[String],
+    ) -> Result<HashMap<String, Vec<DbArtist>>, LibraryError> {
+        Ok(self.database.get_artists_for_albums(album_ids).await?)
+    }
+
+    /// Count the tracks of the first release of many albums, keyed by album ID
+    pub async fn get_track_counts_for_albums(
+        &self,
+        album_ids: &[String],
+    ) -> Result<HashMap<String, i64>, LibraryError> {
+        Ok(self.database.get_track_counts_for_albums(album_ids).await?)
+    }
+
     /// Get artists for a track
     pub async fn get_artists_for_track(
         &self,
@@ -385,6 +524,10 @@ impl LibraryManager {
         image_id: &str,
     ) -> Result<(), LibraryError> {
         self.database.set_cover_image(release_id, image_id).await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_release(release_id);
         Ok(())
     }
 
@@ -392,32 +535,31 @@ impl LibraryManager {
     ///
     /// This will:
     /// 1. Get all chunks for the release
-    /// 2. Delete chunks from cloud storage (errors are logged but don't stop deletion)
-    /// 3. Delete the release from database (cascades to tracks, files, chunks, etc.)
-    /// 4. If this was the last release for the album, also delete the album
-    pub async fn delete_release(&self, release_id: &str) -> Result<(), LibraryError> {
+    /// 2. Delete the release from database (cascades to tracks, files, chunks, etc.)
+    /// 3. If this was the last release for the album, also delete the album
+    /// 4. Purge the release's chunks from the local cache
+    /// 5. Start a background job deleting the chunks from cloud storage
+    ///
+    /// Returns as soon as the database is updated; the returned job reports
+    /// cloud deletion progress (errors are logged and counted, not returned).
+    /// Chunks the job does not get to are retried by `resume_chunk_deletes`.
+    pub async fn delete_release(
+        &self,
+        release_id: &str,
+        cache: &CacheManager,
+    ) -> Result<DeleteJob, LibraryError> {
         // Get album_id before deletion to check if we need to delete the album
         let album_id = self.get_album_id_for_release(release_id).await?;
 
-        // Get all chunks for the release to delete from cloud storage
+        // Get all chunks for the release before the cascade removes them
         let chunks = self.get_chunks_for_release(release_id).await?;
 
-        // Delete chunks from cloud storage
-        for chunk in &chunks {
-            if let Err(e) = self
-                .cloud_storage
-                .delete_chunk(&chunk.storage_location)
-                .await
-            {
-                warn!(
-                    "Failed to delete chunk {} from cloud storage: {}. Continuing with database deletion.",
-                    chunk.id, e
-                );
-            }
-        }
-
         // Delete release from database (cascades to tracks, files, chunks, etc.)
         self.database.delete_release(release_id).await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_album(&album_id);
 
         // Check if this was the last release for the album
         let remaining_releases = self.get_releases_for_album(&album_id).await?;
@@ -426,40 +568,83 @@ impl LibraryManager {
             self.database.delete_album(&album_id).await?;
         }
 
-        Ok(())
+        Ok(self.purge_chunks(chunks, cache).await)
     }
 
     /// Delete an album and all its associated data
     ///
     /// This will:
-    /// 1. Get all releases for the album
-    /// 2. For each release, get chunks and delete from cloud storage
-    /// 3. Delete the album from database (cascades to releases and all related data)
-    pub async fn delete_album(&self, album_id: &str) -> Result<(), LibraryError> {
-        // Get all releases for the album
+    /// 1. Get all releases for the album and their chunks
+    /// 2. Delete the album from database (cascades to releases and all related data)
+    /// 3. Purge the chunks from the local cache and start a background cloud deletion job
+    pub async fn delete_album(
+        &self,
+        album_id: &str,
+        cache: &CacheManager,
+    ) -> Result<DeleteJob, LibraryError> {
+        // Get all chunks of all releases before the cascade removes them
         let releases = self.get_releases_for_album(album_id).await?;
-
-        // For each release, get chunks and delete from cloud storage
+        let mut chunks = Vec::new();
         for release in &releases {
-            let chunks = self.get_chunks_for_release(&release.id).await?;
-            for chunk in &chunks {
-                if let Err(e) = self
-                    .cloud_storage
-                    .delete_chunk(&chunk.storage_location)
-                    .await
-                {
-                    warn!(
-                        "Failed to delete chunk {} from cloud storage: {}. Continuing with database deletion.",
-                        chunk.id, e
-                    );
-                }
-            }
+            chunks.extend(self.get_chunks_for_release(&release.id).await?);
         }
 
         // Delete album from database (cascades to releases and all related data)
         self.database.delete_album(album_id).await?;
+        self.album_details
+            .lock()
+            .unwrap()
+            .invalidate_album(album_id);
 
-        Ok(())
+        Ok(self.purge_chunks(chunks, cache).await)
+    }
+
+    /// Remove deleted chunks from the cache and delete them from cloud storage in the background
+    async fn purge_chunks(&self, chunks: Vec<DbChunk>, cache: &CacheManager) -> DeleteJob {
+        let (chunk_ids, storage_locations): (Vec<String>, Vec<String>) = chunks
+            .into_iter()
+            .map(|chunk| (chunk.id, chunk.storage_location))
+            .unzip();
+
+        cache.remove_chunks(&chunk_ids).await;
+
+        info!(
+            "Deleting {} chunks from cloud storage in the background",
+            storage_locations.len()
+        );
+
+        self.spawn_delete_chunks(storage_locations)
+    }
+
+    /// Delete chunks left in pending_chunk_deletes by a quit or failed batches
+    pub async fn resume_chunk_deletes(&self) -> Result<DeleteJob, LibraryError> {
+        let storage_locations = self.database.get_pending_chunk_deletes().await?;
+        if !storage_locations.is_empty() {
+            info!(
+                "Resuming deletion of {} chunks from cloud storage",
+                storage_locations.len()
+            );
+        }
+
+        Ok(self.spawn_delete_chunks(storage_locations))
+    }
+
+    /// Delete chunks from cloud storage, clearing their pending rows as batches finish
+    fn spawn_delete_chunks(&self, storage_locations: Vec<String>) -> DeleteJob {
+        let database = self.database.clone();
+        self.cloud_storage
+            .spawn_delete_chunks(storage_locations, move |deleted| {
+                let database = database.clone();
+                async move {
+                    if let Err(e) = database.remove_pending_chunk_deletes(&deleted).await {
+                        warn!(
+                            "Failed to clear {} pending chunk deletes: {}",
+                            deleted.len(),
+                            e
+                        );
+                    }
+                }
+            })
     }
 
     /// Export all files for a release to a directory
@@ -473,7 +658,7 @@ impl LibraryManager {
         cloud_storage: &CloudStorageManager,
         cache: &CacheManager,
         encryption_service: &EncryptionService,
-        chunk_size_bytes: usize,
+        memory: &MemoryGovernor,
     ) -> Result<(), LibraryError> {
         ExportService::export_release(
             release_id,
@@ -482,7 +667,7 @@ impl LibraryManager {
             cloud_storage,
             cache,
             encryption_service,
-            chunk_size_bytes,
+            memory,
         )
         .await
         .map_err(LibraryError::Import)
@@ -499,7 +684,7 @@ impl LibraryManager {
         cloud_storage: &CloudStorageManager,
         cache: &CacheManager,
         encryption_service: &EncryptionService,
-        chunk_size_bytes: usize,
+        memory: &MemoryGovernor,
     ) -> Result<(), LibraryError> {
         ExportService::export_track(
             track_id,
@@ -508,7 +693,7 @@ impl LibraryManager {
             cloud_storage,
             cache,
             encryption_service,
-            chunk_size_bytes,
+            memory,
         )
         .await
         .map_err(LibraryError::Import)
@@ -548,6 +733,7 @@ impl LibraryManager {
 #[cfg(test)]
 mod tests {
     use super::*;
+    use crate::cache::CacheConfig;
     use crate::cloud_storage::CloudStorageManager;
     use crate::db::{DbAlbum, DbChunk, DbRelease, ImportStatus};
     #[cfg(feature = "test-utils")]
@@ -558,14 +744,21 @@ mod tests {
     use uuid::Uuid;
 
     #[cfg(feature = "test-utils")]
-    async fn setup_test_manager() -> (LibraryManager, TempDir, CloudStorageManager) {
+    async fn setup_test_manager() -> (LibraryManager, TempDir, CloudStorageManager, CacheManager) {
         let temp_dir = TempDir::new().unwrap();
         let db_path = temp_dir.path().join("test.db");
         let database = Database::new(db_path.to_str().unwrap()).await.unwrap();
         let mock_storage = Arc::new(MockCloudStorage::new());
         let cloud_storage = CloudStorageManager::from_storage(mock_storage);
         let manager = LibraryManager::new(database, cloud_storage.clone());
-        (manager, temp_dir, cloud_storage)
+        let cache = CacheManager::with_config(CacheConfig {
+            cache_dir: temp_dir.path().join("cache"),
+            max_size_bytes: 1024 * 1024,
+            max_chunks: 100,
+        })
+        .await
+        .unwrap();
+        (manager, temp_dir, cloud_storage, cache)
     }
 
     fn create_test_album() -> DbAlbum {
@@ -596,6 +789,7 @@ mod tests {
             catalog_number: None,
             country: None,
             barcode: None,
+            chunk_size_bytes: None,
             import_status: ImportStatus::Complete,
             created_at: Utc::now(),
             updated_at: Utc::now(),
@@ -626,7 +820,7 @@ mod tests {
     #[tokio::test]
     #[cfg(feature = "test-utils")]
     async fn test_delete_release_with_single_release_deletes_album() {
-        let (manager, _temp_dir, _cloud_storage) = setup_test_manager().await;
+        let (manager, _temp_dir, _cloud_storage, cache) = setup_test_manager().await;
 
         // Create album and release
         let album = create_test_album();
@@ -638,7 +832,12 @@ mod tests {
         manager.database.insert_chunk(&chunk).await.unwrap();
 
         // Delete release
-        manager.delete_release(&release.id).await.unwrap();
+        manager
+            .delete_release(&release.id, &cache)
+            .await
+            .unwrap()
+            .wait()
+            .await;
 
         // Verify album is deleted
         let album_result = manager.database.get_album_by_id(&album.id).await.unwrap();
@@ -656,7 +855,7 @@ mod tests {
     #[tokio::test]
     #[cfg(feature = "test-utils")]
     async fn test_delete_release_with_multiple_releases_preserves_album() {
-        let (manager, _temp_dir, _cloud_storage) = setup_test_manager().await;
+        let (manager, _temp_dir, _cloud_storage, cache) = setup_test_manager().await;
 
         // Create album with two releases
         let album = create_test_album();
@@ -672,7 +871,12 @@ mod tests {
         manager.database.insert_chunk(&chunk2).await.unwrap();
 
         // Delete first release
-        manager.delete_release(&release1.id).await.unwrap();
+        manager
+            .delete_release(&release1.id, &cache)
+            .await
+            .unwrap()
+            .wait()
+            .await;
 
         // Verify album still exists
         let album_result = manager.database.get_album_by_id(&album.id).await.unwrap();
@@ -691,7 +895,7 @@ mod tests {
     #[tokio::test]
     #[cfg(feature = "test-utils")]
     async fn test_delete_album_deletes_all_releases_and_chunks() {
-        let (manager, _temp_dir, cloud_storage) = setup_test_manager().await;
+        let (manager, _temp_dir, cloud_storage, cache) = setup_test_manager().await;
 
         // Create album with two releases
         let album = create_test_album();
@@ -713,7 +917,12 @@ mod tests {
         assert!(cloud_storage.download_chunk(&location2).await.is_ok());
 
         // Delete album
-        manager.delete_album(&album.id).await.unwrap();
+        manager
+            .delete_album(&album.id, &cache)
+            .await
+            .unwrap()
+            .wait()
+            .await;
 
         // Verify album is deleted
         let album_result = manager.database.get_album_by_id(&album.id).await.unwrap();
@@ -735,7 +944,7 @@ mod tests {
     #[tokio::test]
     #[cfg(feature = "test-utils")]
     async fn test_delete_release_cloud_storage_cleanup() {
-        let (manager, _temp_dir, cloud_storage) = setup_test_manager().await;
+        let (manager, _temp_dir, cloud_storage, cache) = setup_test_manager().await;
 
         // Create album and release with chunk
         let album = create_test_album();
@@ -751,9 +960,53 @@ mod tests {
         assert!(cloud_storage.download_chunk(&location).await.is_ok());
 
         // Delete release
-        manager.delete_release(&release.id).await.unwrap();
+        manager
+            .delete_release(&release.id, &cache)
+            .await
+            .unwrap()
+            .wait()
+            .await;
 
         // Verify chunk is deleted from cloud storage
         assert!(cloud_storage.download_chunk(&location).await.is_err());
+        assert!(manager
+            .database
+            .get_pending_chunk_deletes()
+            .await
+            .unwrap()
+            .is_empty());
+    }
+
+    #[tokio::test]
+    #[cfg(feature = "test-utils")]
+    async fn test_resume_chunk_deletes_finishes_interrupted_deletion() {
+        let (manager, _temp_dir, cloud_storage, _cache) = setup_test_manager().await;
+
+        let album = create_test_album();
+        let release = create_test_release(&album.id);
+        let chunk = create_test_chunk(&release.id, 0, &manager.cloud_storage).await;
+        let location = chunk.storage_location.clone();
+
+        manager.database.insert_album(&album).await.unwrap();
+        manager.database.insert_release(&release).await.unwrap();
+        manager.database.insert_chunk(&chunk).await.unwrap();
+
+        // Deleting the rows without starting a job is what a quit mid-deletion leaves
+        manager.database.delete_release(&release.id).await.unwrap();
+        assert_eq!(
+            manager.database.get_pending_chunk_deletes().await.unwrap(),
+            vec![location.clone()]
+        );
+
+        let progress = manager.resume_chunk_deletes().await.unwrap().wait().await;
+
+        assert_eq!(progress.deleted, 1);
+        assert!(cloud_storage.download_chunk(&location).await.is_err());
+        assert!(manager
+            .database
+            .get_pending_chunk_deletes()
+            .await
+            .unwrap()
+            .is_empty());
     }
 }
@@ -1,6 +1,8 @@
+pub mod album_detail;
 pub mod context;
 pub mod export;
 pub mod manager;
 
+pub use album_detail::AlbumDetail;
 pub use context::*;
 pub use manager::*;
@@ -20,8 +20,10 @@ mod db;
 mod discogs;
 mod encryption;
 mod import;
+mod lan_peers;
 mod library;
 mod media_controls;
+mod memory;
 mod musicbrainz;
 mod network;
 mod playback;
@@ -47,15 +49,68 @@ async fn create_cache_manager() -> cache::CacheManager {
     cache_manager
 }
 
-/// Initialize cloud storage from config
+/// Initialize the seed cache: decrypted chunks served to torrent peers, with its own budget
+async fn create_seed_cache_manager(config: &config::Config) -> cache::CacheManager {
+    let cache_config = cache::CacheConfig {
+        cache_dir: config.get_library_path().join("seed-cache"),
+        max_size_bytes: config.seed_cache_max_bytes,
+        ..cache::CacheConfig::default()
+    };
+    let seed_cache = cache::CacheManager::with_config(cache_config)
+        .await
+        .expect("Failed to create seed cache manager");
+
+    info!("Seed cache manager created");
+    seed_cache
+}
+
+/// Initialize cloud storage from config (the S3 bucket is checked in the background)
 async fn create_cloud_storage_manager(
     config: &config::Config,
 ) -> cloud_storage::CloudStorageManager {
     info!("Initializing cloud storage...");
 
-    cloud_storage::CloudStorageManager::new(config.s3_config.clone())
+    match &config.storage_path {
+        Some(path) => cloud_storage::CloudStorageManager::new_local(path.clone())
+            .await
+            .expect("Failed to initialize local chunk storage. Please check BAE_STORAGE_PATH."),
+        None => cloud_storage::CloudStorageManager::new_with_background_bucket_check(
+            config.s3_config.clone(),
+        )
         .await
-        .expect("Failed to initialize cloud storage. Please check your S3 configuration.")
+        .expect("Failed to initialize cloud storage. Please check your S3 configuration."),
+    }
+}
+
+/// Serve cached chunks to LAN peers and look for peers, if chunk sharing is configured
+fn start_lan_peers(
+    config: &config::Config,
+    cache_manager: cache::CacheManager,
+    encryption_service: encryption::EncryptionService,
+    runtime_handle: &tokio::runtime::Handle,
+) -> Option<lan_peers::LanPeers> {
+    let lan_config = config.lan_peers.clone()?;
+    let lan_peers = lan_peers::LanPeers::new(&lan_config, encryption_service);
+
+    if lan_config.discovery {
+        runtime_handle.spawn(lan_peers::discover_peers(
+            lan_peers.clone(),
+            lan_peer_group(config),
+            lan_config.port,
+        ));
+    }
+    runtime_handle.spawn(lan_peers::serve_chunks(lan_config, cache_manager));
+
+    Some(lan_peers)
+}
+
+/// Nodes share chunks with peers that use the same bucket. Mount points of local
+/// storage differ between machines, so those nodes group by library instead.
+fn lan_peer_group(config: &config::Config) -> String {
+    match &config.storage_path {
+        Some(_) => config.library_id.clone(),
+        None => config.s3_config.bucket_name.clone(),
+    }
 }
 
 /// Initialize database
@@ -114,31 +169,65 @@ fn main() {
     let runtime = tokio::runtime::Runtime::new().expect("Failed to create tokio runtime");
     let runtime_handle = runtime.handle().clone();
 
-    info!("Building dependencies...");
+    let startup = std::time::Instant::now();
 
-    let cache_manager = runtime_handle.block_on(create_cache_manager());
-    let cloud_storage = runtime_handle.block_on(create_cloud_storage_manager(&config));
-    let database = runtime_handle.block_on(create_database(&config));
-    let library_manager = create_library_manager(database.clone(), cloud_storage.clone());
+    info!("Building dependencies...");
 
+    // Independent services start concurrently. Cache indexing, the bucket check,
+    // torrent sessions and the Subsonic server finish in the background, so the
+    // window only waits for these and the database schema.
+    let (cache_manager, seed_cache, cloud_storage, database) = runtime_handle.block_on(async {
+        tokio::join!(
+            create_cache_manager(),
+            create_seed_cache_manager(&config),
+            create_cloud_storage_manager(&config),
+            create_database(&config),
+        )
+    });
     let encryption_service = encryption::EncryptionService::new(&config).expect(
         "Failed to initialize encryption service. Check your encryption key configuration.",
     );
 
+    let cloud_storage = match start_lan_peers(
+        &config,
+        cache_manager.clone(),
+        encryption_service.clone(),
+        &runtime_handle,
+    ) {
+        Some(lan_peers) => cloud_storage.with_lan_peers(lan_peers),
+        None => cloud_storage,
+    };
+    let library_manager = create_library_manager(database.clone(), cloud_storage.clone());
+
+    // Finish cloud deletions a previous run quit before or failed to complete
+    let library_for_deletes = library_manager.clone();
+    runtime_handle.spawn(async move {
+        if let Err(e) = library_for_deletes.get().resume_chunk_deletes().await {
+            error!("Failed to resume chunk deletion: {}", e);
+        }
+    });
+
     let import_config = import::ImportConfig {
         max_encrypt_workers: config.max_import_encrypt_workers,
         max_upload_workers: config.max_import_upload_workers,
         max_db_write_workers: config.max_import_db_write_workers,
-        chunk_size_bytes: config.chunk_size_bytes,
+        min_chunk_size_bytes: config.min_chunk_size_bytes,
+        max_chunk_size_bytes: config.max_chunk_size_bytes,
+        chunk_layout: config.chunk_layout,
     };
 
+    // One memory budget shared by import, playback and export buffers
+    let memory = memory::MemoryGovernor::new(config.memory_budget_bytes);
+
     let torrent_options =
         torrent_options_from_config(&config).expect("Invalid torrent bind interface configuration");
 
     let torrent_manager = torrent::start_torrent_manager(
-        cache_manager.clone(),
+        seed_cache,
+        torrent::PinManager::new(config.seed_pin_max_bytes),
+        cloud_storage.clone(),
+        encryption_service.clone(),
         database.clone(),
-        config.chunk_size_bytes,
         torrent_options,
     );
 
@@ -151,6 +240,7 @@ fn main() {
         cloud_storage.clone(),
         cache_manager.clone(),
         torrent_manager.clone(),
+        memory.clone(),
     );
 
     // Create playback service
@@ -159,7 +249,7 @@ fn main() {
         cloud_storage.clone(),
         cache_manager.clone(),
         encryption_service.clone(),
-        config.chunk_size_bytes,
+        memory.clone(),
         runtime_handle.clone(),
     );
 
@@ -194,6 +284,7 @@ fn main() {
         cache: cache_manager.clone(),
         encryption_service: encryption_service.clone(),
         cloud_storage: cloud_storage.clone(),
+        memory,
     };
 
     // Start Subsonic API server as async task on shared runtime
@@ -203,14 +294,16 @@ fn main() {
             library_manager,
             encryption_service,
             cloud_storage,
-            config.chunk_size_bytes,
         )
         .await
     });
 
     // Start the desktop app (this will run in the main thread)
     // The runtime stays alive for the app's lifetime (Dioxus launch() blocks main thread)
-    info!("Starting UI");
+    info!(
+        "Starting UI ({} ms after launch)",
+        startup.elapsed().as_millis()
+    );
 
     ui::launch_app(ui_context);
 
@@ -223,7 +316,6 @@ async fn start_subsonic_server(
     library_manager: SharedLibraryManager,
     encryption_service: encryption::EncryptionService,
     cloud_storage: cloud_storage::CloudStorageManager,
-    chunk_size_bytes: usize,
 ) {
     info!("Starting Subsonic API server...");
 
@@ -232,7 +324,6 @@ async fn start_subsonic_server(
         cache_manager,
         encryption_service,
         cloud_storage,
-        chunk_size_bytes,
     );
 
     let listener = match tokio::net::TcpListener::bind("127.0.0.1:4533").await {
@@ -261,6 +352,10 @@ fn torrent_options_from_config(
 
     let options = torrent::client::TorrentClientOptions {
         bind_interface: config.torrent_bind_interface.clone(),
+        active_limits: Some(torrent::client::ActiveLimits {
+            active_seeds: config.torrent_active_seeds,
+            active_limit: config.torrent_active_limit,
+        }),
     };
 
     if let Some(interface) = &options.bind_interface {
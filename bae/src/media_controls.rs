@@ -190,10 +190,6 @@ pub fn setup_media_controls(
                             }
                         }
                     }
-                    PlaybackProgress::PositionUpdate { position, .. } => {
-                        // Update playback position continuously
-                        update_playback_position(&controls_shared, &current_state, position);
-                    }
                     PlaybackProgress::Seeked { position, .. } => {
                         // Update position after a seek
                         update_playback_position(&controls_shared, &current_state, position);
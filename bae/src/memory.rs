@@ -0,0 +1,189 @@
+//! Process-wide memory budget
+//!
+//! Subsystems that hold chunk or track data in memory lease bytes from one
+//! governor before allocating. Pipelines and buffers wait for a lease, which
+//! gives backpressure. Caches only get memory that is free right now, and must
+//! give it back when someone waits. Under pressure, caches shrink first and
+//! pipelines slow down second.
+
+use std::sync::{Arc, Mutex, Weak};
+use tokio::sync::{Notify, OwnedSemaphorePermit, Semaphore};
+use tracing::debug;
+
+/// Leases are counted in KiB so a u32 permit count covers any realistic budget
+const UNIT_BYTES: u64 = 1024;
+
+/// Hands out leases from a fixed memory budget
+#[derive(Clone)]
+pub struct MemoryGovernor {
+    permits: Arc<Semaphore>,
+    budget_units: u32,
+    /// Reclaim signals of live cache leases
+    caches: Arc<Mutex<Vec<Weak<Notify>>>>,
+}
+
+/// How a lease is obtained
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum LeaseKind {
+    /// Wait until memory is free, and keep it until dropped
+    Buffer,
+    /// Take memory only if it is free now, and give it back when asked
+    Cache,
+}
+
+/// Memory held against the budget until dropped
+pub struct MemoryLease {
+    permit: OwnedSemaphorePermit,
+    /// Set for cache leases, which the governor can ask back
+    reclaim: Option<Arc<Notify>>,
+}
+
+impl MemoryGovernor {
+    pub fn new(budget_bytes: u64) -> Self {
+        let budget_units = budget_bytes.div_ceil(UNIT_BYTES).clamp(1, u32::MAX as u64) as u32;
+        MemoryGovernor {
+            permits: Arc::new(Semaphore::new(budget_units as usize)),
+            budget_units,
+            caches: Arc::new(Mutex::new(Vec::new())),
+        }
+    }
+
+    /// Lease memory for a pipeline or buffer, waiting until it is free
+    ///
+    /// Cache leases are reclaimed first if the budget is short. Waiters are
+    /// served in order. A lease larger than the whole budget waits until
+    /// nothing else is leased.
+    pub async fn acquire(&self, bytes: u64) -> MemoryLease {
+        let units = self.units(bytes);
+        if self.permits.available_permits() < units as usize {
+            self.reclaim_caches();
+        }
+
+        let permit = self
+            .permits
+            .clone()
+            .acquire_many_owned(units)
+            .await
+            .expect("Memory governor semaphore is never closed");
+        MemoryLease {
+            permit,
+            reclaim: None,
+        }
+    }
+
+    /// Lease memory of the given kind
+    ///
+    /// Returns None if a cache lease is not available right now.
+    pub async fn lease(&self, kind: LeaseKind, bytes: u64) -> Option<MemoryLease> {
+        match kind {
+            LeaseKind::Buffer => Some(self.acquire(bytes).await),
+            LeaseKind::Cache => self.try_acquire_cache(bytes),
+        }
+    }
+
+    /// Lease memory for a cache if it is free right now
+    ///
+    /// The holder must drop the lease, and the data it covers, once
+    /// [`MemoryLease::reclaimed`] resolves.
+    pub fn try_acquire_cache(&self, bytes: u64) -> Option<MemoryLease> {
+        let permit = self
+            .permits
+            .clone()
+            .try_acquire_many_owned(self.units(bytes))
+            .ok()?;
+        let reclaim = Arc::new(Notify::new());
+        let mut caches = self.caches.lock().unwrap();
+        caches.retain(|cache| cache.strong_count() > 0);
+        caches.push(Arc::downgrade(&reclaim));
+        Some(MemoryLease {
+            permit,
+            reclaim: Some(reclaim),
+        })
+    }
+
+    fn reclaim_caches(&self) {
+        let mut caches = self.caches.lock().unwrap();
+        let live: Vec<Arc<Notify>> = caches
+            .drain(..)
+            .filter_map(|cache| cache.upgrade())
+            .collect();
+        if !live.is_empty() {
+            debug!(
+                "Memory budget exhausted, reclaiming {} cache leases",
+                live.len()
+            );
+        }
+        for reclaim in live {
+            reclaim.notify_one();
+        }
+    }
+
+    fn units(&self, bytes: u64) -> u32 {
+        bytes
+            .div_ceil(UNIT_BYTES)
+            .clamp(1, self.budget_units as u64) as u32
+    }
+}
+
+impl MemoryLease {
+    /// Resolves once the governor wants this cache lease back
+    ///
+    /// Never resolves for pipeline and buffer leases.
+    pub async fn reclaimed(&self) {
+        match &self.reclaim {
+            Some(reclaim) => reclaim.notified().await,
+            None => std::future::pending().await,
+        }
+    }
+
+    /// Give back whatever the lease holds beyond `bytes`
+    pub fn shrink_to(&mut self, bytes: u64) {
+        let units = bytes.div_ceil(UNIT_BYTES).max(1) as usize;
+        let held = self.permit.num_permits();
+        if units < held {
+            drop(self.permit.split(held - units));
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::Duration;
+
+    #[tokio::test]
+    async fn test_caches_are_reclaimed_before_pipelines_wait() {
+        let governor = MemoryGovernor::new(4 * 1024 * 1024);
+
+        let pipeline = governor.acquire(2 * 1024 * 1024).await;
+        let cache = governor.try_acquire_cache(2 * 1024 * 1024).unwrap();
+        assert!(governor.try_acquire_cache(1024).is_none());
+
+        // A pipeline waiting for memory asks the cache to give its lease back
+        let waiter = tokio::spawn({
+            let governor = governor.clone();
+            async move { governor.acquire(1024 * 1024).await }
+        });
+        tokio::time::timeout(Duration::from_secs(1), cache.reclaimed())
+            .await
+            .unwrap();
+        drop(cache);
+        let _lease = tokio::time::timeout(Duration::from_secs(1), waiter)
+            .await
+            .unwrap()
+            .unwrap();
+
+        // With no cache left to reclaim, the next pipeline waits for a release
+        let blocked = tokio::spawn({
+            let governor = governor.clone();
+            async move { governor.acquire(2 * 1024 * 1024).await }
+        });
+        tokio::time::sleep(Duration::from_millis(50)).await;
+        assert!(!blocked.is_finished());
+        drop(pipeline);
+        tokio::time::timeout(Duration::from_secs(1), blocked)
+            .await
+            .unwrap()
+            .unwrap();
+    }
+}
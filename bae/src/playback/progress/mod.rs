@@ -4,21 +4,20 @@ use crate::playback::service::PlaybackState;
 pub use handle::PlaybackProgressHandle;
 use std::time::Duration;
 
-/// Progress updates during playback
+/// Discrete playback events
+///
+/// The continuously changing position is not sent here; it is published as part of
+/// the latest-value state from `PlaybackHandle::subscribe_state`.
 #[derive(Debug, Clone)]
 pub enum PlaybackProgress {
     StateChanged {
         state: PlaybackState,
     },
-    PositionUpdate {
-        position: Duration,
-        track_id: String,
-    },
     TrackCompleted {
         track_id: String,
     },
     /// Seek completed successfully - position changed within the same track
-    /// UI should update position and clear is_seeking flag
+    /// UI should clear is_seeking flag
     Seeked {
         position: Duration,
         track_id: String,
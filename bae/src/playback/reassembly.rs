@@ -3,9 +3,13 @@ use crate::cloud_storage::CloudStorageManager;
 use crate::db::DbChunk;
 use crate::encryption::EncryptionService;
 use crate::library::LibraryManager;
+use crate::memory::{LeaseKind, MemoryGovernor, MemoryLease};
 use futures::stream::{self, StreamExt};
 use tracing::{debug, info, warn};
 
+/// Chunks downloaded and decrypted at once while reassembling a track
+const MAX_CONCURRENT_CHUNKS: usize = 10;
+
 /// Reassemble chunks for a track into a continuous audio buffer
 ///
 /// Unified streaming logic for all tracks using TrackChunkCoords:
@@ -16,14 +20,19 @@ use tracing::{debug, info, warn};
 ///
 /// Key insight: Both import types produce identical TrackChunkCoords records.
 /// The only difference is whether we need to prepend FLAC headers.
+///
+/// Memory for the track is leased before any chunk is downloaded, and the
+/// returned lease covers the audio data. A cache lease fails instead of waiting
+/// when the budget is short.
 pub async fn reassemble_track(
     track_id: &str,
     library_manager: &LibraryManager,
     cloud_storage: &CloudStorageManager,
     cache: &CacheManager,
     encryption_service: &EncryptionService,
-    chunk_size_bytes: usize,
-) -> Result<Vec<u8>, String> {
+    memory: &MemoryGovernor,
+    lease_kind: LeaseKind,
+) -> Result<(Vec<u8>, MemoryLease), String> {
     info!("Reassembling chunks for track: {}", track_id);
 
     // Step 1: Get track chunk coordinates (has all location info)
@@ -72,49 +81,47 @@ pub async fn reassemble_track(
     let mut sorted_chunks = chunks;
     sorted_chunks.sort_by_key(|c| c.chunk_index);
 
-    // Download and decrypt all chunks in parallel (max 10 concurrent)
-    let chunk_results: Vec<Result<(i32, Vec<u8>), String>> = stream::iter(sorted_chunks)
+    let mut lease = memory
+        .lease(
+            lease_kind,
+            reassembly_memory(&sorted_chunks, audio_format.needs_headers),
+        )
+        .await
+        .ok_or_else(|| format!("Not enough memory to load track {}", track_id))?;
+
+    // Download and decrypt chunks in parallel, appending each one's share of the
+    // track in order so only the chunks in flight are held besides the output
+    let chunk_count = sorted_chunks.len();
+    let track_bytes: i64 = sorted_chunks.iter().map(|c| c.encrypted_size).sum();
+    let mut chunk_data = stream::iter(sorted_chunks)
         .map(move |chunk| {
             let cloud_storage = cloud_storage.clone();
             let cache = cache.clone();
             let encryption_service = encryption_service.clone();
             async move {
-                let chunk_data =
-                    download_and_decrypt_chunk(&chunk, &cloud_storage, &cache, &encryption_service)
-                        .await?;
-                Ok::<_, String>((chunk.chunk_index, chunk_data))
+                download_and_decrypt_chunk(&chunk, &cloud_storage, &cache, &encryption_service)
+                    .await
             }
         })
-        .buffer_unordered(10) // Download up to 10 chunks concurrently
-        .collect()
-        .await;
-
-    // Check for errors and collect indexed chunks
-    let mut indexed_chunks: Vec<(i32, Vec<u8>)> = Vec::new();
-    for result in chunk_results {
-        indexed_chunks.push(result?);
-    }
-
-    // Sort by chunk index to ensure correct order (parallel downloads may complete out of order)
-    indexed_chunks.sort_by_key(|(idx, _)| *idx);
-
-    // Extract only the chunk data (without the index)
-    let chunk_data: Vec<Vec<u8>> = indexed_chunks.into_iter().map(|(_, data)| data).collect();
+        .buffered(MAX_CONCURRENT_CHUNKS)
+        .enumerate();
 
     // Use byte offsets from coordinates to extract exactly the track data
     debug!(
-        "Extracting track data: {} chunks, start_offset={}, end_offset={}, chunk_size={}",
-        chunk_data.len(),
-        coords.start_byte_offset,
-        coords.end_byte_offset,
-        chunk_size_bytes
-    );
-    let mut audio_data = extract_file_from_chunks(
-        &chunk_data,
-        coords.start_byte_offset,
-        coords.end_byte_offset,
-        chunk_size_bytes,
+        "Extracting track data: {} chunks, start_offset={}, end_offset={}",
+        chunk_count, coords.start_byte_offset, coords.end_byte_offset
     );
+    let mut audio_data = Vec::with_capacity(track_bytes as usize);
+    while let Some((position, data)) = chunk_data.next().await {
+        let data = data?;
+        audio_data.extend_from_slice(file_bytes_in_chunk(
+            &data,
+            position,
+            chunk_count,
+            coords.start_byte_offset,
+            coords.end_byte_offset,
+        ));
+    }
 
     debug!(
         "Extracted {} bytes of audio data ({}MB)",
@@ -146,12 +153,31 @@ pub async fn reassemble_track(
         }
     }
 
+    audio_data.shrink_to_fit();
+    lease.shrink_to(audio_data.len() as u64);
+
     info!(
         "Successfully reassembled {} bytes of audio data for track {}",
         audio_data.len(),
         track_id
     );
-    Ok(audio_data)
+    Ok((audio_data, lease))
+}
+
+/// Upper bound on memory used while reassembling a track from these chunks
+///
+/// Covers the output, the chunks in flight (encrypted and decrypted), and for
+/// CUE/FLAC tracks the copies made while re-encoding.
+fn reassembly_memory(chunks: &[DbChunk], needs_headers: bool) -> u64 {
+    let track_bytes: u64 = chunks.iter().map(|c| c.encrypted_size as u64).sum();
+    let largest_chunk = chunks
+        .iter()
+        .map(|c| c.encrypted_size as u64)
+        .max()
+        .unwrap_or(0);
+    let in_flight = 2 * largest_chunk * chunks.len().min(MAX_CONCURRENT_CHUNKS) as u64;
+    let reencode = if needs_headers { 2 * track_bytes } else { 0 };
+    track_bytes + in_flight + reencode
 }
 
 /// Download and decrypt a single chunk with caching
@@ -204,53 +230,32 @@ async fn download_and_decrypt_chunk(
     Ok(decrypted_data)
 }
 
-/// Extract file data from chunks using byte offsets
-///
-/// Given a list of chunks and the file's byte offsets within those chunks,
-/// this function extracts exactly the bytes that belong to the file.
+/// The part of a decrypted chunk that belongs to a file
 ///
 /// # Arguments
-/// * `chunks` - Decrypted chunk data in order (chunk 0, chunk 1, chunk 2, ...)
+/// * `chunk` - Decrypted chunk data
+/// * `position` - Position of the chunk among the file's chunks
+/// * `chunk_count` - Number of chunks the file spans
 /// * `start_byte_offset` - Byte offset within the first chunk where the file starts
 /// * `end_byte_offset` - Byte offset within the last chunk where the file ends (inclusive)
-/// * `chunk_size` - Size of each chunk in bytes
-///
-/// # Returns
-/// The extracted file data
-fn extract_file_from_chunks(
-    chunks: &[Vec<u8>],
+fn file_bytes_in_chunk(
+    chunk: &[u8],
+    position: usize,
+    chunk_count: usize,
     start_byte_offset: i64,
     end_byte_offset: i64,
-    _chunk_size: usize,
-) -> Vec<u8> {
-    if chunks.is_empty() {
-        return Vec::new();
-    }
-
-    let mut file_data = Vec::new();
-
-    if chunks.len() == 1 {
-        // File is entirely within a single chunk
-        let start = start_byte_offset as usize;
-        let end = (end_byte_offset + 1) as usize; // end_byte_offset is inclusive
-        file_data.extend_from_slice(&chunks[0][start..end]);
+) -> &[u8] {
+    let start = if position == 0 {
+        start_byte_offset as usize
     } else {
-        // File spans multiple chunks
-        // First chunk: from start_byte_offset to end of chunk
-        let first_chunk_start = start_byte_offset as usize;
-        file_data.extend_from_slice(&chunks[0][first_chunk_start..]);
-
-        // Middle chunks: use entirely
-        for chunk in &chunks[1..chunks.len() - 1] {
-            file_data.extend_from_slice(chunk);
-        }
-
-        // Last chunk: from start to end_byte_offset
-        let last_chunk_end = (end_byte_offset + 1) as usize; // end_byte_offset is inclusive
-        file_data.extend_from_slice(&chunks[chunks.len() - 1][0..last_chunk_end]);
-    }
-
-    file_data
+        0
+    };
+    let end = if position == chunk_count - 1 {
+        (end_byte_offset + 1) as usize // end_byte_offset is inclusive
+    } else {
+        chunk.len()
+    };
+    &chunk[start..end]
 }
 
 /// Decode and re-encode a track from FLAC data using Symphonia + flacenc
@@ -502,9 +507,7 @@ mod tests {
                 }
             }
 
-            let (ciphertext, nonce) = encryption_service.encrypt(&chunk_data).unwrap();
-            let encrypted_chunk =
-                crate::encryption::EncryptedChunk::new(ciphertext, nonce, "master".to_string());
+            let encrypted_chunk = encryption_service.encrypt_chunk(&chunk_data).unwrap();
             cloud_storage
                 .upload_chunk_data(&format!("test-chunk-{}", i), &encrypted_chunk.to_bytes())
                 .await
@@ -521,7 +524,7 @@ mod tests {
             .await
             .unwrap();
 
-        let file = DbFile::new("test-release", "test.flac", file_size as i64, "flac");
+        let file = DbFile::new("test-release", "test.flac", file_size as i64, "flac", 0);
         library_manager.add_file(&file).await.unwrap();
 
         // Add chunks
@@ -561,13 +564,14 @@ mod tests {
             .unwrap();
 
         // THE TEST: Reassemble the track
-        let reassembled = reassemble_track(
+        let (reassembled, _lease) = reassemble_track(
             "test-track",
             &library_manager,
             &cloud_storage,
             &cache,
             &encryption_service,
-            chunk_size,
+            &MemoryGovernor::new(1024 * 1024 * 1024),
+            LeaseKind::Buffer,
         )
         .await
         .unwrap();
@@ -3,6 +3,7 @@ use crate::cloud_storage::CloudStorageManager;
 use crate::db::DbTrack;
 use crate::encryption::EncryptionService;
 use crate::library::LibraryManager;
+use crate::memory::{LeaseKind, MemoryGovernor, MemoryLease};
 use crate::playback::cpal_output::AudioOutput;
 use crate::playback::progress::{PlaybackProgress, PlaybackProgressHandle};
 use crate::playback::symphonia_decoder::TrackDecoder;
@@ -10,6 +11,7 @@ use cpal::traits::StreamTrait;
 use std::collections::VecDeque;
 use std::sync::{mpsc, Arc};
 use tokio::sync::mpsc as tokio_mpsc;
+use tokio::sync::watch;
 use tracing::{error, info, trace};
 
 /// Playback commands sent to the service
@@ -57,6 +59,7 @@ pub enum PlaybackState {
 pub struct PlaybackHandle {
     command_tx: tokio_mpsc::UnboundedSender<PlaybackCommand>,
     progress_handle: PlaybackProgressHandle,
+    state_rx: watch::Receiver<PlaybackState>,
 }
 
 impl PlaybackHandle {
@@ -96,15 +99,19 @@ impl PlaybackHandle {
         let _ = self.command_tx.send(PlaybackCommand::SetVolume(volume));
     }
 
-    pub async fn get_state(&self) -> PlaybackState {
-        // Deprecated - use subscribe_progress instead
-        PlaybackState::Stopped
-    }
-
+    /// Subscribe to discrete playback events (state transitions, seeks, queue changes)
     pub fn subscribe_progress(&self) -> tokio_mpsc::UnboundedReceiver<PlaybackProgress> {
         self.progress_handle.subscribe_all()
     }
 
+    /// Subscribe to the latest playback state, including the current position
+    ///
+    /// Position changes only overwrite the shared value, so readers should sample
+    /// it at the rate they display it rather than react to every change.
+    pub fn subscribe_state(&self) -> watch::Receiver<PlaybackState> {
+        self.state_rx.clone()
+    }
+
     pub fn add_to_queue(&self, track_ids: Vec<String>) {
         let _ = self.command_tx.send(PlaybackCommand::AddToQueue(track_ids));
     }
@@ -134,28 +141,52 @@ impl PlaybackHandle {
     }
 }
 
+/// Track audio held in memory, with the lease that accounts for it
+///
+/// Clones share the data, so the lease is released once the service and every
+/// decoder reading the track have let go of it.
+#[derive(Clone)]
+struct LoadedAudio(Arc<(Vec<u8>, MemoryLease)>);
+
+impl LoadedAudio {
+    fn new(data: Vec<u8>, lease: MemoryLease) -> Self {
+        LoadedAudio(Arc::new((data, lease)))
+    }
+
+    fn lease(&self) -> &MemoryLease {
+        &self.0 .1
+    }
+}
+
+impl AsRef<[u8]> for LoadedAudio {
+    fn as_ref(&self) -> &[u8] {
+        &self.0 .0
+    }
+}
+
 /// Playback service that manages audio playback
 pub struct PlaybackService {
     library_manager: LibraryManager,
     cloud_storage: CloudStorageManager,
     cache: CacheManager,
     encryption_service: EncryptionService,
-    chunk_size_bytes: usize,
+    memory: MemoryGovernor,
     command_rx: tokio_mpsc::UnboundedReceiver<PlaybackCommand>,
     progress_tx: tokio_mpsc::UnboundedSender<PlaybackProgress>,
+    state_tx: watch::Sender<PlaybackState>,
     queue: VecDeque<String>,           // track IDs
     previous_track_id: Option<String>, // Track ID of the previous track
     current_track: Option<DbTrack>,
-    current_audio_data: Option<Vec<u8>>, // Cached audio data for seeking
+    current_audio_data: Option<LoadedAudio>, // Cached audio data for seeking
     current_position: Option<std::time::Duration>, // Current playback position
     current_duration: Option<std::time::Duration>, // Current track duration
-    is_paused: bool,                     // Whether playback is currently paused
+    is_paused: bool,                         // Whether playback is currently paused
     current_position_shared: Arc<std::sync::Mutex<Option<std::time::Duration>>>, // Shared position for bridge tasks
     audio_output: AudioOutput,
     stream: Option<cpal::Stream>,
     next_decoder: Option<TrackDecoder>, // Preloaded for gapless playback
-    next_audio_data: Option<Vec<u8>>,   // Preloaded audio data for gapless playback
-    next_track_id: Option<String>,      // Track ID of preloaded track
+    next_audio_data: Option<LoadedAudio>, // Preloaded audio data for gapless playback, memory permitting
+    next_track_id: Option<String>,        // Track ID of preloaded track
     next_duration: Option<std::time::Duration>, // Duration of preloaded track
 }
 
@@ -165,17 +196,19 @@ impl PlaybackService {
         cloud_storage: CloudStorageManager,
         cache: CacheManager,
         encryption_service: EncryptionService,
-        chunk_size_bytes: usize,
+        memory: MemoryGovernor,
         runtime_handle: tokio::runtime::Handle,
     ) -> PlaybackHandle {
         let (command_tx, command_rx) = tokio_mpsc::unbounded_channel();
         let (progress_tx, progress_rx) = tokio_mpsc::unbounded_channel();
+        let (state_tx, state_rx) = watch::channel(PlaybackState::Stopped);
 
         let progress_handle = PlaybackProgressHandle::new(progress_rx, runtime_handle.clone());
 
         let handle = PlaybackHandle {
             command_tx: command_tx.clone(),
             progress_handle: progress_handle.clone(),
+            state_rx,
         };
 
         // Spawn task to listen for track completion and auto-advance
@@ -214,9 +247,10 @@ impl PlaybackService {
                     cloud_storage,
                     cache,
                     encryption_service,
-                    chunk_size_bytes,
+                    memory,
                     command_rx,
                     progress_tx,
+                    state_tx,
                     queue: VecDeque::new(),
                     previous_track_id: None,
                     current_track: None,
@@ -243,7 +277,7 @@ impl PlaybackService {
     async fn run(&mut self) {
         info!("PlaybackService started");
 
-        while let Some(command) = self.command_rx.recv().await {
+        while let Some(command) = self.next_command().await {
             match command {
                 PlaybackCommand::Play(track_id) => {
                     // Stop current playback before switching tracks (without state change)
@@ -252,11 +286,7 @@ impl PlaybackService {
                     }
                     self.audio_output
                         .send_command(crate::playback::cpal_output::AudioCommand::Stop);
-                    // Clear preloaded data
-                    self.next_decoder = None;
-                    self.next_audio_data = None;
-                    self.next_track_id = None;
-                    self.next_duration = None;
+                    self.clear_preload();
 
                     // Save current track as previous before switching
                     if let Some(current_track) = &self.current_track {
@@ -482,10 +512,7 @@ impl PlaybackService {
                                 }
 
                                 // Clear preloaded data before switching tracks
-                                self.next_decoder = None;
-                                self.next_audio_data = None;
-                                self.next_track_id = None;
-                                self.next_duration = None;
+                                self.clear_preload();
 
                                 self.play_track(&previous_track_id).await;
                             } else {
@@ -570,14 +597,37 @@ impl PlaybackService {
         info!("PlaybackService stopped");
     }
 
+    /// Wait for the next command, dropping the preloaded track if the memory
+    /// governor asks for it back in the meantime
+    async fn next_command(&mut self) -> Option<PlaybackCommand> {
+        loop {
+            let Some(preload) = &self.next_audio_data else {
+                return self.command_rx.recv().await;
+            };
+            tokio::select! {
+                command = self.command_rx.recv() => return command,
+                _ = preload.lease().reclaimed() => {}
+            }
+
+            info!("Dropping preloaded track to free memory");
+
+            self.clear_preload();
+        }
+    }
+
+    fn clear_preload(&mut self) {
+        self.next_decoder = None;
+        self.next_audio_data = None;
+        self.next_track_id = None;
+        self.next_duration = None;
+    }
+
     async fn play_track(&mut self, track_id: &str) {
         info!("Playing track: {}", track_id);
 
         // Update state to loading
-        let _ = self.progress_tx.send(PlaybackProgress::StateChanged {
-            state: PlaybackState::Loading {
-                track_id: track_id.to_string(),
-            },
+        self.set_state(PlaybackState::Loading {
+            track_id: track_id.to_string(),
         });
 
         // Fetch track metadata
@@ -595,18 +645,27 @@ impl PlaybackService {
             }
         };
 
+        // Let go of the audio already loaded before leasing memory for this track,
+        // since nothing else would release it while we wait
+        if let Some(stream) = self.stream.take() {
+            drop(stream);
+        }
+        self.current_audio_data = None;
+        self.clear_preload();
+
         // Reassemble track chunks
-        let audio_data = match super::reassembly::reassemble_track(
+        let (audio_data, lease) = match super::reassembly::reassemble_track(
             track_id,
             &self.library_manager,
             &self.cloud_storage,
             &self.cache,
             &self.encryption_service,
-            self.chunk_size_bytes,
+            &self.memory,
+            LeaseKind::Buffer,
         )
         .await
         {
-            Ok(data) => data,
+            Ok(loaded) => loaded,
             Err(e) => {
                 error!("Failed to reassemble track: {}", e);
                 self.stop().await;
@@ -634,6 +693,8 @@ impl PlaybackService {
 
         info!("Valid FLAC header detected");
 
+        let audio_data = LoadedAudio::new(audio_data, lease);
+
         // Create decoder
         let decoder = match TrackDecoder::new(audio_data.clone()) {
             Ok(decoder) => decoder,
@@ -654,9 +715,6 @@ impl PlaybackService {
 
         info!("Track duration: {:?}", track_duration);
 
-        // Cache audio data for seeking
-        self.current_audio_data = Some(audio_data.clone());
-
         self.play_track_with_decoder(track_id, track, decoder, audio_data, track_duration)
             .await;
     }
@@ -666,7 +724,7 @@ impl PlaybackService {
         track_id: &str,
         track: DbTrack,
         decoder: TrackDecoder,
-        audio_data: Vec<u8>,
+        audio_data: LoadedAudio,
         track_duration: std::time::Duration,
     ) {
         info!("Starting playback with decoder for track: {}", track_id);
@@ -755,16 +813,15 @@ impl PlaybackService {
         *self.current_position_shared.lock().unwrap() = Some(std::time::Duration::ZERO);
 
         // Update state
-        let _ = self.progress_tx.send(PlaybackProgress::StateChanged {
-            state: PlaybackState::Playing {
-                track: track.clone(),
-                position: std::time::Duration::ZERO,
-                duration: Some(track_duration),
-            },
+        self.set_state(PlaybackState::Playing {
+            track: track.clone(),
+            position: std::time::Duration::ZERO,
+            duration: Some(track_duration),
         });
 
         // Spawn task to handle position updates and completion
         let progress_tx = self.progress_tx.clone();
+        let state_tx = self.state_tx.clone();
         let track_id = track_id.to_string();
         let track_duration_for_completion = track_duration;
         let current_position_for_listener = self.current_position_shared.clone();
@@ -781,19 +838,12 @@ impl PlaybackService {
                     Some(position) = position_rx_async.recv() => {
                         // Update shared position
                         *current_position_for_listener.lock().unwrap() = Some(position);
-                        // Send PositionUpdate event
-                        let _ = progress_tx.send(PlaybackProgress::PositionUpdate {
-                            position,
-                            track_id: track_id.clone(),
-                        });
+                        update_position(&state_tx, &track_id, position);
                     }
                     Some(()) = completion_rx_async.recv() => {
                         info!("Track completed: {}", track_id);
-                        // Send final position update matching duration to ensure progress bar reaches 100%
-                        let _ = progress_tx.send(PlaybackProgress::PositionUpdate {
-                            position: track_duration_for_completion,
-                            track_id: track_id.clone(),
-                        });
+                        // Final position matches duration to ensure progress bar reaches 100%
+                        update_position(&state_tx, &track_id, track_duration_for_completion);
                         let _ = progress_tx.send(PlaybackProgress::TrackCompleted {
                             track_id: track_id.clone(),
                         });
@@ -818,23 +868,26 @@ impl PlaybackService {
     }
 
     async fn preload_next_track(&mut self, track_id: &str) {
-        // Reassemble track chunks
-        let audio_data = match super::reassembly::reassemble_track(
+        // Reassemble track chunks. The preload only uses memory that is free, and
+        // is the first thing given back when the budget runs short.
+        let (audio_data, lease) = match super::reassembly::reassemble_track(
             track_id,
             &self.library_manager,
             &self.cloud_storage,
             &self.cache,
             &self.encryption_service,
-            self.chunk_size_bytes,
+            &self.memory,
+            LeaseKind::Cache,
         )
         .await
         {
-            Ok(data) => data,
+            Ok(loaded) => loaded,
             Err(e) => {
                 error!("Failed to preload track {}: {}", track_id, e);
                 return;
             }
         };
+        let audio_data = LoadedAudio::new(audio_data, lease);
 
         // Fetch track to get stored duration (correct for CUE/FLAC)
         // Duration is calculated once during import and stored in database - required for playback
@@ -866,9 +919,8 @@ impl PlaybackService {
         self.audio_output
             .send_command(crate::playback::cpal_output::AudioCommand::Pause);
 
-        // Send StateChanged event so UI can update button state
-        // Position/duration are maintained via PositionUpdate events, but we include
-        // current position here for cases where PositionUpdate hasn't arrived yet
+        // Publish the transition so the UI can update button state, carrying over
+        // the last known position
         if let Some(track) = &self.current_track {
             let position = self
                 .current_position_shared
@@ -877,12 +929,10 @@ impl PlaybackService {
                 .unwrap_or(std::time::Duration::ZERO);
             let duration = self.current_duration;
             self.is_paused = true;
-            let _ = self.progress_tx.send(PlaybackProgress::StateChanged {
-                state: PlaybackState::Paused {
-                    track: track.clone(),
-                    position,
-                    duration,
-                },
+            self.set_state(PlaybackState::Paused {
+                track: track.clone(),
+                position,
+                duration,
             });
         }
     }
@@ -891,9 +941,8 @@ impl PlaybackService {
         self.audio_output
             .send_command(crate::playback::cpal_output::AudioCommand::Resume);
 
-        // Send StateChanged event so UI can update button state
-        // Position/duration are maintained via PositionUpdate events, but we include
-        // current position here for cases where PositionUpdate hasn't arrived yet
+        // Publish the transition so the UI can update button state, carrying over
+        // the last known position
         if let Some(track) = &self.current_track {
             let position = self
                 .current_position_shared
@@ -902,12 +951,10 @@ impl PlaybackService {
                 .unwrap_or(std::time::Duration::ZERO);
             let duration = self.current_duration;
             self.is_paused = false;
-            let _ = self.progress_tx.send(PlaybackProgress::StateChanged {
-                state: PlaybackState::Playing {
-                    track: track.clone(),
-                    position,
-                    duration,
-                },
+            self.set_state(PlaybackState::Playing {
+                track: track.clone(),
+                position,
+                duration,
             });
         }
     }
@@ -920,16 +967,11 @@ impl PlaybackService {
         self.current_audio_data = None;
         self.current_position = None;
         self.current_duration = None;
-        self.next_decoder = None;
-        self.next_audio_data = None;
-        self.next_track_id = None;
-        self.next_duration = None;
+        self.clear_preload();
         self.audio_output
             .send_command(crate::playback::cpal_output::AudioCommand::Stop);
 
-        let _ = self.progress_tx.send(PlaybackProgress::StateChanged {
-            state: PlaybackState::Stopped,
-        });
+        self.set_state(PlaybackState::Stopped);
     }
 
     async fn seek(&mut self, position: std::time::Duration) {
@@ -1076,6 +1118,7 @@ impl PlaybackService {
         // Spawn task to handle position updates and completion BEFORE creating stream
         // This ensures the receiver is ready when completion signals arrive
         let progress_tx_for_task = self.progress_tx.clone();
+        let state_tx_for_task = self.state_tx.clone();
         let track_id_for_task = track_id.clone();
         let track_duration_for_completion = track_duration;
         let current_position_for_seek_listener = self.current_position_shared.clone();
@@ -1094,22 +1137,16 @@ impl PlaybackService {
                         trace!("Seek: Listener received position update: {:?}", pos);
                         // Update shared position
                         *current_position_for_seek_listener.lock().unwrap() = Some(pos);
-                        // Send PositionUpdate event
-                        let send_result = progress_tx_for_task.send(PlaybackProgress::PositionUpdate {
-                            position: pos,
-                            track_id: track_id_for_task.clone(),
-                        });
-                        if let Err(e) = send_result {
-                            error!("Seek: Listener failed to send position update: {:?}", e);
-                        }
+                        update_position(&state_tx_for_task, &track_id_for_task, pos);
                     }
                     Some(()) = completion_rx_async.recv() => {
                         info!("Seek: Track completed: {}", track_id_for_task);
-                        // Send final position update matching duration to ensure progress bar reaches 100%
-                        let _ = progress_tx_for_task.send(PlaybackProgress::PositionUpdate {
-                            position: track_duration_for_completion,
-                            track_id: track_id_for_task.clone(),
-                        });
+                        // Final position matches duration to ensure progress bar reaches 100%
+                        update_position(
+                            &state_tx_for_task,
+                            &track_id_for_task,
+                            track_duration_for_completion,
+                        );
                         let _ = progress_tx_for_task.send(PlaybackProgress::TrackCompleted {
                             track_id: track_id_for_task.clone(),
                         });
@@ -1161,6 +1198,7 @@ impl PlaybackService {
         // because for CUE/FLAC tracks, decoder.duration() returns the full album duration, not track duration
         *self.current_position_shared.lock().unwrap() = Some(position);
         // self.current_duration remains unchanged - it's already the correct track duration
+        update_position(&self.state_tx, &track_id, position);
         trace!("Seek: Updated shared position to: {:?}", position);
 
         // If we were paused, keep it paused; otherwise play
@@ -1186,6 +1224,14 @@ impl PlaybackService {
         }
     }
 
+    /// Publish a state transition as the latest state and as a StateChanged event
+    fn set_state(&self, state: PlaybackState) {
+        self.state_tx.send_replace(state.clone());
+        let _ = self
+            .progress_tx
+            .send(PlaybackProgress::StateChanged { state });
+    }
+
     /// Emit queue update to all subscribers
     fn emit_queue_update(&self) {
         let track_ids: Vec<String> = self.queue.iter().cloned().collect();
@@ -1194,3 +1240,24 @@ impl PlaybackService {
             .send(PlaybackProgress::QueueUpdated { tracks: track_ids });
     }
 }
+
+/// Overwrite the position in the shared state, ignoring updates from a track that is no
+/// longer current (e.g. a listener task that outlived a track switch)
+fn update_position(
+    state_tx: &watch::Sender<PlaybackState>,
+    track_id: &str,
+    new_position: std::time::Duration,
+) {
+    state_tx.send_if_modified(|state| match state {
+        PlaybackState::Playing {
+            track, position, ..
+        }
+        | PlaybackState::Paused {
+            track, position, ..
+        } if track.id == track_id && *position != new_position => {
+            *position = new_position;
+            true
+        }
+        _ => false,
+    });
+}
@@ -32,7 +32,7 @@ pub struct TrackDecoder {
 
 impl TrackDecoder {
     /// Create a new decoder from FLAC data
-    pub fn new(flac_data: Vec<u8>) -> Result<Self, DecoderError> {
+    pub fn new(flac_data: impl AsRef<[u8]> + Send + Sync + 'static) -> Result<Self, DecoderError> {
         let cursor = Cursor::new(flac_data);
         let media_source = MediaSourceStream::new(Box::new(cursor), Default::default());
 
@@ -19,7 +19,6 @@ pub struct SubsonicState {
     pub cache_manager: crate::cache::CacheManager,
     pub encryption_service: crate::encryption::EncryptionService,
     pub cloud_storage: crate::cloud_storage::CloudStorageManager,
-    pub chunk_size_bytes: usize,
 }
 
 /// Common query parameters for Subsonic API
@@ -143,14 +142,12 @@ pub fn create_router(
     cache_manager: crate::cache::CacheManager,
     encryption_service: crate::encryption::EncryptionService,
     cloud_storage: crate::cloud_storage::CloudStorageManager,
-    chunk_size_bytes: usize,
 ) -> Router {
     let state = SubsonicState {
         library_manager,
         cache_manager,
         encryption_service,
         cloud_storage,
-        chunk_size_bytes,
     };
     Router::new()
         .route("/rest/ping", get(ping))
@@ -357,16 +354,17 @@ async fn load_artists(
     library_manager: &SharedLibraryManager,
 ) -> Result<ArtistsResponse, LibraryError> {
     let albums = library_manager.get().get_albums().await?;
+    let album_ids: Vec<String> = albums.iter().map(|album| album.id.clone()).collect();
+    let mut artists_by_album = library_manager
+        .get()
+        .get_artists_for_albums(&album_ids)
+        .await?;
 
     // Group artists by first letter, counting album appearances
     let mut artist_map: HashMap<String, HashMap<String, u32>> = HashMap::new();
 
     for album in &albums {
-        // Get artists for this album
-        let artists = library_manager
-            .get()
-            .get_artists_for_album(&album.id)
-            .await?;
+        let artists = artists_by_album.remove(&album.id).unwrap_or_default();
 
         for artist in artists {
             let first_letter = artist
@@ -414,16 +412,19 @@ async fn load_albums(
     library_manager: &SharedLibraryManager,
 ) -> Result<AlbumListResponse, LibraryError> {
     let db_albums = library_manager.get().get_albums().await?;
+    let album_ids: Vec<String> = db_albums.iter().map(|album| album.id.clone()).collect();
+    let mut artists_by_album = library_manager
+        .get()
+        .get_artists_for_albums(&album_ids)
+        .await?;
+    let track_counts = library_manager
+        .get()
+        .get_track_counts_for_albums(&album_ids)
+        .await?;
 
     let mut albums = Vec::new();
     for db_album in db_albums {
-        let tracks = library_manager.get().get_tracks(&db_album.id).await?;
-
-        // Get artists for this album
-        let artists = library_manager
-            .get()
-            .get_artists_for_album(&db_album.id)
-            .await?;
+        let artists = artists_by_album.remove(&db_album.id).unwrap_or_default();
         let artist_name = if artists.is_empty() {
             "Unknown Artist".to_string()
         } else {
@@ -439,7 +440,7 @@ async fn load_albums(
             name: db_album.title,
             artist: artist_name.clone(),
             artist_id: format!("artist_{}", artist_name.replace(' ', "_")),
-            song_count: tracks.len() as u32,
+            song_count: track_counts.get(&db_album.id).copied().unwrap_or(0) as u32,
             duration: 0, // TODO: Calculate from tracks
             year: db_album.year,
             genre: None, // TODO: Add genre support
@@ -614,12 +615,10 @@ async fn stream_track_chunks(
     }
 
     // Extract byte ranges from chunks
-    let chunk_size = state.chunk_size_bytes;
     let mut audio_data = extract_bytes_from_chunks(
         &chunk_data_vec,
         coords.start_byte_offset,
         coords.end_byte_offset,
-        chunk_size,
     );
 
     // Prepend FLAC headers if needed (CUE/FLAC tracks)
@@ -689,7 +688,6 @@ fn extract_bytes_from_chunks(
     chunks: &[Vec<u8>],
     start_byte_offset: i64,
     end_byte_offset: i64,
-    _chunk_size: usize,
 ) -> Vec<u8> {
     if chunks.is_empty() {
         return Vec::new();
@@ -8,21 +8,21 @@
 use crate::torrent::ffi::{
     self, create_session_params_default, create_session_params_with_storage,
     create_session_with_params, get_session_ptr, load_torrent_file, parse_magnet_uri,
-    session_add_torrent, session_pop_alerts, session_remove_torrent, set_listen_interfaces,
-    set_paused, torrent_get_file_list, torrent_get_name, torrent_get_num_peers,
-    torrent_get_num_pieces, torrent_get_num_seeds, torrent_get_piece_length, torrent_get_progress,
-    torrent_get_storage_index, torrent_get_total_size, torrent_get_tracker_status,
-    torrent_has_metadata, torrent_pause, torrent_resume, torrent_set_file_priorities,
-    AddTorrentParams, AlertData, Session, TorrentFileInfo, TorrentHandle as FfiTorrentHandle,
+    session_add_torrent, session_get_torrent_statuses, session_pop_alerts, session_remove_torrent,
+    set_active_limits, set_listen_interfaces, set_paused, torrent_get_file_list,
+    torrent_get_info_hash, torrent_get_name, torrent_get_num_pieces, torrent_get_piece_length,
+    torrent_get_progress, torrent_get_storage_index, torrent_get_total_size, torrent_has_metadata,
+    torrent_pause, torrent_resume, torrent_set_file_priorities, AddTorrentParams, AlertData,
+    Session, TorrentFileInfo, TorrentHandle as FfiTorrentHandle, TorrentStatusData,
 };
-use crate::torrent::storage::{create_bae_storage_constructor, BaeStorage};
+use crate::torrent::storage::{create_bae_storage_constructor, BaeStorage, StorageEvent};
 use cxx::UniquePtr;
 use std::collections::HashMap;
 use std::path::{Path, PathBuf};
 use std::rc::Rc;
 use std::sync::Arc;
 use thiserror::Error;
-use tokio::sync::RwLock;
+use tokio::sync::{mpsc, RwLock};
 
 #[derive(Error, Debug)]
 pub enum TorrentError {
@@ -55,17 +55,36 @@ type StorageRegistry = Arc<RwLock<HashMap<String, Arc<RwLock<BaeStorage>>>>>;
 /// libtorrent assigns a storage_index when a torrent is added, we need to map it to our torrent_id
 type StorageIndexMap = Arc<RwLock<HashMap<i32, String>>>;
 
-thread_local! {
-    pub(crate) static STORAGE_REGISTRY: std::cell::RefCell<Option<StorageRegistry>> = const { std::cell::RefCell::new(None) };
-    pub(crate) static STORAGE_INDEX_MAP: std::cell::RefCell<Option<StorageIndexMap>> = const { std::cell::RefCell::new(None) };
-    pub(crate) static RUNTIME_HANDLE: std::cell::RefCell<Option<tokio::runtime::Handle>> = const { std::cell::RefCell::new(None) };
+/// What the storage callbacks need to reach BaeStorage instances from C++
+#[derive(Clone)]
+pub(crate) struct StorageCallbackContext {
+    pub(crate) registry: StorageRegistry,
+    pub(crate) index_map: StorageIndexMap,
+    pub(crate) runtime: tokio::runtime::Handle,
+    pub(crate) events: mpsc::UnboundedSender<StorageEvent>,
 }
 
+/// Set when the client with custom storage is created. libtorrent invokes the storage
+/// callbacks on its own disk job threads, so this can't be thread-local.
+pub(crate) static STORAGE_CALLBACK_CONTEXT: std::sync::RwLock<Option<StorageCallbackContext>> =
+    std::sync::RwLock::new(None);
+
 /// Configuration options for creating a TorrentClient
 #[derive(Debug, Clone, Default)]
 pub struct TorrentClientOptions {
     /// Network interface to bind to (e.g. "eth0", "tun0", "0.0.0.0:6881")
     pub bind_interface: Option<String>,
+    /// Queueing limits for auto-managed torrents (libtorrent defaults if not set)
+    pub active_limits: Option<ActiveLimits>,
+}
+
+/// How many auto-managed torrents the session keeps running at once
+#[derive(Debug, Clone, Copy)]
+pub struct ActiveLimits {
+    /// Max auto-managed torrents seeding at once
+    pub active_seeds: i32,
+    /// Max auto-managed torrents running at once, seeding or downloading
+    pub active_limit: i32,
 }
 
 /// Wrapper around libtorrent session
@@ -78,15 +97,11 @@ pub struct TorrentClient {
 
 // NOTE: TorrentClient is NOT Send or Sync because:
 //
-// 1. It uses thread_local! storage (STORAGE_REGISTRY, STORAGE_INDEX_MAP, RUNTIME_HANDLE)
-//    that is initialized in TorrentClient::new() on the creating thread.
+// 1. It shares its session through an Rc, and the cxx session pointer isn't thread-safe.
 //
-// 2. The C++ storage callbacks access this thread-local storage. If TorrentClient is moved
-//    to a different thread, the callbacks won't find the registry and will fail.
-//
-// 3. Therefore, TorrentClient must be created and used on a single dedicated thread.
+// 2. Therefore, TorrentClient must be created and used on a single dedicated thread.
 //    ImportService and TorrentSeeder spawn dedicated threads for two reasons:
-//    - TorrentClient cannot be moved between threads (thread-local storage constraint)
+//    - TorrentClient cannot be moved between threads
 //    - They need separate instances with different storage types:
 //      * ImportService/TorrentSeeder use custom storage (BaeStorage) via TorrentClient::new()
 //      * ImportContext uses default storage for metadata detection via TorrentClient::new_with_default_storage()
@@ -110,11 +125,17 @@ impl TorrentClient {
     pub fn new_with_bae_storage(
         runtime_handle: tokio::runtime::Handle,
         options: TorrentClientOptions,
+        storage_events: mpsc::UnboundedSender<StorageEvent>,
     ) -> Result<Self, TorrentError> {
         let (storage_registry, storage_index_map) = create_empty_storage_registries();
 
-        // Setup thread-local storage for callbacks to access
-        setup_thread_local_storage(&storage_registry, &storage_index_map, &runtime_handle);
+        // Make the registries reachable from the storage callbacks
+        setup_storage_callback_context(
+            &storage_registry,
+            &storage_index_map,
+            &runtime_handle,
+            storage_events,
+        );
 
         // Create storage constructor with callbacks
         let storage_constructor = create_bae_storage_constructor();
@@ -178,6 +199,37 @@ impl TorrentClient {
         index_map.insert(storage_index, torrent_id);
     }
 
+    /// Drop the storage registered for a libtorrent storage index, returning it
+    pub async fn unregister_storage(&self, storage_index: i32) -> Option<Arc<RwLock<BaeStorage>>> {
+        let torrent_id = self
+            .storage_index_map
+            .write()
+            .await
+            .remove(&storage_index)?;
+        self.storage_registry.write().await.remove(&torrent_id)
+    }
+
+    /// The storage registered for a libtorrent storage index
+    pub async fn storage_for_index(&self, storage_index: i32) -> Option<Arc<RwLock<BaeStorage>>> {
+        let torrent_id = self
+            .storage_index_map
+            .read()
+            .await
+            .get(&storage_index)
+            .cloned()?;
+        self.storage_registry.read().await.get(&torrent_id).cloned()
+    }
+
+    /// All BaeStorage instances currently registered with this client
+    pub async fn storages(&self) -> Vec<Arc<RwLock<BaeStorage>>> {
+        self.storage_registry
+            .read()
+            .await
+            .values()
+            .cloned()
+            .collect()
+    }
+
     /// Add a torrent from a file
     pub async fn add_torrent_file(&self, path: &Path) -> Result<TorrentHandle, TorrentError> {
         // Convert path to string
@@ -391,6 +443,18 @@ impl TorrentClient {
         drop(session_guard);
         alerts
     }
+
+    /// Get a status snapshot of every torrent in the session
+    pub async fn torrent_statuses(&self) -> Vec<TorrentStatusData> {
+        let mut session_guard = self.session.write().await;
+        let session_ptr = get_session_ptr(&mut session_guard);
+        if session_ptr.is_null() {
+            return Vec::new();
+        }
+        let statuses = unsafe { session_get_torrent_statuses(session_ptr) };
+        drop(session_guard);
+        statuses
+    }
 }
 
 /// Wrapper around raw TorrentHandle pointer that is Send/Sync-safe
@@ -417,14 +481,16 @@ unsafe impl Send for TorrentHandle {}
 unsafe impl Sync for TorrentHandle {}
 
 impl TorrentHandle {
-    /// Get the info hash of this torrent
+    /// Get the info hash of this torrent as an uppercase hex string
     ///
-    /// NOTE: The libtorrent-rs crate doesn't expose info_hash directly.
-    /// We would need to extract it from bencoded data or extend FFI.
+    /// Matches the keys used for alerts and status snapshots.
     pub async fn info_hash(&self) -> String {
-        // TODO: Extract from bencoded data or extend FFI
-        // For now, return placeholder
-        "0000000000000000000000000000000000000000".to_string()
+        let handle_guard = self.handle.0.read().await;
+        let handle_ptr = *handle_guard;
+        if handle_ptr.is_null() {
+            return String::new();
+        }
+        unsafe { torrent_get_info_hash(handle_ptr) }
     }
 
     /// Get the storage index for this torrent
@@ -607,54 +673,6 @@ impl TorrentHandle {
         Ok(progress)
     }
 
-    /// Get number of connected peers
-    pub async fn num_peers(&self) -> Result<i32, TorrentError> {
-        let handle_guard = self.handle.0.read().await;
-        let handle_ptr = *handle_guard;
-        if handle_ptr.is_null() {
-            return Err(TorrentError::Libtorrent(
-                "Invalid torrent handle".to_string(),
-            ));
-        }
-
-        let num_peers = unsafe { torrent_get_num_peers(handle_ptr) };
-        drop(handle_guard);
-
-        Ok(num_peers)
-    }
-
-    /// Get number of seeders
-    pub async fn num_seeds(&self) -> Result<i32, TorrentError> {
-        let handle_guard = self.handle.0.read().await;
-        let handle_ptr = *handle_guard;
-        if handle_ptr.is_null() {
-            return Err(TorrentError::Libtorrent(
-                "Invalid torrent handle".to_string(),
-            ));
-        }
-
-        let num_seeds = unsafe { torrent_get_num_seeds(handle_ptr) };
-        drop(handle_guard);
-
-        Ok(num_seeds)
-    }
-
-    /// Get tracker status as a formatted string
-    pub async fn tracker_status(&self) -> Result<String, TorrentError> {
-        let handle_guard = self.handle.0.read().await;
-        let handle_ptr = *handle_guard;
-        if handle_ptr.is_null() {
-            return Err(TorrentError::Libtorrent(
-                "Invalid torrent handle".to_string(),
-            ));
-        }
-
-        let status = unsafe { torrent_get_tracker_status(handle_ptr) };
-        drop(handle_guard);
-
-        Ok(status)
-    }
-
     /// Read a piece of data from our custom storage
     ///
     /// Wait for metadata to be available
@@ -733,6 +751,19 @@ fn apply_options_to_session_params(
     } else {
         info!("Torrent session using default network binding (no interface specified)");
     }
+
+    if let Some(limits) = options.active_limits {
+        info!(
+            "Torrent session queue: {} active seeds, {} active torrents",
+            limits.active_seeds, limits.active_limit
+        );
+        unsafe {
+            if let Some(pinned_params) = session_params.as_mut() {
+                let params_ptr = std::pin::Pin::get_unchecked_mut(pinned_params) as *mut _;
+                set_active_limits(params_ptr, limits.active_seeds, limits.active_limit);
+            }
+        }
+    }
 }
 
 /// Get the IP address of a network interface and format it as IP:port for libtorrent
@@ -777,25 +808,23 @@ fn create_empty_storage_registries() -> (StorageRegistry, StorageIndexMap) {
     )
 }
 
-/// Setup thread-local storage for callbacks to access storage registry and runtime handle
-fn setup_thread_local_storage(
+/// Publish the storage registry, index map, runtime handle and event channel to the
+/// storage callbacks
+fn setup_storage_callback_context(
     storage_registry: &StorageRegistry,
     storage_index_map: &StorageIndexMap,
     runtime_handle: &tokio::runtime::Handle,
+    events: mpsc::UnboundedSender<StorageEvent>,
 ) {
-    let registry_clone = Arc::clone(storage_registry);
-    let index_map_clone = Arc::clone(storage_index_map);
-    let runtime_clone = runtime_handle.clone();
-
-    STORAGE_REGISTRY.with(|tl| {
-        *tl.borrow_mut() = Some(registry_clone);
-    });
-    STORAGE_INDEX_MAP.with(|tl| {
-        *tl.borrow_mut() = Some(index_map_clone);
-    });
-    RUNTIME_HANDLE.with(|tl| {
-        *tl.borrow_mut() = Some(runtime_clone);
-    });
+    let context = StorageCallbackContext {
+        registry: Arc::clone(storage_registry),
+        index_map: Arc::clone(storage_index_map),
+        runtime: runtime_handle.clone(),
+        events,
+    };
+    *STORAGE_CALLBACK_CONTEXT
+        .write()
+        .unwrap_or_else(|e| e.into_inner()) = Some(context);
 }
 
 /// Create a session from session_params, applying options and checking for errors
@@ -25,7 +25,10 @@ mod ffi {
         /// - read_cb: Called when libtorrent needs to read a piece
         ///   storage_index identifies which torrent's storage to use
         /// - write_cb: Called when libtorrent needs to write a piece
-        /// - hash_cb: Called when libtorrent needs to verify a piece hash
+        /// - release_cb: Called when a torrent is stopped or removed, so its
+        ///   storage can drop cached state (removed is true once it's gone for good)
+        ///
+        /// Piece hashes are computed on the C++ side as blocks are written.
         fn create_bae_storage_constructor(
             read_callback: fn(
                 storage_index: i32,
@@ -39,7 +42,7 @@ mod ffi {
                 offset: i32,
                 data: &[u8],
             ) -> bool,
-            hash_callback: fn(storage_index: i32, piece_index: i32, hash: &[u8]) -> bool,
+            release_callback: fn(storage_index: i32, removed: bool),
         ) -> UniquePtr<BaeStorageConstructor>;
 
         /// Create session_params with custom disk I/O constructor
@@ -56,6 +59,18 @@ mod ffi {
         /// `params` must be a valid pointer to SessionParams that outlives the call.
         unsafe fn set_listen_interfaces(params: *mut SessionParams, interfaces: &str);
 
+        /// Set the active_seeds and active_limit queueing limits on session_params
+        ///
+        /// Only auto-managed torrents are queued against these limits.
+        ///
+        /// # Safety
+        /// `params` must be a valid pointer to SessionParams that outlives the call.
+        unsafe fn set_active_limits(
+            params: *mut SessionParams,
+            active_seeds: i32,
+            active_limit: i32,
+        );
+
         /// Create a session from session_params (extends libtorrent-rs)
         fn create_session_with_params(params: UniquePtr<SessionParams>) -> UniquePtr<Session>;
 
@@ -79,12 +94,20 @@ mod ffi {
         /// `params` must be a valid pointer to AddTorrentParams that outlives the call.
         unsafe fn set_seed_mode(params: *mut AddTorrentParams, seed_mode: bool);
 
-        /// Set paused flag on add_torrent_params to add torrent in paused state
+        /// Set or clear the paused flag on add_torrent_params
         ///
         /// # Safety
         /// `params` must be a valid pointer to AddTorrentParams that outlives the call.
         unsafe fn set_paused(params: *mut AddTorrentParams, paused: bool);
 
+        /// Set or clear the auto_managed flag on add_torrent_params
+        ///
+        /// libtorrent adds torrents auto-managed by default, so they wait for a queue slot.
+        ///
+        /// # Safety
+        /// `params` must be a valid pointer to AddTorrentParams that outlives the call.
+        unsafe fn set_auto_managed(params: *mut AddTorrentParams, auto_managed: bool);
+
         /// Add a torrent to a session using our Session type
         ///
         /// # Safety
@@ -151,23 +174,17 @@ mod ffi {
         /// `handle` must be a valid pointer to a TorrentHandle that outlives the call.
         unsafe fn torrent_get_progress(handle: *mut TorrentHandle) -> f32;
 
-        /// Get number of connected peers
+        /// Get the info hash of a torrent as an uppercase hex string
         ///
         /// # Safety
         /// `handle` must be a valid pointer to a TorrentHandle that outlives the call.
-        unsafe fn torrent_get_num_peers(handle: *mut TorrentHandle) -> i32;
+        unsafe fn torrent_get_info_hash(handle: *mut TorrentHandle) -> String;
 
-        /// Get number of seeders
+        /// Get a status snapshot of every torrent in a session with one session call
         ///
         /// # Safety
-        /// `handle` must be a valid pointer to a TorrentHandle that outlives the call.
-        unsafe fn torrent_get_num_seeds(handle: *mut TorrentHandle) -> i32;
-
-        /// Get tracker status as a formatted string
-        ///
-        /// # Safety
-        /// `handle` must be a valid pointer to a TorrentHandle that outlives the call.
-        unsafe fn torrent_get_tracker_status(handle: *mut TorrentHandle) -> String;
+        /// `sess` must be a valid pointer to a Session that outlives the call.
+        unsafe fn session_get_torrent_statuses(sess: *mut Session) -> Vec<TorrentStatusData>;
 
         /// Get the listen_interfaces setting from a session
         ///
@@ -240,14 +257,24 @@ mod ffi {
         files: Vec<TorrentFileInfo>,
     }
 
+    /// Status snapshot of one torrent (shared between Rust and C++)
+    struct TorrentStatusData {
+        info_hash: String,
+        progress: f32, // 0.0 to 1.0
+        num_peers: i32,
+        num_seeds: i32,
+        download_rate: i32, // payload bytes/sec
+        upload_rate: i32,   // payload bytes/sec
+        seed_rank: i32,     // higher runs first when the queue picks seeds
+        is_queued: bool,    // auto-managed and paused by the queue
+    }
+
     /// Alert data from libtorrent (shared between Rust and C++)
     struct AlertData {
         alert_type: i32, // AlertType enum value
         info_hash: String,
         tracker_url: String,
         tracker_message: String,
-        num_peers: i32,
-        num_seeds: i32,
         file_path: String,
         progress: f32,
         error_message: String,
@@ -257,12 +284,12 @@ mod ffi {
 pub use ffi::{
     create_bae_storage_constructor, create_session_params_default,
     create_session_params_with_storage, create_session_with_params, get_session_ptr,
-    get_torrent_info, load_torrent_file, parse_magnet_uri, session_add_torrent, session_pop_alerts,
-    session_remove_torrent, set_listen_interfaces, set_paused, set_seed_mode,
-    torrent_get_file_list, torrent_get_name, torrent_get_num_peers, torrent_get_num_pieces,
-    torrent_get_num_seeds, torrent_get_piece_length, torrent_get_progress,
-    torrent_get_storage_index, torrent_get_total_size, torrent_get_tracker_status,
-    torrent_has_metadata, torrent_pause, torrent_resume, torrent_set_file_priorities,
-    AddTorrentParams, AlertData, BaeStorageConstructor, Session, SessionParams, TorrentFileInfo,
-    TorrentHandle, TorrentInfo,
+    get_torrent_info, load_torrent_file, parse_magnet_uri, session_add_torrent,
+    session_get_torrent_statuses, session_pop_alerts, session_remove_torrent, set_active_limits,
+    set_auto_managed, set_listen_interfaces, set_paused, set_seed_mode, torrent_get_file_list,
+    torrent_get_info_hash, torrent_get_name, torrent_get_num_pieces, torrent_get_piece_length,
+    torrent_get_progress, torrent_get_storage_index, torrent_get_total_size, torrent_has_metadata,
+    torrent_pause, torrent_resume, torrent_set_file_priorities, AddTorrentParams, AlertData,
+    BaeStorageConstructor, Session, SessionParams, TorrentFileInfo, TorrentHandle, TorrentInfo,
+    TorrentStatusData,
 };
@@ -1,13 +1,30 @@
 use crate::cache::CacheManager;
-use crate::db::{Database, DbTorrent, DbTorrentPieceMapping};
+use crate::cloud_storage::CloudStorageManager;
+use crate::db::{Database, DbChunk, DbTorrent, DbTorrentPieceMap};
+use crate::encryption::EncryptionService;
+use crate::import::metadata_persister::MetadataPersister;
 use crate::import::{FolderMetadata, TorrentFileMetadata, TorrentSource};
+use crate::library::LibraryManager;
 use crate::torrent::client::{TorrentClient, TorrentClientOptions, TorrentError, TorrentHandle};
-use crate::torrent::progress::{TorrentProgress, TorrentProgressHandle};
-use crate::torrent::{BaeStorage, TorrentPieceMapper};
+use crate::torrent::pin_manager::PinChanges;
+use crate::torrent::progress::{
+    TorrentProgress, TorrentProgressHandle, TorrentStatusMap, TorrentStatusSnapshot,
+};
+use crate::torrent::storage::StorageEvent;
+use crate::torrent::{BaeStorage, PieceMap, PinManager};
+use std::collections::HashMap;
+use std::sync::Arc;
+use std::time::Duration;
 use thiserror::Error;
-use tokio::sync::{mpsc, oneshot};
+use tokio::sync::{mpsc, oneshot, watch};
 use tracing::{error, info, warn};
 
+/// How often the status of all torrents is snapshotted from the sessions
+const STATUS_SNAPSHOT_INTERVAL: Duration = Duration::from_millis(500);
+
+/// How often seeded chunk pins are rebalanced from request counts
+const PIN_REBALANCE_INTERVAL: Duration = Duration::from_secs(60);
+
 #[derive(Error, Debug)]
 pub enum SeederError {
     #[error("Database error: {0}")]
@@ -65,6 +82,7 @@ pub enum TorrentManagerCommand {
 pub struct TorrentManagerHandle {
     command_tx: mpsc::UnboundedSender<TorrentManagerCommand>,
     progress_handle: TorrentProgressHandle,
+    status_rx: watch::Receiver<TorrentStatusMap>,
 }
 
 impl TorrentManagerHandle {
@@ -162,6 +180,14 @@ impl TorrentManagerHandle {
     pub fn subscribe_torrent(&self, info_hash: String) -> mpsc::UnboundedReceiver<TorrentProgress> {
         self.progress_handle.subscribe_torrent(info_hash)
     }
+
+    /// Subscribe to the latest status snapshot of all torrents
+    ///
+    /// Snapshots are refreshed every `STATUS_SNAPSHOT_INTERVAL` with one session call,
+    /// however many torrents or subscribers there are.
+    pub fn subscribe_status(&self) -> watch::Receiver<TorrentStatusMap> {
+        self.status_rx.clone()
+    }
 }
 
 /// Manages all torrent operations (downloads, metadata detection, seeding)
@@ -170,25 +196,40 @@ struct TorrentManager {
     command_rx: mpsc::UnboundedReceiver<TorrentManagerCommand>,
     download_client: TorrentClient, // default storage
     seeding_client: TorrentClient,  // custom storage (BaeStorage)
-    cache_manager: CacheManager,
+    /// Storages libtorrent released, reported by the storage callbacks
+    storage_events: mpsc::UnboundedReceiver<StorageEvent>,
+    /// Handles of torrents in the seeding session, by release ID
+    seeding_handles: HashMap<String, TorrentHandle>,
+    /// Budgeted local cache of decrypted chunks served to peers
+    seed_cache: CacheManager,
+    /// Keeps the most requested seeded chunks pinned in the seed cache
+    pin_manager: PinManager,
+    cloud_storage: CloudStorageManager,
+    encryption_service: EncryptionService,
     database: Database,
-    chunk_size_bytes: usize,
     progress_tx: mpsc::UnboundedSender<TorrentProgress>,
+    status_tx: watch::Sender<TorrentStatusMap>,
 }
 
 /// Start the torrent manager service
 /// Returns a handle for sending commands to the manager
 pub fn start_torrent_manager(
-    cache_manager: CacheManager,
+    seed_cache: CacheManager,
+    pin_manager: PinManager,
+    cloud_storage: CloudStorageManager,
+    encryption_service: EncryptionService,
     database: Database,
-    chunk_size_bytes: usize,
     options: TorrentClientOptions,
 ) -> TorrentManagerHandle {
     let (command_tx, command_rx) = mpsc::unbounded_channel();
     let (progress_tx, progress_rx) = mpsc::unbounded_channel();
+    let (status_tx, status_rx) = watch::channel(TorrentStatusMap::default());
+    let (storage_events_tx, storage_events_rx) = mpsc::unbounded_channel();
 
     // Clone for the thread
-    let cache_manager_for_worker = cache_manager.clone();
+    let seed_cache_for_worker = seed_cache.clone();
+    let cloud_storage_for_worker = cloud_storage.clone();
+    let encryption_service_for_worker = encryption_service.clone();
     let database_for_worker = database.clone();
     let progress_tx_for_worker = progress_tx.clone();
     let progress_rx_for_handle = progress_rx;
@@ -221,24 +262,37 @@ pub fn start_torrent_manager(
 
             // Create both TorrentClient instances on this thread
             info!("TorrentManager: Creating download client (default storage)...");
+            // Queue limits are for seeding; downloads keep libtorrent's defaults.
+            // Imports read the finished files from disk, so downloads stay on
+            // libtorrent's file storage and never reach BaeDiskInterface.
+            let download_options = TorrentClientOptions {
+                active_limits: None,
+                ..options.clone()
+            };
             let download_client =
-                TorrentClient::new_with_default_storage(rt_handle.clone(), options.clone())
+                TorrentClient::new_with_default_storage(rt_handle.clone(), download_options)
                     .expect("Failed to create download torrent client");
             info!("TorrentManager: Download client created successfully");
 
             info!("TorrentManager: Creating seeding client (custom storage)...");
-            let seeding_client = TorrentClient::new_with_bae_storage(rt_handle.clone(), options)
-                .expect("Failed to create seeding torrent client");
+            let seeding_client =
+                TorrentClient::new_with_bae_storage(rt_handle.clone(), options, storage_events_tx)
+                    .expect("Failed to create seeding torrent client");
             info!("TorrentManager: Seeding client created successfully");
 
             let service = TorrentManager {
                 command_rx,
                 download_client,
                 seeding_client,
-                cache_manager: cache_manager_for_worker,
+                storage_events: storage_events_rx,
+                seeding_handles: HashMap::new(),
+                seed_cache: seed_cache_for_worker,
+                pin_manager,
+                cloud_storage: cloud_storage_for_worker,
+                encryption_service: encryption_service_for_worker,
                 database: database_for_worker,
-                chunk_size_bytes,
                 progress_tx: progress_tx_for_worker,
+                status_tx,
             };
 
             service.run_manager_worker().await;
@@ -256,6 +310,7 @@ pub fn start_torrent_manager(
     TorrentManagerHandle {
         command_tx,
         progress_handle,
+        status_rx,
     }
 }
 
@@ -263,6 +318,11 @@ impl TorrentManager {
     async fn run_manager_worker(mut self) {
         info!("TorrentManager worker started");
 
+        let mut status_interval = tokio::time::interval(STATUS_SNAPSHOT_INTERVAL);
+        status_interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        let mut pin_interval = tokio::time::interval(PIN_REBALANCE_INTERVAL);
+        pin_interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+
         loop {
             tokio::select! {
                 // Handle commands
@@ -325,6 +385,18 @@ impl TorrentManager {
                         }
                     }
                 }
+                // Follow storages libtorrent stops, resumes and removes
+                Some(event) = self.storage_events.recv() => {
+                    self.handle_storage_event(event).await;
+                }
+                // Snapshot all torrent statuses periodically
+                _ = status_interval.tick() => {
+                    self.refresh_status_snapshot().await;
+                }
+                // Move seed cache pins to the chunks peers ask for most
+                _ = pin_interval.tick() => {
+                    self.rebalance_pins().await;
+                }
                 // Poll alerts periodically
                 _ = tokio::time::sleep(tokio::time::Duration::from_millis(100)) => {
                     let alerts = self.download_client.pop_alerts().await;
@@ -338,15 +410,138 @@ impl TorrentManager {
         info!("TorrentManager worker stopped");
     }
 
+    /// Take one status snapshot of both sessions and publish it
+    ///
+    /// Subscribers to per-torrent progress also get a StatusUpdate when a torrent's
+    /// peer or seed count changed since the previous snapshot.
+    async fn refresh_status_snapshot(&self) {
+        let mut statuses = self.download_client.torrent_statuses().await;
+        statuses.extend(self.seeding_client.torrent_statuses().await);
+
+        let snapshot: TorrentStatusMap = Arc::new(
+            statuses
+                .into_iter()
+                .map(|status| {
+                    (
+                        status.info_hash,
+                        TorrentStatusSnapshot {
+                            progress: status.progress,
+                            num_peers: status.num_peers,
+                            num_seeds: status.num_seeds,
+                            download_rate: status.download_rate,
+                            upload_rate: status.upload_rate,
+                            seed_rank: status.seed_rank,
+                            is_queued: status.is_queued,
+                        },
+                    )
+                })
+                .collect::<HashMap<_, _>>(),
+        );
+
+        let previous = self.status_tx.send_replace(snapshot.clone());
+        for (info_hash, status) in snapshot.iter() {
+            let peers_changed = previous.get(info_hash).is_none_or(|prev| {
+                prev.num_peers != status.num_peers || prev.num_seeds != status.num_seeds
+            });
+            if peers_changed {
+                let _ = self.progress_tx.send(TorrentProgress::StatusUpdate {
+                    info_hash: info_hash.clone(),
+                    num_peers: status.num_peers,
+                    num_seeds: status.num_seeds,
+                    trackers: vec![],
+                });
+            }
+        }
+    }
+
+    /// Sample request counts from every seeding storage and apply the pin changes
+    async fn rebalance_pins(&mut self) {
+        let mut demand = Vec::new();
+        for storage in self.seeding_client.storages().await {
+            demand.extend(storage.read().await.take_chunk_demand());
+        }
+
+        let changes = self.pin_manager.rebalance(demand);
+        if changes.pin.is_empty() && changes.unpin.is_empty() {
+            return;
+        }
+
+        self.apply_pin_changes(&changes).await;
+
+        info!(
+            "Rebalanced seed cache pins: {} pinned, {} unpinned",
+            changes.pin.len(),
+            changes.unpin.len()
+        );
+    }
+
+    async fn apply_pin_changes(&self, changes: &PinChanges) {
+        self.seed_cache.unpin_chunks(&changes.unpin).await;
+        self.seed_cache.pin_chunks(&changes.pin).await;
+    }
+
+    /// Unpin the chunks of storages libtorrent released and re-pin them when it resumes
+    async fn handle_storage_event(&mut self, event: StorageEvent) {
+        match event {
+            StorageEvent::Released {
+                storage_index,
+                removed,
+            } => {
+                let storage = if removed {
+                    self.seeding_client.unregister_storage(storage_index).await
+                } else {
+                    self.seeding_client.storage_for_index(storage_index).await
+                };
+                let Some(storage) = storage else {
+                    return;
+                };
+
+                let chunk_ids = storage.read().await.chunk_ids();
+                let unpin = self.pin_manager.release(&chunk_ids);
+                self.seed_cache.unpin_chunks(&unpin).await;
+            }
+            StorageEvent::Resumed { storage_index } => {
+                let Some(storage) = self.seeding_client.storage_for_index(storage_index).await
+                else {
+                    return;
+                };
+
+                let chunk_ids = storage.read().await.chunk_ids();
+                let changes = self.pin_manager.restore(&chunk_ids);
+                self.apply_pin_changes(&changes).await;
+            }
+        }
+    }
+
+    /// Handle the storage events queued so far
+    ///
+    /// libtorrent reports a removed storage before it can reuse its index, so draining
+    /// before registering keeps a stale release from dropping the new storage.
+    async fn drain_storage_events(&mut self) {
+        while let Ok(event) = self.storage_events.try_recv() {
+            self.handle_storage_event(event).await;
+        }
+    }
+
+    /// Peer and seed counts for a torrent from the latest status snapshot
+    fn peer_counts(&self, info_hash: &str) -> (i32, i32) {
+        self.status_tx
+            .borrow()
+            .get(info_hash)
+            .map(|status| (status.num_peers, status.num_seeds))
+            .unwrap_or_default()
+    }
+
     async fn process_alert(&self, alert: crate::torrent::ffi::AlertData) {
         let info_hash = alert.info_hash.clone();
         match alert.alert_type {
             0 => {
                 // ALERT_TRACKER_ANNOUNCE
+                let (num_peers, num_seeds) = self.peer_counts(&info_hash);
                 let _ = self.progress_tx.send(TorrentProgress::StatusUpdate {
                     info_hash: info_hash.clone(),
-                    num_peers: alert.num_peers,
-                    num_seeds: alert.num_seeds,
+                    num_peers,
+                    num_seeds,
                     trackers: vec![crate::torrent::progress::TrackerStatus {
                         url: alert.tracker_url.clone(),
                         status: "announcing".to_string(),
@@ -356,10 +551,11 @@ impl TorrentManager {
             }
             1 => {
                 // ALERT_TRACKER_ERROR
+                let (num_peers, num_seeds) = self.peer_counts(&info_hash);
                 let _ = self.progress_tx.send(TorrentProgress::StatusUpdate {
                     info_hash: info_hash.clone(),
-                    num_peers: alert.num_peers,
-                    num_seeds: alert.num_seeds,
+                    num_peers,
+                    num_seeds,
                     trackers: vec![crate::torrent::progress::TrackerStatus {
                         url: alert.tracker_url.clone(),
                         status: "error".to_string(),
@@ -367,15 +563,6 @@ impl TorrentManager {
                     }],
                 });
             }
-            2 | 3 => {
-                // ALERT_PEER_CONNECT or ALERT_PEER_DISCONNECT
-                let _ = self.progress_tx.send(TorrentProgress::StatusUpdate {
-                    info_hash: info_hash.clone(),
-                    num_peers: alert.num_peers,
-                    num_seeds: alert.num_seeds,
-                    trackers: vec![],
-                });
-            }
             4 => {
                 // ALERT_FILE_COMPLETED
                 let _ = self.progress_tx.send(TorrentProgress::MetadataProgress {
@@ -393,21 +580,13 @@ impl TorrentManager {
                     num_files: 0,
                 });
             }
-            10 | 11 => {
-                // ALERT_STATE_CHANGED or ALERT_STATS
-                let _ = self.progress_tx.send(TorrentProgress::StatusUpdate {
-                    info_hash: info_hash.clone(),
-                    num_peers: alert.num_peers,
-                    num_seeds: alert.num_seeds,
-                    trackers: vec![],
-                });
-            }
+            // Peer and state changes are picked up by the next status snapshot
             _ => {}
         }
     }
 
     /// Start seeding a torrent for a release
-    async fn start_seeding(&self, release_id: &str) -> Result<(), SeederError> {
+    async fn start_seeding(&mut self, release_id: &str) -> Result<(), SeederError> {
         // Load torrent metadata from database
         let torrent = self.get_torrent_by_release(release_id).await?;
 
@@ -423,7 +602,7 @@ impl TorrentManager {
 
         // Parse magnet link and enable seed_mode to skip hash verification
         // (we already have valid chunks in the chunk store)
-        use crate::torrent::ffi::{parse_magnet_uri, set_seed_mode};
+        use crate::torrent::ffi::{parse_magnet_uri, set_auto_managed, set_paused, set_seed_mode};
 
         let temp_path = std::env::temp_dir().to_string_lossy().to_string();
         let mut params = parse_magnet_uri(magnet_link, &temp_path);
@@ -433,11 +612,16 @@ impl TorrentManager {
             )));
         }
 
-        // Enable seed mode to skip hash verification
+        // Enable seed mode to skip hash verification. The torrent is auto-managed from
+        // the start, so the session queue keeps only the active_seeds highest ranked
+        // seeds running and rotates the rest in as swarm demand shifts. A magnet that
+        // never gets its metadata is queued like any other torrent.
         unsafe {
             if let Some(pinned_params) = params.as_mut() {
                 let params_ptr = std::pin::Pin::get_unchecked_mut(pinned_params) as *mut _;
                 set_seed_mode(params_ptr, true);
+                set_auto_managed(params_ptr, true);
+                set_paused(params_ptr, false);
             }
         }
 
@@ -459,42 +643,32 @@ impl TorrentManager {
             .await
             .map_err(SeederError::Torrent)?;
 
-        // Create piece mapper
-        let piece_mapper = TorrentPieceMapper::new(
-            torrent.piece_length as usize,
-            self.chunk_size_bytes,
-            torrent.num_pieces as usize,
-            torrent.total_size_bytes as usize,
-        );
+        // Load the piece map and the release chunks it references
+        let (piece_map, release_chunks) = self.load_piece_map(&torrent).await?;
 
-        // Create BaeStorage instance
+        // Create BaeStorage instance. Nothing is prefetched: chunks peers ask for are
+        // fetched from the cloud into the seed cache, within its budget.
         let bae_storage = BaeStorage::new(
-            self.cache_manager.clone(),
-            self.database.clone(),
-            piece_mapper,
-            torrent.info_hash.clone(),
+            self.seed_cache.clone(),
+            self.cloud_storage.clone(),
+            self.encryption_service.clone(),
+            piece_map,
+            release_chunks,
         );
+        let chunk_ids = bae_storage.chunk_ids();
 
         // Register storage with torrent client
+        self.drain_storage_events().await;
         self.seeding_client
             .register_storage(storage_index, torrent.info_hash.clone(), bae_storage)
             .await;
 
-        // Load piece mappings
-        let piece_mappings = self.get_piece_mappings(&torrent.id).await?;
+        // Re-pin chunks that were pinned when the release was last seeded
+        let changes = self.pin_manager.restore(&chunk_ids);
+        self.apply_pin_changes(&changes).await;
 
-        // Get all chunk IDs that need to be pinned
-        let mut chunk_ids = Vec::new();
-        for mapping in &piece_mappings {
-            let ids: Vec<String> = serde_json::from_str(&mapping.chunk_ids).map_err(|e| {
-                SeederError::PieceMapping(format!("Failed to parse chunk IDs: {}", e))
-            })?;
-            chunk_ids.extend(ids);
-        }
-
-        // Pin all chunks in cache
-        self.cache_manager.pin_chunks(&chunk_ids).await;
-        info!("Pinned {} chunks for seeding", chunk_ids.len());
+        self.seeding_handles
+            .insert(release_id.to_string(), torrent_handle);
 
         // Mark torrent as seeding in database
         self.mark_torrent_seeding(&torrent.id, true).await?;
@@ -505,7 +679,7 @@ impl TorrentManager {
     }
 
     /// Stop seeding a torrent
-    async fn stop_seeding(&self, release_id: &str) -> Result<(), SeederError> {
+    async fn stop_seeding(&mut self, release_id: &str) -> Result<(), SeederError> {
         let torrent = self.get_torrent_by_release(release_id).await?;
 
         info!(
@@ -513,22 +687,14 @@ impl TorrentManager {
             release_id, torrent.info_hash
         );
 
-        // Load piece mappings to get chunk IDs
-        let piece_mappings = self.get_piece_mappings(&torrent.id).await?;
-
-        // Get all chunk IDs that were pinned
-        let mut chunk_ids = Vec::new();
-        for mapping in &piece_mappings {
-            let ids: Vec<String> = serde_json::from_str(&mapping.chunk_ids).map_err(|e| {
-                SeederError::PieceMapping(format!("Failed to parse chunk IDs: {}", e))
-            })?;
-            chunk_ids.extend(ids);
+        // Removing the torrent makes the disk interface release its storage, which
+        // drops its piece map
+        if let Some(handle) = self.seeding_handles.remove(release_id) {
+            self.seeding_client
+                .remove_torrent_and_keep_data(&handle)
+                .await?;
         }
 
-        // Unpin chunks
-        self.cache_manager.unpin_chunks(&chunk_ids).await;
-        info!("Unpinned {} chunks", chunk_ids.len());
-
         // Mark torrent as not seeding
         self.mark_torrent_seeding(&torrent.id, false).await?;
 
@@ -543,12 +709,51 @@ impl TorrentManager {
             .ok_or_else(|| SeederError::Database(sqlx::Error::RowNotFound))
     }
 
-    /// Get piece mappings for a torrent
-    async fn get_piece_mappings(
+    /// Load a torrent's piece map along with its release's chunks, ordered by chunk index
+    async fn load_piece_map(
         &self,
-        torrent_id: &str,
-    ) -> Result<Vec<DbTorrentPieceMapping>, SeederError> {
-        Ok(self.database.get_torrent_piece_mappings(torrent_id).await?)
+        torrent: &DbTorrent,
+    ) -> Result<(PieceMap, Vec<DbChunk>), SeederError> {
+        let db_piece_map = match self.database.get_torrent_piece_map(&torrent.id).await? {
+            Some(db_piece_map) => db_piece_map,
+            None => self.rebuild_piece_map(torrent).await?,
+        };
+        let piece_map = PieceMap::from_bytes(db_piece_map.piece_map)
+            .map_err(|e| SeederError::PieceMapping(e.to_string()))?;
+
+        let chunks = self
+            .database
+            .get_chunks_for_release(&torrent.release_id)
+            .await?;
+
+        Ok((piece_map, chunks))
+    }
+
+    /// Build and store the piece map of a torrent that has none
+    ///
+    /// Torrents imported before piece maps were stored as one blob per torrent
+    /// only had per-piece rows, which are not carried over.
+    async fn rebuild_piece_map(
+        &self,
+        torrent: &DbTorrent,
+    ) -> Result<DbTorrentPieceMap, SeederError> {
+        warn!(
+            "No piece map stored for torrent {}, rebuilding it from release chunks",
+            torrent.id
+        );
+
+        let library = LibraryManager::new(self.database.clone(), self.cloud_storage.clone());
+        MetadataPersister::new(&library)
+            .persist_torrent_piece_map(&torrent.release_id)
+            .await
+            .map_err(SeederError::PieceMapping)?;
+
+        self.database
+            .get_torrent_piece_map(&torrent.id)
+            .await?
+            .ok_or_else(|| {
+                SeederError::PieceMapping(format!("No piece map stored for torrent {}", torrent.id))
+            })
     }
 
     /// Mark torrent as seeding or not
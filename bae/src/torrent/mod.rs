@@ -4,11 +4,13 @@ pub mod manager;
 pub mod metadata_detector;
 pub mod parser;
 pub mod piece_mapper;
+pub mod pin_manager;
 pub mod progress;
 pub mod storage;
 
 pub use manager::{start_torrent_manager, TorrentManagerHandle};
 pub use metadata_detector::detect_metadata_from_torrent_file;
 pub use parser::parse_torrent_info;
-pub use piece_mapper::TorrentPieceMapper;
+pub use piece_mapper::{PieceMap, TorrentPieceMapper};
+pub use pin_manager::PinManager;
 pub use storage::BaeStorage;
@@ -1,3 +1,5 @@
+use thiserror::Error;
+
 /// Maps torrent pieces to bae chunks
 pub struct TorrentPieceMapper {
     piece_length: usize,
@@ -67,3 +69,224 @@ impl TorrentPieceMapper {
         mappings
     }
 }
+
+#[derive(Error, Debug)]
+pub enum PieceMapError {
+    #[error("Invalid piece map header")]
+    InvalidHeader,
+    #[error("Piece map length mismatch: expected {expected} bytes, got {actual}")]
+    LengthMismatch { expected: usize, actual: usize },
+}
+
+const PIECE_MAP_MAGIC: &[u8; 4] = b"BPM1";
+const HEADER_LEN: usize = 20;
+const PIECE_RECORD_LEN: usize = 16;
+const CHUNK_REF_LEN: usize = 4;
+
+/// Binary piece-to-chunk map for a whole torrent
+///
+/// Layout, all integers little-endian u32:
+/// - header: magic `BPM1`, piece_length, chunk_size, num_pieces, num_chunk_refs
+/// - one record per piece: first_ref, ref_count, start_byte_in_first_chunk, end_byte_in_last_chunk
+/// - chunk refs: indices into the release's chunk table, sliced by the piece records
+///
+/// Lookups read fields straight out of the encoded bytes, so loading a map
+/// only validates the header and never allocates per piece.
+#[derive(Debug, Clone)]
+pub struct PieceMap {
+    bytes: Vec<u8>,
+}
+
+/// Location of one piece within the release's chunks
+#[derive(Debug, Clone, Copy)]
+pub struct PieceSpan<'a> {
+    chunk_refs: &'a [u8],
+    pub start_byte_in_first_chunk: usize,
+    pub end_byte_in_last_chunk: usize,
+}
+
+impl<'a> PieceSpan<'a> {
+    /// Indices (into the release's chunk table) of the chunks this piece spans, in order
+    pub fn chunk_indices(&self) -> impl ExactSizeIterator<Item = usize> + 'a {
+        self.chunk_refs
+            .chunks_exact(CHUNK_REF_LEN)
+            .map(|chunk_ref| read_u32(chunk_ref, 0) as usize)
+    }
+
+    /// Number of chunks this piece spans
+    pub fn num_chunks(&self) -> usize {
+        self.chunk_refs.len() / CHUNK_REF_LEN
+    }
+}
+
+impl PieceMap {
+    /// Encode the mapping of every piece described by `mapper`
+    pub fn encode(mapper: &TorrentPieceMapper) -> Self {
+        let mut records = Vec::with_capacity(mapper.total_pieces * PIECE_RECORD_LEN);
+        let mut chunk_refs = Vec::new();
+        let mut num_refs: u32 = 0;
+
+        for piece_index in 0..mapper.total_pieces {
+            let chunk_mappings = mapper.map_piece_to_chunks(piece_index);
+            let start_byte = chunk_mappings.first().map_or(0, |m| m.start_byte);
+            let end_byte = chunk_mappings.last().map_or(0, |m| m.end_byte);
+
+            records.extend_from_slice(&num_refs.to_le_bytes());
+            records.extend_from_slice(&(chunk_mappings.len() as u32).to_le_bytes());
+            records.extend_from_slice(&(start_byte as u32).to_le_bytes());
+            records.extend_from_slice(&(end_byte as u32).to_le_bytes());
+
+            for chunk_mapping in &chunk_mappings {
+                chunk_refs.extend_from_slice(&(chunk_mapping.chunk_index as u32).to_le_bytes());
+            }
+            num_refs += chunk_mappings.len() as u32;
+        }
+
+        let mut bytes = Vec::with_capacity(HEADER_LEN + records.len() + chunk_refs.len());
+        bytes.extend_from_slice(PIECE_MAP_MAGIC);
+        bytes.extend_from_slice(&(mapper.piece_length as u32).to_le_bytes());
+        bytes.extend_from_slice(&(mapper.chunk_size as u32).to_le_bytes());
+        bytes.extend_from_slice(&(mapper.total_pieces as u32).to_le_bytes());
+        bytes.extend_from_slice(&num_refs.to_le_bytes());
+        bytes.extend_from_slice(&records);
+        bytes.extend_from_slice(&chunk_refs);
+
+        PieceMap { bytes }
+    }
+
+    /// Wrap an encoded piece map, validating only its header and total length
+    pub fn from_bytes(bytes: Vec<u8>) -> Result<Self, PieceMapError> {
+        if bytes.len() < HEADER_LEN || &bytes[..4] != PIECE_MAP_MAGIC {
+            return Err(PieceMapError::InvalidHeader);
+        }
+
+        let num_pieces = read_u32(&bytes, 12) as usize;
+        let num_refs = read_u32(&bytes, 16) as usize;
+        let expected = HEADER_LEN + num_pieces * PIECE_RECORD_LEN + num_refs * CHUNK_REF_LEN;
+        if bytes.len() != expected {
+            return Err(PieceMapError::LengthMismatch {
+                expected,
+                actual: bytes.len(),
+            });
+        }
+
+        Ok(PieceMap { bytes })
+    }
+
+    /// The encoded bytes, as stored in the database
+    pub fn as_bytes(&self) -> &[u8] {
+        &self.bytes
+    }
+
+    pub fn into_bytes(self) -> Vec<u8> {
+        self.bytes
+    }
+
+    pub fn piece_length(&self) -> usize {
+        read_u32(&self.bytes, 4) as usize
+    }
+
+    pub fn chunk_size(&self) -> usize {
+        read_u32(&self.bytes, 8) as usize
+    }
+
+    pub fn num_pieces(&self) -> usize {
+        read_u32(&self.bytes, 12) as usize
+    }
+
+    /// Look up where a piece lives, or None if the index is out of range
+    pub fn piece(&self, piece_index: usize) -> Option<PieceSpan<'_>> {
+        if piece_index >= self.num_pieces() {
+            return None;
+        }
+
+        let record = HEADER_LEN + piece_index * PIECE_RECORD_LEN;
+        let first_ref = read_u32(&self.bytes, record) as usize;
+        let ref_count = read_u32(&self.bytes, record + 4) as usize;
+        let refs_start = self.refs_offset() + first_ref * CHUNK_REF_LEN;
+        let chunk_refs = self
+            .bytes
+            .get(refs_start..refs_start + ref_count * CHUNK_REF_LEN)?;
+
+        Some(PieceSpan {
+            chunk_refs,
+            start_byte_in_first_chunk: read_u32(&self.bytes, record + 8) as usize,
+            end_byte_in_last_chunk: read_u32(&self.bytes, record + 12) as usize,
+        })
+    }
+
+    /// Every chunk index referenced by any piece, ascending and without duplicates
+    pub fn referenced_chunks(&self) -> Vec<usize> {
+        // Pieces are encoded in order, so refs are non-decreasing and dedup is enough
+        let mut chunk_indices: Vec<usize> = self.bytes[self.refs_offset()..]
+            .chunks_exact(CHUNK_REF_LEN)
+            .map(|chunk_ref| read_u32(chunk_ref, 0) as usize)
+            .collect();
+        chunk_indices.dedup();
+        chunk_indices
+    }
+
+    fn refs_offset(&self) -> usize {
+        HEADER_LEN + self.num_pieces() * PIECE_RECORD_LEN
+    }
+}
+
+fn read_u32(bytes: &[u8], offset: usize) -> u32 {
+    let mut buf = [0u8; 4];
+    buf.copy_from_slice(&bytes[offset..offset + 4]);
+    u32::from_le_bytes(buf)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn test_map() -> PieceMap {
+        // 25 bytes in 3 pieces of 10 bytes, stored in 4-byte chunks
+        PieceMap::encode(&TorrentPieceMapper::new(10, 4, 3, 25))
+    }
+
+    #[test]
+    fn test_piece_map_round_trip() {
+        let map = PieceMap::from_bytes(test_map().into_bytes()).unwrap();
+
+        assert_eq!(map.piece_length(), 10);
+        assert_eq!(map.chunk_size(), 4);
+        assert_eq!(map.num_pieces(), 3);
+
+        let first = map.piece(0).unwrap();
+        assert_eq!(first.chunk_indices().collect::<Vec<_>>(), vec![0, 1, 2]);
+        assert_eq!(first.start_byte_in_first_chunk, 0);
+        assert_eq!(first.end_byte_in_last_chunk, 2);
+
+        let middle = map.piece(1).unwrap();
+        assert_eq!(middle.chunk_indices().collect::<Vec<_>>(), vec![2, 3, 4]);
+        assert_eq!(middle.start_byte_in_first_chunk, 2);
+        assert_eq!(middle.end_byte_in_last_chunk, 4);
+
+        let last = map.piece(2).unwrap();
+        assert_eq!(last.chunk_indices().collect::<Vec<_>>(), vec![5, 6]);
+        assert_eq!(last.start_byte_in_first_chunk, 0);
+        assert_eq!(last.end_byte_in_last_chunk, 1);
+
+        assert!(map.piece(3).is_none());
+        assert_eq!(map.referenced_chunks(), vec![0, 1, 2, 3, 4, 5, 6]);
+    }
+
+    #[test]
+    fn test_piece_map_rejects_corrupt_bytes() {
+        let mut bytes = test_map().into_bytes();
+        bytes.pop();
+        assert!(matches!(
+            PieceMap::from_bytes(bytes),
+            Err(PieceMapError::LengthMismatch { .. })
+        ));
+
+        let mut bytes = test_map().into_bytes();
+        bytes[0] = b'X';
+        assert!(matches!(
+            PieceMap::from_bytes(bytes),
+            Err(PieceMapError::InvalidHeader)
+        ));
+    }
+}
@@ -0,0 +1,198 @@
+//! Demand-driven pinning of seeded chunks in the seed cache.
+//!
+//! Seeding storages count the requests peers make for each piece. The pin manager
+//! periodically folds those counts into a decaying per-chunk demand score and keeps
+//! the highest scoring chunks pinned within a byte budget, so popular releases are
+//! served from local disk while the long tail is fetched from the cloud on demand.
+
+use std::collections::{HashMap, HashSet};
+
+/// Fraction of a chunk's score carried over to the next rebalance
+const SCORE_DECAY: f64 = 0.5;
+
+/// Pinned chunks rank as if their score were this much higher, so a chunk only
+/// displaces a pinned one once it's clearly hotter and pins don't churn
+const PINNED_SCORE_BONUS: f64 = 1.5;
+
+/// Scores below this are dropped rather than decayed forever
+const MIN_SCORE: f64 = 0.01;
+
+/// Requests seen for one chunk since the last rebalance
+#[derive(Debug, Clone)]
+pub struct ChunkDemand {
+    pub chunk_id: String,
+    pub size_bytes: u64,
+    pub requests: u64,
+}
+
+/// Chunks to pin and unpin after a rebalance
+#[derive(Debug, Default)]
+pub struct PinChanges {
+    pub pin: Vec<String>,
+    pub unpin: Vec<String>,
+}
+
+struct ChunkScore {
+    score: f64,
+    size_bytes: u64,
+}
+
+/// Decides which seeded chunks stay pinned, based on recent request counts
+pub struct PinManager {
+    budget_bytes: u64,
+    scores: HashMap<String, ChunkScore>,
+    pinned: HashSet<String>,
+    /// Chunks of storages libtorrent has released, which are never pinned
+    released: HashSet<String>,
+}
+
+impl PinManager {
+    pub fn new(budget_bytes: u64) -> Self {
+        PinManager {
+            budget_bytes,
+            scores: HashMap::new(),
+            pinned: HashSet::new(),
+            released: HashSet::new(),
+        }
+    }
+
+    /// Fold in the demand seen since the last call and work out which pins change
+    pub fn rebalance(&mut self, demand: Vec<ChunkDemand>) -> PinChanges {
+        for entry in self.scores.values_mut() {
+            entry.score *= SCORE_DECAY;
+        }
+        for chunk in demand {
+            let entry = self.scores.entry(chunk.chunk_id).or_insert(ChunkScore {
+                score: 0.0,
+                size_bytes: chunk.size_bytes,
+            });
+            entry.score += chunk.requests as f64;
+            entry.size_bytes = chunk.size_bytes;
+        }
+        self.scores
+            .retain(|chunk_id, entry| entry.score >= MIN_SCORE || self.pinned.contains(chunk_id));
+        self.released
+            .retain(|chunk_id| self.scores.contains_key(chunk_id));
+
+        self.apply_budget()
+    }
+
+    /// Unpin a released storage's chunks and keep them unpinned until it's restored
+    ///
+    /// Their scores are kept, so chunks that were hot are pinned again on restore.
+    pub fn release(&mut self, chunk_ids: &[String]) -> Vec<String> {
+        let mut unpin = Vec::new();
+        for chunk_id in chunk_ids {
+            if self.pinned.remove(chunk_id) {
+                unpin.push(chunk_id.clone());
+            }
+            if self.scores.contains_key(chunk_id) {
+                self.released.insert(chunk_id.clone());
+            }
+        }
+        unpin
+    }
+
+    /// Make a storage's chunks pinnable again and re-pin the ones that fit the budget
+    pub fn restore(&mut self, chunk_ids: &[String]) -> PinChanges {
+        for chunk_id in chunk_ids {
+            self.released.remove(chunk_id);
+        }
+        self.apply_budget()
+    }
+
+    /// Pin the highest ranked chunks that fit the budget and work out which pins change
+    fn apply_budget(&mut self) -> PinChanges {
+        let mut ranked: Vec<(&String, f64, u64)> = self
+            .scores
+            .iter()
+            .map(|(chunk_id, entry)| {
+                let rank = if self.pinned.contains(chunk_id) {
+                    entry.score * PINNED_SCORE_BONUS
+                } else {
+                    entry.score
+                };
+                (chunk_id, rank, entry.size_bytes)
+            })
+            .filter(|(chunk_id, rank, _)| *rank >= MIN_SCORE && !self.released.contains(*chunk_id))
+            .collect();
+        ranked.sort_by(|a, b| b.1.total_cmp(&a.1));
+
+        // Greedily fill the budget, hottest first
+        let mut wanted = HashSet::new();
+        let mut used_bytes = 0u64;
+        for (chunk_id, _, size_bytes) in ranked {
+            if used_bytes + size_bytes > self.budget_bytes {
+                continue;
+            }
+            used_bytes += size_bytes;
+            wanted.insert(chunk_id.clone());
+        }
+
+        let changes = PinChanges {
+            pin: wanted.difference(&self.pinned).cloned().collect(),
+            unpin: self.pinned.difference(&wanted).cloned().collect(),
+        };
+        for chunk_id in &changes.unpin {
+            if self
+                .scores
+                .get(chunk_id)
+                .is_some_and(|entry| entry.score < MIN_SCORE)
+            {
+                self.scores.remove(chunk_id);
+            }
+        }
+        self.pinned = wanted;
+        changes
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn demand(chunk_id: &str, requests: u64) -> ChunkDemand {
+        ChunkDemand {
+            chunk_id: chunk_id.to_string(),
+            size_bytes: 100,
+            requests,
+        }
+    }
+
+    #[test]
+    fn test_pins_follow_demand_with_hysteresis() {
+        let mut manager = PinManager::new(100);
+
+        let changes = manager.rebalance(vec![demand("a", 10), demand("b", 5)]);
+        assert_eq!(changes.pin, vec!["a".to_string()]);
+        assert!(changes.unpin.is_empty());
+
+        // "b" is now slightly hotter overall, but not enough to displace the pinned "a"
+        let changes = manager.rebalance(vec![demand("b", 4)]);
+        assert!(changes.pin.is_empty());
+        assert!(changes.unpin.is_empty());
+
+        // Once demand has clearly moved, the pin follows it
+        let changes = manager.rebalance(vec![demand("b", 40)]);
+        assert_eq!(changes.pin, vec!["b".to_string()]);
+        assert_eq!(changes.unpin, vec!["a".to_string()]);
+    }
+
+    #[test]
+    fn test_released_chunks_are_repinned_on_restore() {
+        let mut manager = PinManager::new(200);
+        manager.rebalance(vec![demand("a", 10), demand("b", 5)]);
+
+        let mut unpin = manager.release(&["a".to_string()]);
+        unpin.sort();
+        assert_eq!(unpin, vec!["a".to_string()]);
+
+        // Released chunks stay unpinned however hot they are
+        let changes = manager.rebalance(vec![demand("a", 40)]);
+        assert!(changes.pin.is_empty());
+
+        let changes = manager.restore(&["a".to_string()]);
+        assert_eq!(changes.pin, vec!["a".to_string()]);
+        assert!(changes.unpin.is_empty());
+    }
+}
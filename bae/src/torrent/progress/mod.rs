@@ -3,6 +3,8 @@ pub mod handle;
 pub use handle::TorrentProgressHandle;
 
 use crate::import::FolderMetadata;
+use std::collections::HashMap;
+use std::sync::Arc;
 
 #[derive(Debug, Clone)]
 pub enum TorrentProgress {
@@ -59,3 +61,18 @@ pub struct TrackerStatus {
     pub status: String, // "connected", "announcing", "error", etc.
     pub message: Option<String>,
 }
+
+/// Latest status of one torrent, taken from the periodic session snapshot
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct TorrentStatusSnapshot {
+    pub progress: f32, // 0.0 to 1.0
+    pub num_peers: i32,
+    pub num_seeds: i32,
+    pub download_rate: i32, // payload bytes/sec
+    pub upload_rate: i32,   // payload bytes/sec
+    pub seed_rank: i32,     // higher runs first when the session queue picks seeds
+    pub is_queued: bool,    // paused by the session queue until a slot frees up
+}
+
+/// Status snapshots of all torrents, keyed by info hash
+pub type TorrentStatusMap = Arc<HashMap<String, TorrentStatusSnapshot>>;
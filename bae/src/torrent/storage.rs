@@ -1,49 +1,174 @@
 use crate::cache::CacheManager;
-use crate::db::{Database, DbTorrentPieceMapping};
-use crate::torrent::client::{RUNTIME_HANDLE, STORAGE_INDEX_MAP, STORAGE_REGISTRY};
+use crate::cloud_storage::{CloudStorageError, CloudStorageManager};
+use crate::db::DbChunk;
+use crate::encryption::{EncryptionError, EncryptionService};
+use crate::torrent::client::{StorageCallbackContext, STORAGE_CALLBACK_CONTEXT};
 use crate::torrent::ffi::BaeStorageConstructor;
-use crate::torrent::piece_mapper::TorrentPieceMapper;
+use crate::torrent::piece_mapper::{PieceMap, PieceSpan};
+use crate::torrent::pin_manager::ChunkDemand;
 use cxx::UniquePtr;
+use std::collections::{HashMap, HashSet};
+use std::future::Future;
+use std::sync::atomic::{AtomicU32, Ordering};
+use std::sync::Arc;
 use thiserror::Error;
-use tracing::error;
+use tokio::sync::RwLock;
+use tracing::{debug, error, warn};
 
 #[derive(Error, Debug)]
 pub enum StorageError {
-    #[error("Database error: {0}")]
-    Database(#[from] sqlx::Error),
     #[error("Cache error: {0}")]
     Cache(#[from] crate::cache::CacheError),
+    #[error("Cloud storage error: {0}")]
+    CloudStorage(#[from] CloudStorageError),
+    #[error("Encryption error: {0}")]
+    Encryption(#[from] EncryptionError),
     #[error("Piece mapping error: {0}")]
     PieceMapping(String),
     #[error("Invalid piece index: {0}")]
     InvalidPieceIndex(i32),
 }
 
+/// Storage lifecycle changes reported by the storage callbacks to the torrent manager
+#[derive(Debug, Clone, Copy)]
+pub enum StorageEvent {
+    /// libtorrent stopped the torrent (removed == false) or removed it from the session
+    Released { storage_index: i32, removed: bool },
+    /// libtorrent used a stopped storage again
+    Resumed { storage_index: i32 },
+}
+
+/// Storage indices libtorrent stopped and hasn't used since
+static STOPPED_STORAGES: std::sync::Mutex<Option<HashSet<i32>>> = std::sync::Mutex::new(None);
+
 /// Storage backend for libtorrent that reads/writes directly to BAE chunks
 ///
-/// Chunks are stored unencrypted in the local cache for performance.
-/// Encryption happens when uploading to cloud storage (handled separately).
+/// Pieces are located through the torrent's binary piece map, which references
+/// chunks by their index in the release, so no database access happens per piece.
+/// Chunks live decrypted in the seed cache, a local cache with its own size budget.
+/// A chunk that isn't cached is downloaded from cloud storage and decrypted on demand,
+/// so a library can be seeded without keeping it on local disk.
 pub struct BaeStorage {
-    cache_manager: CacheManager,
-    database: Database,
-    piece_mapper: TorrentPieceMapper,
-    torrent_id: String,
+    seed_cache: CacheManager,
+    cloud_storage: CloudStorageManager,
+    encryption_service: EncryptionService,
+    piece_map: PieceMap,
+    /// Release chunks ordered by chunk index
+    chunks: Vec<DbChunk>,
+    /// Reads per piece since the pin manager last sampled them
+    piece_requests: Vec<AtomicU32>,
 }
 
 impl BaeStorage {
     /// Create a new BAE storage backend for a torrent
     pub fn new(
-        cache_manager: CacheManager,
-        database: Database,
-        piece_mapper: TorrentPieceMapper,
-        torrent_id: String,
+        seed_cache: CacheManager,
+        cloud_storage: CloudStorageManager,
+        encryption_service: EncryptionService,
+        piece_map: PieceMap,
+        chunks: Vec<DbChunk>,
     ) -> Self {
+        let piece_requests = (0..piece_map.num_pieces())
+            .map(|_| AtomicU32::new(0))
+            .collect();
         BaeStorage {
-            cache_manager,
-            database,
-            piece_mapper,
-            torrent_id,
+            seed_cache,
+            cloud_storage,
+            encryption_service,
+            piece_map,
+            chunks,
+            piece_requests,
+        }
+    }
+
+    /// IDs of the release chunks this storage serves
+    pub fn chunk_ids(&self) -> Vec<String> {
+        self.chunks.iter().map(|chunk| chunk.id.clone()).collect()
+    }
+
+    /// Take the read counts since the last call, attributed to the chunks each piece covers
+    pub fn take_chunk_demand(&self) -> Vec<ChunkDemand> {
+        let mut requests_by_chunk: HashMap<usize, u64> = HashMap::new();
+        for (piece_index, counter) in self.piece_requests.iter().enumerate() {
+            let requests = counter.swap(0, Ordering::Relaxed);
+            if requests == 0 {
+                continue;
+            }
+            if let Some(span) = self.piece_map.piece(piece_index) {
+                for chunk_index in span.chunk_indices() {
+                    *requests_by_chunk.entry(chunk_index).or_default() += requests as u64;
+                }
+            }
+        }
+
+        requests_by_chunk
+            .into_iter()
+            .filter_map(|(chunk_index, requests)| {
+                let chunk = self.chunks.get(chunk_index)?;
+                Some(ChunkDemand {
+                    chunk_id: chunk.id.clone(),
+                    size_bytes: self.piece_map.chunk_size() as u64,
+                    requests,
+                })
+            })
+            .collect()
+    }
+
+    /// Get a chunk's plaintext from the seed cache, fetching it from the cloud on a miss
+    async fn load_chunk(&self, chunk: &DbChunk) -> Result<Vec<u8>, StorageError> {
+        if let Some(data) = self.seed_cache.get_chunk(&chunk.id).await? {
+            return Ok(data);
+        }
+
+        debug!(
+            "Seed cache miss - downloading chunk from cloud: {}",
+            chunk.id
+        );
+
+        let encrypted_data = self
+            .cloud_storage
+            .download_chunk(&chunk.storage_location)
+            .await?;
+
+        // Storage callbacks block_on from libtorrent's disk threads, so decrypting
+        // inline doesn't hold up a runtime worker
+        let data = self.encryption_service.decrypt_chunk(&encrypted_data)?;
+
+        if let Err(e) = self.seed_cache.put_chunk(&chunk.id, &data).await {
+            warn!("Failed to cache seeded chunk (non-fatal): {}", e);
         }
+        Ok(data)
+    }
+
+    /// Look up a piece's span and resolve the chunks it covers
+    fn piece_chunks(
+        &self,
+        piece_index: i32,
+    ) -> Result<(PieceSpan<'_>, Vec<&DbChunk>), StorageError> {
+        let span = self
+            .piece_map
+            .piece(piece_index as usize)
+            .ok_or(StorageError::InvalidPieceIndex(piece_index))?;
+
+        if span.num_chunks() == 0 {
+            return Err(StorageError::PieceMapping(
+                "No chunks mapped to piece".to_string(),
+            ));
+        }
+
+        let chunks = span
+            .chunk_indices()
+            .map(|chunk_index| {
+                self.chunks.get(chunk_index).ok_or_else(|| {
+                    StorageError::PieceMapping(format!(
+                        "Piece {} references unknown chunk {}",
+                        piece_index, chunk_index
+                    ))
+                })
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+
+        Ok((span, chunks))
     }
 
     /// Read a piece of data by reconstructing from chunks
@@ -53,53 +178,38 @@ impl BaeStorage {
         offset: i32,
         size: i32,
     ) -> Result<Vec<u8>, StorageError> {
-        // Get piece mapping from database
-        let mapping = self
-            .database
-            .get_torrent_piece_mapping(&self.torrent_id, piece_index)
-            .await?
-            .ok_or_else(|| {
-                StorageError::PieceMapping(format!(
-                    "Piece mapping not found for piece {}",
-                    piece_index
-                ))
-            })?;
-
-        // Parse chunk IDs
-        let chunk_ids: Vec<String> = serde_json::from_str(&mapping.chunk_ids)
-            .map_err(|e| StorageError::PieceMapping(format!("Failed to parse chunk IDs: {}", e)))?;
-
-        if chunk_ids.is_empty() {
-            return Err(StorageError::PieceMapping(
-                "No chunks mapped to piece".to_string(),
-            ));
-        }
+        let (span, chunks) = self.piece_chunks(piece_index)?;
+        let last = chunks.len() - 1;
+        self.piece_requests[piece_index as usize].fetch_add(1, Ordering::Relaxed);
+
+        // Copy each chunk's slice of the piece, fetching chunks the seed cache doesn't have
+        let mut piece_data = Vec::with_capacity(self.piece_map.piece_length());
+        for (i, chunk) in chunks.iter().enumerate() {
+            let chunk_data = self.load_chunk(chunk).await?;
+
+            let start = if i == 0 {
+                span.start_byte_in_first_chunk
+            } else {
+                0
+            };
+            let end = if i == last {
+                span.end_byte_in_last_chunk
+            } else {
+                chunk_data.len()
+            };
+
+            if start > end || end > chunk_data.len() {
+                return Err(StorageError::PieceMapping(format!(
+                    "Piece data length mismatch: expected {} bytes in chunk {}, got {} bytes",
+                    end,
+                    chunk.id,
+                    chunk_data.len()
+                )));
+            }
 
-        // Read chunks from cache (stored unencrypted locally)
-        let mut chunks = Vec::new();
-        for chunk_id in &chunk_ids {
-            let cached_data = self
-                .cache_manager
-                .get_chunk(chunk_id)
-                .await?
-                .ok_or_else(|| {
-                    StorageError::Cache(crate::cache::CacheError::Io(std::io::Error::new(
-                        std::io::ErrorKind::NotFound,
-                        format!("Chunk {} not in cache", chunk_id),
-                    )))
-                })?;
-
-            // Chunks are stored unencrypted in local cache
-            chunks.push(cached_data);
+            piece_data.extend_from_slice(&chunk_data[start..end]);
         }
 
-        // Extract piece bytes from chunks
-        let piece_data = self.extract_piece_from_chunks(
-            &chunks,
-            mapping.start_byte_in_first_chunk as usize,
-            mapping.end_byte_in_last_chunk as usize,
-        )?;
-
         // Apply offset and size if specified
         let start = offset as usize;
         let end = if size > 0 {
@@ -117,337 +227,195 @@ impl BaeStorage {
         }
 
         let end = end.min(piece_data.len());
-        Ok(piece_data[start..end].to_vec())
+        piece_data.truncate(end);
+        piece_data.drain(..start);
+        Ok(piece_data)
     }
 
-    /// Write a piece of data by chunking and storing
+    /// Write a piece of data into the release chunks it maps to
+    ///
+    /// Only receives pieces that touch a file with nonzero priority, so chunks
+    /// that hold nothing but unselected files are never created.
     pub async fn write_piece(
         &self,
         piece_index: i32,
         offset: i32,
         data: &[u8],
     ) -> Result<(), StorageError> {
-        // Map piece to chunks
-        let chunk_mappings = self.piece_mapper.map_piece_to_chunks(piece_index as usize);
-
-        if chunk_mappings.is_empty() {
-            return Err(StorageError::InvalidPieceIndex(piece_index));
-        }
-
-        // Calculate which chunks this write affects
-        let piece_length = self.piece_mapper.piece_length();
-        let piece_start_byte = (piece_index as usize) * piece_length;
-        let write_start_byte = piece_start_byte + (offset as usize);
-        let write_end_byte = write_start_byte + data.len();
-
-        // Find which chunks this write spans
-        let mut chunk_ids = Vec::new();
-
-        for chunk_mapping in &chunk_mappings {
-            let chunk_start_byte = chunk_mapping.chunk_index * self.piece_mapper.piece_length();
-            let chunk_end_byte = chunk_start_byte + self.piece_mapper.piece_length();
-
-            // Check if this chunk overlaps with the write
-            if write_start_byte < chunk_end_byte && write_end_byte > chunk_start_byte {
-                // Calculate overlap
-                let overlap_start = write_start_byte.max(chunk_start_byte);
-                let overlap_end = write_end_byte.min(chunk_end_byte);
-
-                // Calculate byte range within the data slice
-                let data_start = overlap_start - write_start_byte;
-                let data_end = overlap_end - write_start_byte;
-
-                // Get or create chunk data
-                let chunk_data = if let Some(existing_mapping) = self
-                    .database
-                    .get_torrent_piece_mapping(&self.torrent_id, piece_index)
-                    .await?
-                {
-                    // Load existing chunk data
-                    let existing_chunk_ids: Vec<String> =
-                        serde_json::from_str(&existing_mapping.chunk_ids).map_err(|e| {
-                            StorageError::PieceMapping(format!(
-                                "Failed to parse existing chunk IDs: {}",
-                                e
-                            ))
-                        })?;
-
-                    if chunk_mapping.chunk_index < existing_chunk_ids.len() {
-                        // Load existing chunk (stored unencrypted in cache)
-                        let chunk_id = &existing_chunk_ids[chunk_mapping.chunk_index];
-                        self.cache_manager
-                            .get_chunk(chunk_id)
-                            .await?
-                            .ok_or_else(|| {
-                                StorageError::Cache(crate::cache::CacheError::Io(
-                                    std::io::Error::new(
-                                        std::io::ErrorKind::NotFound,
-                                        format!("Chunk {} not found", chunk_id),
-                                    ),
-                                ))
-                            })?
-                    } else {
-                        // New chunk, create empty
-                        vec![0u8; self.piece_mapper.piece_length()]
-                    }
-                } else {
-                    // No existing mapping, create new chunk
-                    vec![0u8; self.piece_mapper.piece_length()]
-                };
-
-                // Update chunk data with new piece data
-                let mut updated_chunk = chunk_data;
-                let chunk_offset = overlap_start - chunk_start_byte;
-                let chunk_end = chunk_offset + (data_end - data_start);
-                updated_chunk[chunk_offset..chunk_end].copy_from_slice(&data[data_start..data_end]);
-
-                // Store chunk unencrypted in local cache
-                let chunk_id = uuid::Uuid::new_v4().to_string();
-                self.cache_manager
-                    .put_chunk(&chunk_id, &updated_chunk)
-                    .await?;
-
-                chunk_ids.push(chunk_id);
+        let (span, chunks) = self.piece_chunks(piece_index)?;
+        let last = chunks.len() - 1;
+        let chunk_size = self.piece_map.chunk_size();
+
+        // Piece-relative byte range being written
+        let write_start = offset as usize;
+        let write_end = write_start + data.len();
+
+        // Walk the piece's chunks, tracking where each chunk's slice sits within the piece
+        let mut piece_pos = 0;
+        for (i, chunk) in chunks.iter().enumerate() {
+            let chunk_start = if i == 0 {
+                span.start_byte_in_first_chunk
+            } else {
+                0
+            };
+            let chunk_end = if i == last {
+                span.end_byte_in_last_chunk
+            } else {
+                chunk_size
+            };
+            let segment_start = piece_pos;
+            let segment_end = piece_pos + (chunk_end - chunk_start);
+            piece_pos = segment_end;
+
+            let overlap_start = write_start.max(segment_start);
+            let overlap_end = write_end.min(segment_end);
+            if overlap_start >= overlap_end {
+                continue;
             }
-        }
-
-        // Update piece mapping in database
-        let start_byte_in_first_chunk = chunk_mappings[0].start_byte as i64;
-        let end_byte_in_last_chunk = chunk_mappings.last().unwrap().end_byte as i64;
 
-        let mapping = DbTorrentPieceMapping::new(
-            &self.torrent_id,
-            piece_index,
-            chunk_ids,
-            start_byte_in_first_chunk,
-            end_byte_in_last_chunk,
-        )
-        .map_err(|e| StorageError::PieceMapping(format!("Failed to create mapping: {}", e)))?;
-
-        self.database.insert_torrent_piece_mapping(&mapping).await?;
-
-        Ok(())
-    }
-
-    /// Verify piece hash (for libtorrent hash verification)
-    pub async fn hash_piece(
-        &self,
-        piece_index: i32,
-        expected_hash: &[u8],
-    ) -> Result<bool, StorageError> {
-        // Read full piece
-        let piece_data = self.read_piece(piece_index, 0, 0).await?;
-
-        // Calculate SHA-1 hash (libtorrent uses SHA-1 for piece verification)
-        use sha2::{Digest, Sha256};
-        let mut hasher = Sha256::new();
-        hasher.update(&piece_data);
-        let calculated_hash = hasher.finalize();
-
-        // Compare hashes
-        Ok(calculated_hash.as_ref() as &[u8] == expected_hash)
-    }
-
-    /// Extract piece bytes from decrypted chunks
-    fn extract_piece_from_chunks(
-        &self,
-        chunks: &[Vec<u8>],
-        start_byte: usize,
-        end_byte: usize,
-    ) -> Result<Vec<u8>, StorageError> {
-        if chunks.is_empty() {
-            return Err(StorageError::PieceMapping("No chunks provided".to_string()));
-        }
+            // Patch the chunk in place, creating it if this is the first write to it.
+            // Only grow it as far as this write reaches: the disk interface skips pieces
+            // of unselected files, so a chunk's tail may never be written.
+            let chunk_offset = chunk_start + (overlap_start - segment_start);
+            let chunk_write_end = chunk_offset + (overlap_end - overlap_start);
+            let mut chunk_data = self
+                .seed_cache
+                .get_chunk(&chunk.id)
+                .await?
+                .unwrap_or_default();
+            if chunk_data.len() < chunk_write_end {
+                chunk_data.resize(chunk_write_end, 0);
+            }
 
-        // Concatenate all chunks
-        let mut combined_data = Vec::new();
-        for chunk_data in chunks {
-            combined_data.extend_from_slice(chunk_data);
-        }
+            chunk_data[chunk_offset..chunk_write_end]
+                .copy_from_slice(&data[overlap_start - write_start..overlap_end - write_start]);
 
-        // Extract the relevant portion
-        if end_byte > combined_data.len() {
-            return Err(StorageError::PieceMapping(format!(
-                "Piece data length mismatch: expected {} bytes, got {} bytes",
-                end_byte,
-                combined_data.len()
-            )));
+            self.seed_cache.put_chunk(&chunk.id, &chunk_data).await?;
         }
 
-        Ok(combined_data[start_byte..end_byte].to_vec())
+        Ok(())
     }
 }
 
 // FFI callbacks for libtorrent C++ integration
-// These are synchronous functions called from C++ that bridge to async BaeStorage methods
+// These are synchronous functions called from C++ that bridge to async BaeStorage methods.
+// BaeDiskInterface runs reads, writes and hashes on its own job threads, so blocking on
+// the runtime here doesn't stall the network thread while a chunk is fetched from the cloud.
 
 /// Create a storage constructor for libtorrent with BAE storage callbacks
 pub fn create_bae_storage_constructor() -> UniquePtr<BaeStorageConstructor> {
     crate::torrent::ffi::create_bae_storage_constructor(
         read_callback,
         write_callback,
-        hash_callback,
+        release_callback,
     )
 }
 
+/// Get the callback context, which is set when the BAE storage client is created
+fn callback_context() -> Option<StorageCallbackContext> {
+    let context = STORAGE_CALLBACK_CONTEXT
+        .read()
+        .unwrap_or_else(|e| e.into_inner())
+        .clone();
+    if context.is_none() {
+        error!("Storage callback context not initialized");
+    }
+    context
+}
+
+/// Run `f` with the storage registered for `storage_index`, blocking until it completes
+///
+/// Returns None if no storage is registered for the index.
+fn with_storage<T, F, Fut>(storage_index: i32, f: F) -> Option<T>
+where
+    F: FnOnce(Arc<RwLock<BaeStorage>>) -> Fut,
+    Fut: Future<Output = T>,
+{
+    let context = callback_context()?;
+
+    // The first access after a stop means the torrent was resumed
+    {
+        let mut stopped = STOPPED_STORAGES.lock().unwrap_or_else(|e| e.into_inner());
+        if stopped
+            .as_mut()
+            .is_some_and(|stopped| stopped.remove(&storage_index))
+        {
+            let _ = context.events.send(StorageEvent::Resumed { storage_index });
+        }
+    }
+
+    context.runtime.block_on(async {
+        let torrent_id = context.index_map.read().await.get(&storage_index).cloned();
+        let Some(torrent_id) = torrent_id else {
+            error!("No torrent_id mapped for storage_index: {}", storage_index);
+            return None;
+        };
+
+        let storage = context.registry.read().await.get(&torrent_id).cloned();
+        let Some(storage) = storage else {
+            error!("Storage not found for torrent_id: {}", torrent_id);
+            return None;
+        };
+
+        Some(f(storage).await)
+    })
+}
+
 /// Callback function for reading pieces from custom storage
 /// Called from C++ when libtorrent needs to read a piece
 fn read_callback(storage_index: i32, piece_index: i32, offset: i32, size: i32) -> Vec<u8> {
-    STORAGE_REGISTRY.with(|registry_tl| {
-        STORAGE_INDEX_MAP.with(|index_map_tl| {
-            RUNTIME_HANDLE.with(|runtime_tl| {
-                if let (Some(registry), Some(index_map), Some(runtime)) = (
-                    registry_tl.borrow().as_ref(),
-                    index_map_tl.borrow().as_ref(),
-                    runtime_tl.borrow().as_ref(),
-                ) {
-                    // Look up torrent_id and storage in a single async block
-                    runtime.block_on(async {
-                        // Look up torrent_id from storage_index
-                        let torrent_id = {
-                            let map_guard = index_map.read().await;
-                            map_guard.get(&storage_index).cloned()
-                        };
-
-                        if let Some(torrent_id) = torrent_id {
-                            // Look up storage and call async method
-                            let registry_guard = registry.read().await;
-                            if let Some(storage) = registry_guard.get(&torrent_id) {
-                                let storage_guard = storage.read().await;
-                                storage_guard
-                                    .read_piece(piece_index, offset, size)
-                                    .await
-                                    .unwrap_or_else(|e| {
-                                        error!("Storage read error: {}", e);
-                                        vec![]
-                                    })
-                            } else {
-                                error!("Storage not found for torrent_id: {}", torrent_id);
-                                vec![]
-                            }
-                        } else {
-                            error!("No torrent_id mapped for storage_index: {}", storage_index);
-                            vec![]
-                        }
-                    })
-                } else {
-                    error!("Thread-local storage not initialized");
-                    vec![]
-                }
+    with_storage(storage_index, |storage| async move {
+        storage
+            .read()
+            .await
+            .read_piece(piece_index, offset, size)
+            .await
+            .unwrap_or_else(|e| {
+                error!("Storage read error: {}", e);
+                vec![]
             })
-        })
     })
+    .unwrap_or_default()
 }
 
 /// Callback function for writing pieces to custom storage
 /// Called from C++ when libtorrent needs to write a piece
 fn write_callback(storage_index: i32, piece_index: i32, offset: i32, data: &[u8]) -> bool {
-    STORAGE_REGISTRY.with(|registry_tl| {
-        STORAGE_INDEX_MAP.with(|index_map_tl| {
-            RUNTIME_HANDLE.with(|runtime_tl| {
-                if let (Some(registry), Some(index_map), Some(runtime)) = (
-                    registry_tl.borrow().as_ref(),
-                    index_map_tl.borrow().as_ref(),
-                    runtime_tl.borrow().as_ref(),
-                ) {
-                    // Look up torrent_id from storage_index
-                    // Note: We can't use async here, so we use a blocking read
-                    // This is safe because we're in a sync callback context
-                    let torrent_id = {
-                        // Use tokio's Handle::block_on for the read lock
-                        // But we need to be careful - we're already in a block_on context
-                        // So we use a blocking approach: create a new runtime or use the existing one
-                        // Actually, we can't nest block_on, so we need a different approach
-                        // For now, use a blocking mutex or try_lock
-                        // TODO: Refactor to avoid nested block_on
-                        let map_guard = runtime.block_on(index_map.read());
-                        map_guard.get(&storage_index).cloned()
-                    };
-
-                    if let Some(torrent_id) = torrent_id {
-                        // Look up storage and call async method
-                        runtime.block_on(async {
-                            let registry_guard = registry.read().await;
-                            if let Some(storage) = registry_guard.get(&torrent_id) {
-                                let storage_guard = storage.read().await;
-                                storage_guard
-                                    .write_piece(piece_index, offset, data)
-                                    .await
-                                    .map(|_| true)
-                                    .unwrap_or_else(|e| {
-                                        error!("Storage write error: {}", e);
-                                        false
-                                    })
-                            } else {
-                                error!("Storage not found for torrent_id: {}", torrent_id);
-                                false
-                            }
-                        })
-                    } else {
-                        error!("No torrent_id mapped for storage_index: {}", storage_index);
-                        false
-                    }
-                } else {
-                    error!("Thread-local storage not initialized");
-                    false
-                }
+    with_storage(storage_index, |storage| async move {
+        storage
+            .read()
+            .await
+            .write_piece(piece_index, offset, data)
+            .await
+            .map(|_| true)
+            .unwrap_or_else(|e| {
+                error!("Storage write error: {}", e);
+                false
             })
-        })
     })
+    .unwrap_or(false)
 }
 
-/// Callback function for hashing pieces in custom storage
-/// Called from C++ when libtorrent needs to verify a piece hash
-fn hash_callback(storage_index: i32, piece_index: i32, hash: &[u8]) -> bool {
-    STORAGE_REGISTRY.with(|registry_tl| {
-        STORAGE_INDEX_MAP.with(|index_map_tl| {
-            RUNTIME_HANDLE.with(|runtime_tl| {
-                if let (Some(registry), Some(index_map), Some(runtime)) = (
-                    registry_tl.borrow().as_ref(),
-                    index_map_tl.borrow().as_ref(),
-                    runtime_tl.borrow().as_ref(),
-                ) {
-                    // Look up torrent_id from storage_index
-                    // Note: We can't use async here, so we use a blocking read
-                    // This is safe because we're in a sync callback context
-                    let torrent_id = {
-                        // Use tokio's Handle::block_on for the read lock
-                        // But we need to be careful - we're already in a block_on context
-                        // So we use a blocking approach: create a new runtime or use the existing one
-                        // Actually, we can't nest block_on, so we need a different approach
-                        // For now, use a blocking mutex or try_lock
-                        // TODO: Refactor to avoid nested block_on
-                        let map_guard = runtime.block_on(index_map.read());
-                        map_guard.get(&storage_index).cloned()
-                    };
-
-                    if let Some(torrent_id) = torrent_id {
-                        // Look up storage and call async method
-                        runtime.block_on(async {
-                            let registry_guard = registry.read().await;
-                            if let Some(storage) = registry_guard.get(&torrent_id) {
-                                let storage_guard = storage.read().await;
-                                storage_guard
-                                    .hash_piece(piece_index, hash)
-                                    .await
-                                    .unwrap_or_else(|e| {
-                                        error!("Storage hash error: {}", e);
-                                        false
-                                    })
-                            } else {
-                                error!("Storage not found for torrent_id: {}", torrent_id);
-                                false
-                            }
-                        })
-                    } else {
-                        error!("No torrent_id mapped for storage_index: {}", storage_index);
-                        false
-                    }
-                } else {
-                    error!("Thread-local storage not initialized");
-                    false
-                }
-            })
-        })
-    })
+/// Callback function for releasing a torrent's storage
+/// Called from C++ when libtorrent stops a torrent (removed == false) or removes it from
+/// the session (removed == true). libtorrent may call this from its network thread, so
+/// the release is handed to the torrent manager instead of waiting on the registries.
+/// A stopped storage's chunks are unpinned until libtorrent uses it again.
+fn release_callback(storage_index: i32, removed: bool) {
+    let Some(context) = callback_context() else {
+        return;
+    };
+
+    // Sent under the lock so a resume can't be queued ahead of the stop it follows
+    let mut stopped = STOPPED_STORAGES.lock().unwrap_or_else(|e| e.into_inner());
+    let stopped = stopped.get_or_insert_with(HashSet::new);
+    if removed {
+        stopped.remove(&storage_index);
+    } else {
+        stopped.insert(storage_index);
+    }
+    let _ = context.events.send(StorageEvent::Released {
+        storage_index,
+        removed,
+    });
 }
@@ -4,6 +4,7 @@ use crate::config;
 use crate::encryption;
 use crate::import;
 use crate::library::SharedLibraryManager;
+use crate::memory;
 use crate::playback;
 use crate::torrent;
 
@@ -16,5 +17,6 @@ pub struct AppContext {
     pub cache: cache::CacheManager,
     pub encryption_service: encryption::EncryptionService,
     pub cloud_storage: cloud_storage::CloudStorageManager,
+    pub memory: memory::MemoryGovernor,
     pub torrent_manager: torrent::TorrentManagerHandle,
 }
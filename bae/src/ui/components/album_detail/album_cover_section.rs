@@ -1,3 +1,4 @@
+use crate::cloud_storage::DeleteProgress;
 use crate::db::DbAlbum;
 use crate::library::use_library_manager;
 use crate::AppContext;
@@ -25,6 +26,7 @@ pub fn AlbumCoverSection(
     let mut show_dropdown = use_signal(|| false);
     let mut hover_cover = use_signal(|| false);
     let mut show_release_info_modal = use_signal(|| None::<String>);
+    let mut delete_progress = use_signal(|| None::<DeleteProgress>);
 
     rsx! {
         div {
@@ -37,6 +39,12 @@ pub fn AlbumCoverSection(
                 import_progress,
             }
 
+            if let Some(progress) = delete_progress() {
+                div { class: "absolute inset-0 bg-black/60 rounded-lg flex items-center justify-center text-white text-sm",
+                    "Deleting chunks {progress.deleted + progress.failed}/{progress.total}..."
+                }
+            }
+
             // Three dot menu button
             if hover_cover() || show_dropdown() {
                 div { class: "absolute top-2 right-2 z-10",
@@ -89,7 +97,7 @@ pub fn AlbumCoverSection(
                                             let cloud_storage = app_context.cloud_storage.clone();
                                             let cache = app_context.cache.clone();
                                             let encryption_service = app_context.encryption_service.clone();
-                                            let chunk_size_bytes = app_context.config.chunk_size_bytes;
+                                            let memory = app_context.memory.clone();
                                             move |evt| {
                                                 evt.stop_propagation();
                                                 show_dropdown.set(false);
@@ -99,6 +107,7 @@ pub fn AlbumCoverSection(
                                                     let cloud_storage = cloud_storage.clone();
                                                     let cache = cache.clone();
                                                     let encryption_service = encryption_service.clone();
+                                                    let memory = memory.clone();
                                                     spawn(async move {
                                                         is_exporting.set(true);
                                                         export_error.set(None);
@@ -116,7 +125,7 @@ pub fn AlbumCoverSection(
                                                                 &cloud_storage,
                                                                 &cache,
                                                                 &encryption_service,
-                                                                chunk_size_bytes,
+                                                                &memory,
                                                             ).await {
                                                                 Ok(_) => {
                                                                     is_exporting.set(false);
@@ -158,6 +167,7 @@ pub fn AlbumCoverSection(
                                         }
                                         let album_id = album_id.clone();
                                         let library_manager = library_manager.clone();
+                                        let cache = app_context.cache.clone();
                                         dialog.show_with_callback(
                                             "Delete Album?".to_string(),
                                             format!("Are you sure you want to delete \"{}\"? This will delete all releases, tracks, and associated data. This action cannot be undone.", album_title),
@@ -166,10 +176,13 @@ pub fn AlbumCoverSection(
                                             move || {
                                                 let album_id = album_id.clone();
                                                 let library_manager = library_manager.clone();
+                                                let cache = cache.clone();
                                                 spawn(async move {
                                                     is_deleting.set(true);
-                                                    match library_manager.get().delete_album(&album_id).await {
-                                                        Ok(_) => {
+                                                    match library_manager.get().delete_album(&album_id, &cache).await {
+                                                        Ok(job) => {
+                                                            job.follow(|progress| delete_progress.set(Some(progress))).await;
+                                                            delete_progress.set(None);
                                                             is_deleting.set(false);
                                                             on_album_deleted.call(());
                                                         }
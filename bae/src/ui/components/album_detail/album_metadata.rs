@@ -7,6 +7,7 @@ pub fn AlbumMetadata(
     artists: Vec<DbArtist>,
     track_count: usize,
     selected_release: Option<DbRelease>,
+    audio_format: Option<String>,
 ) -> Element {
     let artist_name = if artists.is_empty() {
         "Unknown Artist".to_string()
@@ -28,6 +29,9 @@ pub fn AlbumMetadata(
             if let Some(year) = album.year {
                 p { class: "text-gray-400 text-sm", "{year}" }
             }
+            if let Some(format) = audio_format {
+                p { class: "text-gray-400 text-sm", "{format} · {track_count} tracks" }
+            }
         }
     }
 }
@@ -1,4 +1,6 @@
+use crate::cloud_storage::DeleteProgress;
 use crate::library::use_library_manager;
+use crate::AppContext;
 use dioxus::prelude::*;
 use tracing::error;
 
@@ -11,6 +13,8 @@ pub fn DeleteReleaseDialog(
     on_cancel: EventHandler<()>,
 ) -> Element {
     let library_manager = use_library_manager();
+    let app_context = use_context::<AppContext>();
+    let mut delete_progress = use_signal(|| None::<DeleteProgress>);
 
     rsx! {
         div {
@@ -49,6 +53,7 @@ pub fn DeleteReleaseDialog(
                         onclick: {
                             let release_id = release_id.clone();
                             let library_manager = library_manager.clone();
+                            let cache = app_context.cache.clone();
                             move |_| {
                                 if is_deleting() {
                                     return;
@@ -56,9 +61,12 @@ pub fn DeleteReleaseDialog(
                                 is_deleting.set(true);
                                 let release_id = release_id.clone();
                                 let library_manager = library_manager.clone();
+                                let cache = cache.clone();
                                 spawn(async move {
-                                    match library_manager.get().delete_release(&release_id).await {
-                                        Ok(_) => {
+                                    match library_manager.get().delete_release(&release_id, &cache).await {
+                                        Ok(job) => {
+                                            job.follow(|progress| delete_progress.set(Some(progress))).await;
+                                            delete_progress.set(None);
                                             is_deleting.set(false);
                                             on_confirm.call(());
                                         }
@@ -70,7 +78,9 @@ pub fn DeleteReleaseDialog(
                                 });
                             }
                         },
-                        if is_deleting() {
+                        if let Some(progress) = delete_progress() {
+                            "Deleting chunks {progress.deleted + progress.failed}/{progress.total}..."
+                        } else if is_deleting() {
                             "Deleting..."
                         } else {
                             "Delete"
@@ -7,9 +7,8 @@ use dioxus::prelude::*;
 use super::back_button::BackButton;
 use super::error::AlbumDetailError;
 use super::loading::AlbumDetailLoading;
-use super::utils::{get_selected_release_id_from_params, load_album_and_releases, maybe_not_empty};
+use super::utils::{get_selected_release_id_from_params, load_album_detail, maybe_not_empty};
 use super::view::AlbumDetailView;
-use crate::db::{DbAlbum, DbArtist, DbRelease, DbTrack};
 use crate::library::LibraryError;
 
 /// Album detail page showing album info and tracklist
@@ -19,8 +18,12 @@ pub fn AlbumDetail(
     release_id: ReadSignal<String>, // May be empty string, will default to first release
 ) -> Element {
     let maybe_release_id = use_memo(move || maybe_not_empty(release_id()));
-    let data = use_album_detail_data(album_id, maybe_release_id);
-    let import_progress = use_release_progress(data.album_resource, data.selected_release_id);
+    let album_resource = use_album_detail(album_id);
+    let selected_release_id = use_memo(move || {
+        get_selected_release_id_from_params(&album_resource, maybe_release_id())
+            .and_then(|r| r.ok())
+    });
+    let import_progress = use_release_progress(album_resource, selected_release_id);
 
     let on_album_deleted = move |_| {
         // Navigate back to library after deletion
@@ -30,16 +33,16 @@ pub fn AlbumDetail(
     rsx! {
         PageContainer {
             BackButton {}
-            match data.album_resource.value().read().as_ref() {
+            match album_resource.value().read().as_ref() {
                 None => rsx! {
                     AlbumDetailLoading {}
                 },
                 Some(Err(e)) => rsx! {
                     AlbumDetailError { message: format!("Failed to load album: {e}") }
                 },
-                Some(Ok((album, releases))) => {
+                Some(Ok(detail)) => {
                     let selected_release_result = get_selected_release_id_from_params(
-                            &data.album_resource,
+                            &album_resource,
                             maybe_release_id(),
                         )
                         .expect("Resource value should be present");
@@ -49,14 +52,6 @@ pub fn AlbumDetail(
                         };
                     }
                     let selected_release_id = selected_release_result.ok().unwrap();
-                    let artists = data
-                        .artists_resource
-                        .value()
-                        .read()
-                        .as_ref()
-                        .and_then(|r| r.as_ref().ok())
-                        .cloned()
-                        .unwrap_or_default();
                     let on_release_select = move |new_release_id: String| {
                         navigator()
                             .push(Route::AlbumDetail {
@@ -64,22 +59,18 @@ pub fn AlbumDetail(
                                 release_id: new_release_id,
                             });
                     };
-                    let tracks = data
-                        .tracks_resource
-                        .value()
-                        .read()
-                        .as_ref()
-                        .and_then(|r| r.as_ref().ok())
-                        .cloned()
-                        .unwrap_or_default();
+                    let tracks = detail.tracks_for_release(&selected_release_id);
+                    let audio_format = detail.audio_format_summary(&selected_release_id);
                     rsx! {
                         AlbumDetailView {
-                            album: album.clone(),
-                            releases: releases.clone(),
-                            artists,
+                            album: detail.album.clone(),
+                            releases: detail.releases.clone(),
+                            artists: detail.artists.clone(),
                             selected_release_id,
                             on_release_select,
                             tracks,
+                            track_artists: detail.track_artists.clone(),
+                            audio_format,
                             import_progress,
                             on_album_deleted,
                         }
@@ -97,83 +88,20 @@ fn PageContainer(children: Element) -> Element {
     }
 }
 
-struct AlbumDetailData {
-    album_resource: Resource<Result<(DbAlbum, Vec<DbRelease>), LibraryError>>,
-    tracks_resource: Resource<Result<Vec<DbTrack>, LibraryError>>,
-    artists_resource: Resource<Result<Vec<DbArtist>, LibraryError>>,
-    selected_release_id: Memo<Option<String>>,
-}
-
-fn use_album_detail_data(
+/// Load the album with its releases, tracks and artists in one call
+fn use_album_detail(
     album_id: ReadSignal<String>,
-    maybe_release_id_param: Memo<Option<String>>,
-) -> AlbumDetailData {
+) -> Resource<Result<crate::library::AlbumDetail, LibraryError>> {
     let library_manager = use_library_manager();
-
-    let album_resource = {
+    use_resource(move || {
+        let album_id = album_id();
         let library_manager = library_manager.clone();
-        use_resource(move || {
-            let album_id = album_id();
-            let library_manager = library_manager.clone();
-            async move { load_album_and_releases(&library_manager, &album_id).await }
-        })
-    };
-
-    // The page params may or may not have a release ID, but there must always
-    // be some release in order for this page to be displayed (we don't expect
-    // to have albums without releases listed in the library).
-    let selected_release_id = use_memo(move || {
-        get_selected_release_id_from_params(&album_resource, maybe_release_id_param())
-            .and_then(|r| r.ok())
-    });
-
-    let tracks_resource = {
-        let library_manager = library_manager.clone();
-        use_resource(move || {
-            let release_id = selected_release_id();
-            let library_manager = library_manager.clone();
-            async move {
-                match release_id {
-                    Some(id) => library_manager.get().get_tracks(&id).await,
-                    None => Ok(Vec::new()),
-                }
-            }
-        })
-    };
-
-    let current_album_id = use_memo(move || {
-        album_resource
-            .value()
-            .read()
-            .as_ref()
-            .and_then(|result| result.as_ref().ok())
-            .map(|(album, _)| album.id.clone())
-    });
-
-    let artists_resource = {
-        let library_manager = library_manager.clone();
-        use_resource(move || {
-            let album_id = current_album_id();
-            let library_manager = library_manager.clone();
-            async move {
-                match album_id {
-                    Some(id) => library_manager.get().get_artists_for_album(&id).await,
-                    None => Ok(Vec::new()),
-                }
-            }
-        })
-    };
-
-    AlbumDetailData {
-        album_resource,
-        tracks_resource,
-        artists_resource,
-        selected_release_id,
-    }
+        async move { load_album_detail(&library_manager, &album_id).await }
+    })
 }
 
 fn use_release_progress(
-    album_resource: Resource<Result<(DbAlbum, Vec<DbRelease>), LibraryError>>,
+    album_resource: Resource<Result<crate::library::AlbumDetail, LibraryError>>,
     selected_release_id: Memo<Option<String>>,
 ) -> Signal<Option<u8>> {
     let mut progress = use_signal(|| None::<u8>);
@@ -185,7 +113,7 @@ fn use_release_progress(
             .read()
             .as_ref()
             .and_then(|r| r.as_ref().ok())
-            .map(|(_, releases)| releases.clone());
+            .map(|detail| detail.releases.clone());
 
         let Some(releases) = releases_data else {
             return;
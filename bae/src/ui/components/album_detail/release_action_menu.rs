@@ -98,7 +98,7 @@ pub fn ReleaseActionMenu(
                     let cloud_storage = app_context.cloud_storage.clone();
                     let cache = app_context.cache.clone();
                     let encryption_service = app_context.encryption_service.clone();
-                    let chunk_size_bytes = app_context.config.chunk_size_bytes;
+                    let memory = app_context.memory.clone();
                     move |evt| {
                         evt.stop_propagation();
                         if !is_deleting() && !is_exporting() {
@@ -107,6 +107,7 @@ pub fn ReleaseActionMenu(
                             let cloud_storage = cloud_storage.clone();
                             let cache = cache.clone();
                             let encryption_service = encryption_service.clone();
+                            let memory = memory.clone();
                             spawn(async move {
                                 is_exporting.set(true);
                                 export_error.set(None);
@@ -124,7 +125,7 @@ pub fn ReleaseActionMenu(
                                         &cloud_storage,
                                         &cache,
                                         &encryption_service,
-                                        chunk_size_bytes,
+                                        &memory,
                                     ).await {
                                         Ok(_) => {
                                             is_exporting.set(false);
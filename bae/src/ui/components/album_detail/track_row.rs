@@ -12,8 +12,10 @@ use super::super::{use_playback_service, use_playback_state};
 use super::utils::format_duration;
 
 /// Individual track row component
+///
+/// `artists` are the artists credited on the track (for compilations/features).
 #[component]
-pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
+pub fn TrackRow(track: DbTrack, artists: Vec<DbArtist>, release_id: String) -> Element {
     // Clone track.id once at the start to avoid borrow conflicts
     let track_id = track.id.clone();
 
@@ -21,7 +23,6 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
     let playback = use_playback_service();
     let playback_state = use_playback_state();
     let app_context = use_context::<AppContext>();
-    let mut track_artists = use_signal(Vec::<DbArtist>::new);
     let track_progress = use_track_progress(track_id.clone(), track.import_status);
     let mut show_menu = use_signal(|| false);
     let is_exporting = use_signal(|| false);
@@ -106,25 +107,6 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
         }
     });
 
-    // Load artists for this track (for compilations/features)
-    use_effect({
-        let track_id_for_artists = track_id.clone();
-        let library_manager_clone = library_manager.clone();
-        move || {
-            let library_manager = library_manager_clone.clone();
-            let track_id_for_artists = track_id_for_artists.clone();
-            spawn(async move {
-                if let Ok(artists) = library_manager
-                    .get()
-                    .get_artists_for_track(&track_id_for_artists)
-                    .await
-                {
-                    track_artists.set(artists);
-                }
-            });
-        }
-    });
-
     let progress_state = track_progress();
     let is_importing = matches!(
         progress_state,
@@ -237,12 +219,11 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
                         class: if is_failed { "text-red-300" } else if is_importing { "text-gray-500" } else if is_active { "text-blue-300" } else { "text-white group-hover:text-blue-300" },
                         "{track.title}"
                     }
-                    if !track_artists().is_empty() {
+                    if !artists.is_empty() {
                         p {
                             class: "text-sm",
                             class: if is_failed { "text-red-400" } else if is_importing { "text-gray-600" } else { "text-gray-400" },
                             {
-                                let artists = track_artists();
                                 if artists.len() == 1 {
                                     artists[0].name.clone()
                                 } else {
@@ -284,7 +265,7 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
                                         let cloud_storage_clone = app_context.cloud_storage.clone();
                                         let cache_clone = app_context.cache.clone();
                                         let encryption_service_clone = app_context.encryption_service.clone();
-                                        let chunk_size_bytes = app_context.config.chunk_size_bytes;
+                                        let memory_clone = app_context.memory.clone();
                                         let mut is_exporting_clone = is_exporting;
                                         let mut show_menu_clone = show_menu;
                                         move |_| {
@@ -295,7 +276,7 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
                                                 let cloud_storage_clone = cloud_storage_clone.clone();
                                                 let cache_clone = cache_clone.clone();
                                                 let encryption_service_clone = encryption_service_clone.clone();
-                                                let chunk_size_bytes = chunk_size_bytes;
+                                                let memory_clone = memory_clone.clone();
                                                 spawn(async move {
                                                     is_exporting_clone.set(true);
 
@@ -314,7 +295,7 @@ pub fn TrackRow(track: DbTrack, release_id: String) -> Element {
                                                             &cloud_storage_clone,
                                                             &cache_clone,
                                                             &encryption_service_clone,
-                                                            chunk_size_bytes,
+                                                            &memory_clone,
                                                         ).await {
                                                             Ok(_) => {
                                                                 is_exporting_clone.set(false);
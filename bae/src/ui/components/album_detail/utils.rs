@@ -1,5 +1,4 @@
-use crate::db::{DbAlbum, DbRelease};
-use crate::library::{LibraryError, SharedLibraryManager};
+use crate::library::{AlbumDetail, LibraryError, SharedLibraryManager};
 use dioxus::prelude::*;
 
 /// Format duration from milliseconds to MM:SS
@@ -10,23 +9,16 @@ pub fn format_duration(duration_ms: i64) -> String {
     format!("{}:{:02}", minutes, seconds)
 }
 
-/// Load album and its releases from the database
-pub async fn load_album_and_releases(
+/// Load everything the album page shows
+pub async fn load_album_detail(
     library_manager: &SharedLibraryManager,
     album_id: &str,
-) -> Result<(DbAlbum, Vec<DbRelease>), LibraryError> {
-    let albums = library_manager.get().get_albums().await?;
-    let album = albums
-        .into_iter()
-        .find(|a| a.id == album_id)
-        .ok_or_else(|| LibraryError::Import("Album not found".to_string()))?;
-
-    let releases = library_manager
+) -> Result<AlbumDetail, LibraryError> {
+    library_manager
         .get()
-        .get_releases_for_album(album_id)
-        .await?;
-
-    Ok((album, releases))
+        .get_album_detail(album_id)
+        .await?
+        .ok_or_else(|| LibraryError::Import("Album not found".to_string()))
 }
 
 /// Converts an empty string to None, otherwise wraps the string in Some
@@ -42,7 +34,7 @@ pub fn maybe_not_empty(s: String) -> Option<String> {
 /// Returns None if the resource is still loading, or an error string if the data is invalid.
 /// Falls back to the first release if no specific release ID is provided.
 pub fn get_selected_release_id_from_params(
-    album_resource: &Resource<Result<(DbAlbum, Vec<DbRelease>), LibraryError>>,
+    album_resource: &Resource<Result<AlbumDetail, LibraryError>>,
     maybe_release_id_param: Option<String>,
 ) -> Option<Result<String, String>> {
     album_resource
@@ -51,7 +43,7 @@ pub fn get_selected_release_id_from_params(
         .as_ref()
         .map(|result| match result {
             Err(e) => Err(e.to_string()),
-            Ok((_, releases)) => {
+            Ok(AlbumDetail { releases, .. }) => {
                 if releases.is_empty() {
                     return Err("Album has no releases (data integrity violation)".to_string());
                 }
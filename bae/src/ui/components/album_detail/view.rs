@@ -1,6 +1,7 @@
 use crate::db::{DbAlbum, DbArtist, DbRelease, DbTrack};
 use crate::library::use_library_manager;
 use dioxus::prelude::*;
+use std::collections::HashMap;
 
 use super::album_cover_section::AlbumCoverSection;
 use super::album_metadata::AlbumMetadata;
@@ -20,6 +21,8 @@ pub fn AlbumDetailView(
     selected_release_id: Option<String>,
     on_release_select: EventHandler<String>,
     tracks: Vec<DbTrack>,
+    track_artists: HashMap<String, Vec<DbArtist>>,
+    audio_format: Option<String>,
     import_progress: ReadSignal<Option<u8>>,
     on_album_deleted: EventHandler<()>,
 ) -> Element {
@@ -75,6 +78,7 @@ pub fn AlbumDetailView(
                         artists: artists.clone(),
                         track_count: tracks.len(),
                         selected_release: releases.iter().find(|r| Some(r.id.clone()) == selected_release_id).cloned(),
+                        audio_format,
                     }
 
                     PlayAlbumButton {
@@ -142,6 +146,7 @@ pub fn AlbumDetailView(
                                             }
                                             TrackRow {
                                                 track: track.clone(),
+                                                artists: track_artists.get(&track.id).cloned().unwrap_or_default(),
                                                 release_id: selected_release_id.clone().unwrap_or_default(),
                                             }
                                         }
@@ -154,6 +159,7 @@ pub fn AlbumDetailView(
                                         for track in &tracks {
                                             TrackRow {
                                                 track: track.clone(),
+                                                artists: track_artists.get(&track.id).cloned().unwrap_or_default(),
                                                 release_id: selected_release_id.clone().unwrap_or_default(),
                                             }
                                         }
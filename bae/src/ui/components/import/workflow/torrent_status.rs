@@ -72,9 +72,13 @@ pub fn TorrentStatus(info_hash: String, on_skip: Option<EventHandler<()>>) -> El
                             trackers,
                             ..
                         } => {
-                            state.write().num_peers = num_peers;
-                            state.write().num_seeds = num_seeds;
-                            state.write().trackers = trackers;
+                            let mut state = state.write();
+                            state.num_peers = num_peers;
+                            state.num_seeds = num_seeds;
+                            // Snapshot-driven updates carry peer counts only
+                            if !trackers.is_empty() {
+                                state.trackers = trackers;
+                            }
                         }
                         TorrentProgress::MetadataFilesDetected { files, .. } => {
                             state.write().metadata_files = files.clone();
@@ -5,7 +5,7 @@ use crate::ui::Route;
 use dioxus::prelude::*;
 
 use super::queue_sidebar::QueueSidebarState;
-use super::use_playback_service;
+use super::{use_playback_service, use_playback_state};
 
 #[component]
 fn PlaybackControlsZone(
@@ -250,182 +250,34 @@ fn PositionZone(
 pub fn NowPlayingBar() -> Element {
     let playback = use_playback_service();
     let library_manager = use_library_manager();
-    let mut state = use_signal(|| PlaybackState::Stopped);
+    let state = use_playback_state();
     let mut current_artist = use_signal(|| "Unknown Artist".to_string());
     let mut cover_art_url = use_signal(|| Option::<String>::None);
     let mut is_seeking = use_signal(|| false);
 
-    // Subscribe to playback progress updates
+    // Position comes from the shared sampled state; only listen for seek outcomes here
     use_effect({
         let playback = playback.clone();
-        let library_manager = library_manager.clone();
         move || {
             let playback = playback.clone();
-            let library_manager = library_manager.clone();
             spawn(async move {
                 let mut progress_rx = playback.subscribe_progress();
                 while let Some(progress) = progress_rx.recv().await {
                     match progress {
-                        PlaybackProgress::SeekError {
-                            requested_position: _,
-                            track_duration: _,
-                        } => {
+                        PlaybackProgress::SeekError { .. } => {
                             // Seek error - could show user notification, but for now just ignore
                             tracing::warn!("Seek failed: requested position past track end");
                         }
-                        PlaybackProgress::Seeked {
-                            position,
-                            track_id: _,
-                            was_paused,
-                        } => {
-                            // Seek completed - update position in current state
+                        PlaybackProgress::Seeked { .. }
+                        | PlaybackProgress::SeekSkipped { .. }
+                        | PlaybackProgress::StateChanged { .. } => {
+                            // Seek finished or playback moved on; resume following the position
                             if is_seeking() {
                                 is_seeking.set(false);
                             }
-
-                            // Update position in state, preserving track and duration
-                            match state() {
-                                PlaybackState::Playing {
-                                    ref track,
-                                    duration,
-                                    ..
-                                }
-                                | PlaybackState::Paused {
-                                    ref track,
-                                    duration,
-                                    ..
-                                } => {
-                                    let new_state = if was_paused {
-                                        PlaybackState::Paused {
-                                            track: track.clone(),
-                                            position,
-                                            duration,
-                                        }
-                                    } else {
-                                        PlaybackState::Playing {
-                                            track: track.clone(),
-                                            position,
-                                            duration,
-                                        }
-                                    };
-                                    state.set(new_state);
-                                }
-                                _ => {}
-                            }
-                        }
-                        PlaybackProgress::SeekSkipped {
-                            requested_position: _,
-                            current_position: _,
-                        } => {
-                            // Seek was skipped (position difference < 100ms)
-                            // Clear is_seeking flag so position updates resume
-                            if is_seeking() {
-                                is_seeking.set(false);
-                            }
-                        }
-                        PlaybackProgress::StateChanged { state: new_state } => {
-                            // Update state first
-                            state.set(new_state.clone());
-
-                            // If we were seeking, clear it now that state changed
-                            // The position in new_state should match where we seeked to
-                            if is_seeking() {
-                                is_seeking.set(false);
-                            }
-
-                            // Fetch artist for current track
-                            if let PlaybackState::Playing { ref track, .. }
-                            | PlaybackState::Paused { ref track, .. } = new_state
-                            {
-                                let release_id = track.release_id.clone();
-                                let library_manager_for_artist = library_manager.clone();
-                                spawn(async move {
-                                    match library_manager_for_artist
-                                        .get()
-                                        .get_album_id_for_release(&release_id)
-                                        .await
-                                    {
-                                        Ok(album_id) => {
-                                            match library_manager_for_artist
-                                                .get()
-                                                .get_artists_for_album(&album_id)
-                                                .await
-                                            {
-                                                Ok(artists) => {
-                                                    if !artists.is_empty() {
-                                                        let artist_names: Vec<_> = artists
-                                                            .iter()
-                                                            .map(|a| a.name.as_str())
-                                                            .collect();
-                                                        current_artist.set(artist_names.join(", "));
-                                                    } else {
-                                                        current_artist
-                                                            .set("Unknown Artist".to_string());
-                                                    }
-                                                }
-                                                Err(e) => {
-                                                    tracing::error!(
-                                                        "Failed to fetch album artists for album {}: {}",
-                                                        album_id,
-                                                        e
-                                                    );
-                                                    current_artist
-                                                        .set("Unknown Artist".to_string());
-                                                }
-                                            }
-                                        }
-                                        Err(e) => {
-                                            tracing::warn!(
-                                                "No album found for release {}: {}",
-                                                release_id,
-                                                e
-                                            );
-                                            current_artist.set("Unknown Artist".to_string());
-                                        }
-                                    }
-                                });
-                            }
-                        }
-                        PlaybackProgress::PositionUpdate { position, .. } => {
-                            // Ignore position updates while user is seeking
-                            if is_seeking() {
-                                continue;
-                            }
-
-                            // Update position in state, preserving duration
-                            if let PlaybackState::Playing {
-                                ref track,
-                                duration,
-                                ..
-                            } = state()
-                            {
-                                state.set(PlaybackState::Playing {
-                                    track: track.clone(),
-                                    position,
-                                    duration,
-                                });
-                            } else if let PlaybackState::Paused {
-                                ref track,
-                                duration,
-                                ..
-                            } = state()
-                            {
-                                state.set(PlaybackState::Paused {
-                                    track: track.clone(),
-                                    position,
-                                    duration,
-                                });
-                            }
-
-                            // After a seek completes, the first PositionUpdate will sync local_position
-                            // via the use_effect that watches position()
-                        }
-                        PlaybackProgress::TrackCompleted { .. } => {
-                            // Track finished - could auto-advance here if needed
-                        }
-                        PlaybackProgress::QueueUpdated { .. } => {
-                            // Queue updates are handled by the queue hook, ignore here
                         }
+                        PlaybackProgress::TrackCompleted { .. }
+                        | PlaybackProgress::QueueUpdated { .. } => {}
                     }
                 }
             });
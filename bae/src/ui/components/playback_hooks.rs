@@ -1,6 +1,13 @@
 use crate::playback::{PlaybackHandle, PlaybackProgress, PlaybackState};
 use crate::AppContext;
 use dioxus::prelude::*;
+use std::time::Duration;
+
+/// Minimum time between playback state samples pushed into the UI
+///
+/// Position changes continuously during playback; sampling caps re-renders at a
+/// rate that still looks smooth for a seconds-resolution display.
+const STATE_SAMPLE_INTERVAL: Duration = Duration::from_millis(100);
 
 /// Hook to access the playback service
 pub fn use_playback_service() -> PlaybackHandle {
@@ -25,7 +32,7 @@ pub fn PlaybackStateProvider(children: Element) -> Element {
 
     use_context_provider(|| shared_state.clone());
 
-    // Subscribe to playback progress to keep state updated
+    // Sample the latest playback state, waking only when it has changed
     let playback = use_playback_service();
     use_effect({
         let playback = playback.clone();
@@ -33,11 +40,11 @@ pub fn PlaybackStateProvider(children: Element) -> Element {
         move || {
             let playback = playback.clone();
             spawn(async move {
-                let mut progress_rx = playback.subscribe_progress();
-                while let Some(progress) = progress_rx.recv().await {
-                    if let PlaybackProgress::StateChanged { state: new_state } = progress {
-                        state_signal.set(new_state);
-                    }
+                let mut state_rx = playback.subscribe_state();
+                state_signal.set(state_rx.borrow_and_update().clone());
+                while state_rx.changed().await.is_ok() {
+                    state_signal.set(state_rx.borrow_and_update().clone());
+                    tokio::time::sleep(STATE_SAMPLE_INTERVAL).await;
                 }
             });
         }
@@ -31,15 +31,15 @@ pub fn TitleBar() -> Element {
         let library_manager = library_manager.clone();
         spawn(async move {
             if let Ok(album_list) = library_manager.get().get_albums().await {
-                let mut artists_map = HashMap::new();
-                for album in &album_list {
-                    if let Ok(artists) =
-                        library_manager.get().get_artists_for_album(&album.id).await
-                    {
-                        artists_map.insert(album.id.clone(), artists);
-                    }
+                let album_ids: Vec<String> =
+                    album_list.iter().map(|album| album.id.clone()).collect();
+                if let Ok(artists_map) = library_manager
+                    .get()
+                    .get_artists_for_albums(&album_ids)
+                    .await
+                {
+                    album_artists.set(artists_map);
                 }
-                album_artists.set(artists_map);
                 albums.set(album_list);
             }
         });
@@ -21,6 +21,7 @@ use bae::discogs::client::DiscogsClient;
 use bae::encryption::EncryptionService;
 use bae::import::{ImportConfig, ImportRequest, ImportService};
 use bae::library::{LibraryManager, SharedLibraryManager};
+use bae::memory::{LeaseKind, MemoryGovernor};
 use bae::playback::reassembly::reassemble_track;
 use std::path::PathBuf;
 use tokio::time::{sleep, Duration};
@@ -79,10 +80,12 @@ async fn test_cue_flac_import() {
     let runtime = tokio::runtime::Handle::current();
     let chunk_size_bytes = 1024 * 1024; // 1MB
     let import_config = ImportConfig {
-        chunk_size_bytes,
+        min_chunk_size_bytes: chunk_size_bytes,
+        max_chunk_size_bytes: chunk_size_bytes,
         max_encrypt_workers: 4,
         max_upload_workers: 4,
         max_db_write_workers: 2,
+        chunk_layout: bae::import::ChunkLayoutMode::Contiguous,
     };
     let import_handle = ImportService::start(
         import_config,
@@ -166,6 +169,7 @@ async fn test_cue_flac_import() {
 
     // Extract tracks and write FLAC files
     let output_dir = test_dir.join("extracted_tracks");
+    let memory = MemoryGovernor::new(1024 * 1024 * 1024);
     std::fs::create_dir_all(&output_dir).unwrap();
 
     for track in &tracks {
@@ -174,13 +178,14 @@ async fn test_cue_flac_import() {
         let output_path = output_dir.join(&filename);
 
         // Reassemble track using the same logic as playback
-        let audio_data = reassemble_track(
+        let (audio_data, _lease) = reassemble_track(
             &track.id,
             library_manager.get(),
             &cloud_storage,
             &cache_manager,
             &encryption_service,
-            chunk_size_bytes,
+            &memory,
+            LeaseKind::Buffer,
         )
         .await
         .unwrap_or_else(|e| panic!("Failed to reassemble track {}: {}", track_num, e));
@@ -5,8 +5,9 @@ use bae::cloud_storage::CloudStorageManager;
 use bae::db::Database;
 use bae::discogs::DiscogsRelease;
 use bae::encryption::EncryptionService;
-use bae::import::{ImportConfig, ImportRequest, ImportService};
+use bae::import::{ChunkLayoutMode, ImportConfig, ImportRequest, ImportService};
 use bae::library::LibraryManager;
+use bae::memory::{LeaseKind, MemoryGovernor};
 use bae::playback::reassemble_track;
 use std::sync::Arc;
 use tempfile::TempDir;
@@ -22,6 +23,7 @@ use bae::test_support::MockCloudStorage;
 pub async fn do_roundtrip<F, G>(
     test_name: &str,
     discogs_release: DiscogsRelease,
+    chunk_layout: ChunkLayoutMode,
     generate_files: F,
     expected_track_count: usize,
     verify_tracks: G,
@@ -89,12 +91,14 @@ pub async fn do_roundtrip<F, G>(
     let runtime_handle = tokio::runtime::Handle::current();
 
     let import_config = ImportConfig {
-        chunk_size_bytes,
+        min_chunk_size_bytes: chunk_size_bytes,
+        max_chunk_size_bytes: chunk_size_bytes,
         max_encrypt_workers: std::thread::available_parallelism()
             .map(|n| n.get() * 2)
             .unwrap_or(4),
         max_upload_workers: 20,
         max_db_write_workers: 10,
+        chunk_layout,
     };
 
     info!("Starting import service...");
@@ -186,6 +190,8 @@ pub async fn do_roundtrip<F, G>(
     // Verify reassembly (spot check up to first 3 tracks)
     info!("Verifying reassembly...");
 
+    let memory = MemoryGovernor::new(1024 * 1024 * 1024);
+
     for (i, (track, expected_data)) in tracks.iter().zip(&file_data).take(3).enumerate() {
         // Get track chunk coordinates
         let _coords = library_manager
@@ -195,13 +201,14 @@ pub async fn do_roundtrip<F, G>(
             .expect("No track chunk coords found");
 
         // Use the proper reassembly function that handles byte offsets
-        let reassembled = reassemble_track(
+        let (reassembled, _lease) = reassemble_track(
             &track.id,
             &library_manager,
             &cloud_storage,
             &cache_manager,
             &encryption_service,
-            1024 * 1024, // 1MB chunk size
+            &memory,
+            LeaseKind::Buffer,
         )
         .await
         .expect("Failed to reassemble track");
@@ -5,6 +5,7 @@ use std::sync::Arc;
 use tempfile::TempDir;
 
 use crate::support::tracing_init;
+use bae::cache::{CacheConfig, CacheManager};
 use bae::cloud_storage::CloudStorageManager;
 use bae::db::{Database, DbAlbum, DbChunk, DbRelease, DbTrack, ImportStatus};
 use bae::library::{LibraryManager, SharedLibraryManager};
@@ -18,6 +19,7 @@ async fn setup_test_environment() -> (
     Database,
     TempDir,
     Arc<MockCloudStorage>,
+    CacheManager,
 ) {
     tracing_init();
 
@@ -34,12 +36,21 @@ async fn setup_test_environment() -> (
     let library_manager = LibraryManager::new(database.clone(), cloud_storage.clone());
     let shared_library_manager = SharedLibraryManager::new(library_manager);
 
+    let cache = CacheManager::with_config(CacheConfig {
+        cache_dir: temp_dir.path().join("cache"),
+        max_size_bytes: 1024 * 1024,
+        max_chunks: 100,
+    })
+    .await
+    .expect("Failed to create cache");
+
     (
         shared_library_manager,
         cloud_storage,
         database,
         temp_dir,
         mock_storage,
+        cache,
     )
 }
 
@@ -107,7 +118,7 @@ async fn create_test_chunk(
 
 #[tokio::test]
 async fn test_delete_album_integration() {
-    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage) =
+    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage, cache) =
         setup_test_environment().await;
 
     // Create album with release, tracks, and chunks
@@ -135,7 +146,13 @@ async fn test_delete_album_integration() {
     assert!(cloud_storage.download_chunk(&location2).await.is_ok());
 
     // Delete album
-    library_manager.get().delete_album(&album.id).await.unwrap();
+    library_manager
+        .get()
+        .delete_album(&album.id, &cache)
+        .await
+        .unwrap()
+        .wait()
+        .await;
 
     // Verify album is deleted
     let album_result = library_manager
@@ -164,7 +181,7 @@ async fn test_delete_album_integration() {
 
 #[tokio::test]
 async fn test_delete_release_integration() {
-    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage) =
+    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage, cache) =
         setup_test_environment().await;
 
     // Create album with two releases
@@ -192,9 +209,11 @@ async fn test_delete_release_integration() {
     // Delete first release
     library_manager
         .get()
-        .delete_release(&release1.id)
+        .delete_release(&release1.id, &cache)
         .await
-        .unwrap();
+        .unwrap()
+        .wait()
+        .await;
 
     // Verify album still exists
     let album_result = library_manager
@@ -234,7 +253,7 @@ async fn test_delete_release_integration() {
 
 #[tokio::test]
 async fn test_delete_last_release_deletes_album() {
-    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage) =
+    let (library_manager, cloud_storage, database, _temp_dir, _mock_storage, cache) =
         setup_test_environment().await;
 
     // Create album with single release
@@ -250,9 +269,11 @@ async fn test_delete_last_release_deletes_album() {
     // Delete release (should also delete album)
     library_manager
         .get()
-        .delete_release(&release.id)
+        .delete_release(&release.id, &cache)
         .await
-        .unwrap();
+        .unwrap()
+        .wait()
+        .await;
 
     // Verify album is deleted
     let album_result = library_manager
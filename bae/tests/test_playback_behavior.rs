@@ -22,6 +22,7 @@ use bae::test_support::MockCloudStorage;
 struct PlaybackTestFixture {
     playback_handle: bae::playback::PlaybackHandle,
     progress_rx: tokio::sync::mpsc::UnboundedReceiver<PlaybackProgress>,
+    state_rx: tokio::sync::watch::Receiver<PlaybackState>,
     track_ids: Vec<String>,
     _temp_dir: TempDir,
 }
@@ -64,12 +65,14 @@ impl PlaybackTestFixture {
         let _track_data = generate_test_flac_files(&album_dir);
 
         let import_config = bae::import::ImportConfig {
-            chunk_size_bytes,
+            min_chunk_size_bytes: chunk_size_bytes,
+            max_chunk_size_bytes: chunk_size_bytes,
             max_encrypt_workers: std::thread::available_parallelism()
                 .map(|n| n.get() * 2)
                 .unwrap_or(4),
             max_upload_workers: 20,
             max_db_write_workers: 10,
+            chunk_layout: bae::import::ChunkLayoutMode::Contiguous,
         };
 
         let import_handle = bae::import::ImportService::start(
@@ -121,7 +124,7 @@ impl PlaybackTestFixture {
             cloud_storage,
             cache_manager,
             encryption_service,
-            chunk_size_bytes,
+            bae::memory::MemoryGovernor::new(1024 * 1024 * 1024),
             runtime_handle,
         );
 
@@ -129,10 +132,12 @@ impl PlaybackTestFixture {
         playback_handle.set_volume(0.0);
 
         let progress_rx = playback_handle.subscribe_progress();
+        let state_rx = playback_handle.subscribe_state();
 
         Ok(Self {
             playback_handle,
             progress_rx,
+            state_rx,
             track_ids,
             _temp_dir: temp_dir,
         })
@@ -165,22 +170,21 @@ impl PlaybackTestFixture {
         None
     }
 
-    /// Wait for a position update with timeout
+    /// Wait for the shared playback state to change and return its position, with timeout
     async fn wait_for_position_update(&mut self, timeout_duration: Duration) -> Option<Duration> {
-        let deadline = Instant::now() + timeout_duration;
-
-        while Instant::now() < deadline {
-            match timeout(Duration::from_millis(100), self.progress_rx.recv()).await {
-                Ok(Some(PlaybackProgress::PositionUpdate { position, .. })) => {
+        let state_rx = &mut self.state_rx;
+        let wait = async {
+            loop {
+                state_rx.changed().await.ok()?;
+                if let PlaybackState::Playing { position, .. }
+                | PlaybackState::Paused { position, .. } = *state_rx.borrow_and_update()
+                {
                     return Some(position);
                 }
-                Ok(Some(_)) => continue,
-                Ok(None) => break,
-                Err(_) => continue,
             }
-        }
+        };
 
-        None
+        timeout(timeout_duration, wait).await.ok().flatten()
     }
 
     /// Wait for a Seeked event with timeout
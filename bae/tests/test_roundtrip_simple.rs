@@ -4,6 +4,7 @@ mod support;
 use std::{fs, path::PathBuf};
 
 use bae::discogs::models::{DiscogsRelease, DiscogsTrack};
+use bae::import::ChunkLayoutMode;
 use tracing::info;
 
 use crate::support::{do_roundtrip::do_roundtrip, tracing_init};
@@ -15,6 +16,7 @@ async fn test_roundtrip_simple() {
     do_roundtrip(
         "Simple 3-Track Album Test",
         create_test_discogs_album(),
+        ChunkLayoutMode::Contiguous,
         generate_simple_test_files,
         3,
         |tracks| {
@@ -28,6 +30,21 @@ async fn test_roundtrip_simple() {
     .await;
 }
 
+#[tokio::test]
+async fn test_roundtrip_simple_track_aligned() {
+    tracing_init();
+
+    do_roundtrip(
+        "Simple 3-Track Album Test (track-aligned chunks)",
+        create_test_discogs_album(),
+        ChunkLayoutMode::TrackAligned,
+        generate_simple_test_files,
+        3,
+        |_| {},
+    )
+    .await;
+}
+
 /// Create mock Discogs metadata for testing
 fn create_test_discogs_album() -> DiscogsRelease {
     DiscogsRelease {
@@ -4,6 +4,7 @@ mod support;
 use std::fs;
 
 use bae::discogs::models::DiscogsRelease;
+use bae::import::ChunkLayoutMode;
 use support::{do_roundtrip::do_roundtrip, tracing_init};
 use tracing::{error, info};
 
@@ -14,6 +15,7 @@ async fn test_roundtrip_vinyl() {
     do_roundtrip(
         "Vinyl Album with Side Notation (A1-A7, B1-B9)",
         load_vinyl_album_fixture(),
+        ChunkLayoutMode::Contiguous,
         generate_vinyl_album_files,
         2,
         |tracks| {